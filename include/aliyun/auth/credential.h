@@ -22,6 +22,7 @@
 
 #include <ctime>
 #include <string>
+#include <utility>
 
 #include "aliyun/utils/date.h"
 
@@ -38,15 +39,15 @@ class Credential {
     refreshDate_ = Date::currentUtcDate();
   }
 
-  Credential(string keyId, string secret) {
-    accessKeyId_ = keyId;
-    accessSecret_ = secret;
+  Credential(string keyId, string secret)
+      : accessKeyId_(std::move(keyId)),
+        accessSecret_(std::move(secret)) {
     refreshDate_ = Date::currentUtcDate();
   }
 
-  Credential(string keyId, string secret, int expiredHours) {
-    accessKeyId_ = keyId;
-    accessSecret_ = secret;
+  Credential(string keyId, string secret, int expiredHours)
+      : accessKeyId_(std::move(keyId)),
+        accessSecret_(std::move(secret)) {
     refreshDate_ = Date::currentUtcDate();
 
     setExpiredDate(expiredHours);
@@ -68,7 +69,7 @@ class Credential {
   }
 
   void setAccessKeyId(string accessKeyId) {
-    this->accessKeyId_ = accessKeyId;
+    this->accessKeyId_ = std::move(accessKeyId);
   }
 
   const string& getAccessSecret() const {
@@ -76,7 +77,7 @@ class Credential {
   }
 
   void setAccessSecret(string accessSecret) {
-    this->accessSecret_ = accessSecret;
+    this->accessSecret_ = std::move(accessSecret);
   }
 
   const Date& getRefreshDate() const {
@@ -92,7 +93,7 @@ class Credential {
   }
 
   void setSecurityToken(string securityToken) {
-    this->securityToken_ = securityToken;
+    this->securityToken_ = std::move(securityToken);
   }
 
   const Date& getExpiredDate() const {
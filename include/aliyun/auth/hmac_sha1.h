@@ -20,6 +20,9 @@
 #ifndef ALIYUN_AUTH_HMAC_SHA1_H_
 #define ALIYUN_AUTH_HMAC_SHA1_H_
 
+#include <apr_sha1.h>
+#include <stddef.h>
+
 #include <string>
 
 #include "aliyun/auth/isigner.h"
@@ -35,7 +38,8 @@ class HmacSha1 : public ISigner {
  public:
   static const int DIGEST_LENTH = 20;  // 160/8
 
-  std::string signString(std::string source, std::string accessSecret)
+  std::string signString(const std::string& source,
+                         const std::string& accessSecret)
                              throw(aliyun::Exception);
 
   std::string getSignerName();
@@ -47,9 +51,23 @@ class HmacSha1 : public ISigner {
                         int message_len);
 
   static HmacSha1 * getInstance();
+};
+
+// HMAC-SHA1 with the keyed inner and outer states computed once, for
+// signing many messages with one secret. copyable and thread-safe.
+class HmacSha1Key {
+ public:
+  explicit HmacSha1Key(const std::string& key = "");
+
+  void sign(const char* message, size_t size,
+            unsigned char hmac[HmacSha1::DIGEST_LENTH]) const;
+
+  // base64 of the digest, as HmacSha1::signString().
+  std::string signString(const std::string& message) const;
 
  private:
-  static HmacSha1* sInstance_;
+  apr_sha1_ctx_t inner_;  // after the ipad block
+  apr_sha1_ctx_t outer_;  // after the opad block
 };
 
 }  // namespace auth
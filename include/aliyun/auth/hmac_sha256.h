@@ -20,6 +20,7 @@
 #ifndef ALIYUN_AUTH_HMAC_SHA256_H_
 #define ALIYUN_AUTH_HMAC_SHA256_H_
 
+#include <mutex>
 #include <string>
 
 #include "aliyun/auth/isigner.h"
@@ -43,7 +44,8 @@ class HmacSha256 : public ISigner {
 
   std::string getSignerVersion();
 
-  std::string signString(std::string source, std::string accessSecret)
+  std::string signString(const std::string& source,
+                         const std::string& accessSecret)
       throw(aliyun::Exception);
 
   void HMAC_SHA256(unsigned char hmac[32], const unsigned char *key,
@@ -52,10 +54,9 @@ class HmacSha256 : public ISigner {
   static HmacSha256 * getInstance();
 
  private:
-  static HmacSha256* sInstance_;
-
   apr_pool_t* pool_;
-  apr_crypto_hash_t* hash_;
+  apr_crypto_hash_t* hash_;  // shared by all calls, guarded by mutex_
+  std::mutex mutex_;
 };
 
 }  // namespace auth
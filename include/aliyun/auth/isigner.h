@@ -36,7 +36,8 @@ class ISigner {
 
   virtual std::string getSignerVersion() = 0;
 
-  virtual std::string signString(std::string source, std::string accessSecret)
+  virtual std::string signString(const std::string& source,
+                                 const std::string& accessSecret)
                                      throw(aliyun::Exception) = 0;
 };
 
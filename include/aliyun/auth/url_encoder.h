@@ -20,12 +20,14 @@
 #ifndef ALIYUN_AUTH_URL_ENCODER_H_
 #define ALIYUN_AUTH_URL_ENCODER_H_
 
-#include <curl/curl.h>
+#include <stddef.h>
 #include <string>
 
 namespace aliyun {
 namespace auth {
 
+// percent-encoding as curl_easy_escape: ALPHA / DIGIT / "-" / "." / "_" /
+// "~" are kept, other bytes become %XX. stateless and thread-safe.
 class UrlEncoder {
  public:
   typedef std::string string;
@@ -34,39 +36,40 @@ class UrlEncoder {
 
   ~UrlEncoder();
 
-  string encodeString(string input);
+  string encodeString(const string& input);
 
   static UrlEncoder * getInstance();
 
   // static(class) usage
-  static string encode(string in) {
-    return getInstance()->encodeString(in);
+  static string encode(const string& in) {
+    string out;
+    appendEncoded(in.data(), in.size(), &out);
+    return out;
   }
 
-  static string percentEncode(string in) {
-    string basis = encode(in);
-    replace(&basis, "+", "%20");
-    replace(&basis, "*", "%2A");
-    replace(&basis, "%7E", "~");  // swap it ?
-    return basis;
-  }
+  // appends the encoding of `data` to `out`, grown once.
+  static void appendEncoded(const char* data, size_t size, string* out);
 
- private:
-  static void replace(string* operand, const string& source,
-                      const string& target) {
-    string::size_type pos = operand->find(source);
-    if (pos != string::npos) {
-      operand->replace(pos, source.length(), target);
-    }
+  static void appendEncoded(const string& in, string* out) {
+    appendEncoded(in.data(), in.size(), out);
   }
 
-  void updateUri(char* uri);
+  // length of encode(in), counted without encoding.
+  static size_t encodedLength(const char* data, size_t size);
 
- private:
-  CURL* curl_;
-  char* uri_;
+  static size_t encodedLength(const string& in) {
+    return encodedLength(in.data(), in.size());
+  }
 
-  static UrlEncoder * sInstance_;
+  // RFC 3986 encoding used by signatures, space as %20, "*" as %2A and "~"
+  // kept. encode() gives the same already.
+  static string percentEncode(const string& in) {
+    return encode(in);
+  }
+
+  static void appendPercentEncoded(const string& in, string* out) {
+    appendEncoded(in.data(), in.size(), out);
+  }
 };
 
 }  // namespace auth
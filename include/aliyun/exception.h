@@ -28,13 +28,14 @@
 
 #include <exception>
 #include <string>
+#include <utility>
 
 namespace aliyun {
 
 class Exception : public std::exception {
  public:
   explicit Exception(std::string what)
-      : what_(what) {
+      : what_(std::move(what)) {
     fillStackTrace();
   }
 
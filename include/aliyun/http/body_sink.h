@@ -0,0 +1,47 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_HTTP_BODY_SINK_H_
+#define ALIYUN_HTTP_BODY_SINK_H_
+
+#include <stddef.h>
+
+namespace aliyun {
+namespace http {
+
+// takes the response body piece by piece as it is received, in place of
+// HttpResponse::content(). pieces are decompressed already.
+class BodySink {
+ public:
+  virtual ~BodySink() {}
+
+  // a response starts, again after redirects and 100 Continue.
+  virtual void onBegin() {}
+
+  // throw to abort the transfer, the exception is rethrown to the caller.
+  virtual void onData(const char* data, size_t size) = 0;
+
+  // the body is complete.
+  virtual void onEnd() {}
+};
+
+}  // namespace http
+}  // namespace aliyun
+
+#endif  // ALIYUN_HTTP_BODY_SINK_H_
@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_HTTP_CURL_HANDLE_POOL_H_
+#define ALIYUN_HTTP_CURL_HANDLE_POOL_H_
+
+#include <curl/curl.h>
+#include <stddef.h>
+
+#include <mutex>
+#include <vector>
+
+namespace aliyun {
+namespace http {
+
+// thread-safe pool of reusable curl easy handles.
+//
+// an easy handle keeps its connection cache (and TLS session cache) alive
+// across curl_easy_reset, so handing the same handle to subsequent requests
+// lets them reuse established keep-alive connections instead of paying a
+// fresh TCP/TLS handshake each time.
+//
+// the pool caches at most `maxIdleHandles` idle handles. it does not bound
+// handles in use: acquire() never blocks or fails for lack of handles,
+// and handles released beyond the cache size (after bursts) are cleaned up.
+// the pool must outlive every handle acquired from it.
+class CurlHandlePool {
+ public:
+  static const size_t DEFAULT_MAX_IDLE_HANDLES = 16;
+
+  explicit CurlHandlePool(size_t maxIdleHandles = DEFAULT_MAX_IDLE_HANDLES);
+
+  ~CurlHandlePool();
+
+  // take an idle handle, or create a new one if none cached.
+  CURL* acquire();
+
+  // reset and give back a handle taken by acquire().
+  void release(CURL* curl);
+
+  // change the idle cache size, extra idle handles are cleaned up immediately.
+  void setMaxIdleHandles(size_t maxIdleHandles);
+
+  size_t getMaxIdleHandles() const;
+
+  size_t getIdleHandles() const;
+
+ private:
+  // noncopyable.
+  CurlHandlePool& operator=(const CurlHandlePool& rhs);
+  CurlHandlePool(const CurlHandlePool& rhs);
+
+  mutable std::mutex mutex_;
+  std::vector<CURL*> idle_;
+  size_t maxIdleHandles_;
+};
+
+}  // namespace http
+}  // namespace aliyun
+
+#endif  // ALIYUN_HTTP_CURL_HANDLE_POOL_H_
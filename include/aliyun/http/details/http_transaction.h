@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_HTTP_DETAILS_HTTP_TRANSACTION_H_
+#define ALIYUN_HTTP_DETAILS_HTTP_TRANSACTION_H_
+
+// NOTE: internal header, shared by blocking and asynchronous transfers.
+//       DO NOT USE FLOW CLASSES DIRECTLY!
+
+#include <curl/curl.h>
+#include <stddef.h>
+
+#include <exception>
+#include <string>
+
+namespace aliyun {
+namespace utils {
+class GzipInflater;
+}  // namespace utils
+}  // namespace aliyun
+
+namespace aliyun {
+namespace http {
+
+class BodySink;
+class HttpRequest;
+class HttpResponse;
+
+// state of one HTTP exchange on a curl easy handle.
+struct HttpTransaction {
+  CURL* curl_;
+  const HttpRequest* request_;
+  HttpResponse* response_;
+  size_t bodySends_;
+  size_t bodyReceives_;
+  utils::GzipInflater* inflater_;  // set if response body is compressed
+  std::string error_;  // why body callbacks aborted the transfer
+  std::string* body_;  // buffer of the request or the response content
+  size_t contentLength_;  // of the current response, 0 if unknown
+  BodySink* sink_;  // of the request, takes the body if set
+  std::string inflated_;  // decompressed piece for sink_
+  std::exception_ptr sinkError_;  // thrown by sink_, rethrown by fail()
+
+  enum {
+    INIT,
+    HEADER,
+    BODY_IN,
+    BODY_OUT,
+    ABORT,
+    DONE,
+  } state_;
+
+  HttpTransaction(CURL* curl, const HttpRequest* req, HttpResponse* resp);
+
+  ~HttpTransaction();
+
+  // install body/header callbacks and common options on the prepared handle.
+  void setup();
+
+  // collect response status and parse headers after transfer done.
+  void finish();
+
+  // throw exception for failed transfer.
+  void fail(CURLcode rc);
+
+ private:
+  // noncopyable.
+  HttpTransaction& operator=(const HttpTransaction& rhs);
+  HttpTransaction(const HttpTransaction& rhs);
+};
+
+}  // namespace http
+}  // namespace aliyun
+
+#endif  // ALIYUN_HTTP_DETAILS_HTTP_TRANSACTION_H_
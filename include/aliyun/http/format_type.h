@@ -48,7 +48,7 @@ class FormatType {
 
   static std::string mapFormatToAccept(FormatType format);
 
-  static FormatType mapAcceptToFormat(std::string accept);
+  static FormatType mapAcceptToFormat(const std::string& accept);
 
  private:
   Value value_;
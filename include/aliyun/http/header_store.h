@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_HTTP_HEADER_STORE_H_
+#define ALIYUN_HTTP_HEADER_STORE_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "aliyun/utils/string_piece.h"
+
+namespace aliyun {
+namespace http {
+
+// response headers, names compared case-insensitively.
+//
+// names and values are kept in one buffer and looked up by a hash of the
+// lowercased name, clear() keeps all capacity so a reused store does not
+// allocate. a header added again replaces the earlier value. the headers
+// used by the transfer itself have slots of their own.
+class HeaderStore {
+ public:
+  typedef utils::StringPiece StringPiece;
+
+  enum HotHeader {
+    CONTENT_TYPE,
+    CONTENT_LENGTH,
+    CONTENT_ENCODING,
+    CONNECTION,
+    OTHER_HEADER  // not hot, also the number of hot headers
+  };
+
+  HeaderStore();
+
+  void clear();
+
+  // returns the hot slot of `name`, or OTHER_HEADER.
+  HotHeader add(const StringPiece& name, const StringPiece& value);
+
+  bool has(const StringPiece& name) const {
+    return find(name) >= 0;
+  }
+
+  // empty if not found.
+  StringPiece get(const StringPiece& name) const;
+
+  StringPiece get(HotHeader header) const {
+    int index = hot_[header];
+    return index < 0 ? StringPiece() : getValue(index);
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  // name as received.
+  StringPiece getName(size_t i) const {
+    const Entry& entry = entries_[i];
+    return StringPiece(buffer_.data() + entry.name, entry.nameSize);
+  }
+
+  StringPiece getValue(size_t i) const {
+    const Entry& entry = entries_[i];
+    return StringPiece(buffer_.data() + entry.value, entry.valueSize);
+  }
+
+  static bool equalsIgnoreCase(const StringPiece& lhs, const StringPiece& rhs);
+
+ private:
+  // offsets into buffer_, pieces would not survive growing or copying it.
+  struct Entry {
+    size_t name;
+    size_t nameSize;
+    size_t value;
+    size_t valueSize;
+    size_t hash;
+  };
+
+  static size_t hash(const StringPiece& name);
+
+  int find(const StringPiece& name) const;
+
+  // index of the bucket holding `name` or of the empty one it would take.
+  size_t probe(const StringPiece& name, size_t hash) const;
+
+  void rehash(size_t buckets);
+
+  std::string buffer_;
+  std::vector<Entry> entries_;
+  std::vector<int> buckets_;  // entry index or -1, size is a power of 2
+  int hot_[OTHER_HEADER];
+};
+
+}  // namespace http
+}  // namespace aliyun
+
+#endif  // ALIYUN_HTTP_HEADER_STORE_H_
@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_HTTP_HTTP_MULTI_ENGINE_H_
+#define ALIYUN_HTTP_HTTP_MULTI_ENGINE_H_
+
+#include <curl/curl.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "aliyun/http/http_request.h"
+#include "aliyun/http/http_response.h"
+
+namespace aliyun {
+namespace http {
+
+class CurlHandlePool;
+
+// asynchronous request engine.
+//
+// all submitted requests are driven by one curl_multi event loop running on
+// a background thread, so any number of requests can be in flight at once
+// without a thread per request. easy handles are borrowed from `pool` (if
+// given), and connections are reused the same way as blocking requests.
+//
+// completion callbacks are invoked on the event loop thread, they should be
+// short and must not block on other requests of the same engine.
+class HttpMultiEngine {
+ public:
+  // exactly one of `response` and `error` is meaningful:
+  //   on success, error is null and response holds the result;
+  //   on failure, error holds the exception (CurlException mostly).
+  typedef std::function<void(HttpResponse& response,  // NOLINT
+                             std::exception_ptr error)> Callback;
+
+  explicit HttpMultiEngine(CurlHandlePool* pool = NULL);
+
+  // wait event loop exits, pending requests complete with exception.
+  ~HttpMultiEngine();
+
+  // send request asynchronously, callback invoked when done.
+  void submit(const HttpRequest& request, Callback callback);
+
+  // send request asynchronously, get result from the future.
+  std::future<HttpResponse> submit(const HttpRequest& request);
+
+  // number of requests submitted but not completed yet.
+  size_t getPendingCount() const;
+
+ private:
+  struct Transfer;
+
+  void run();
+
+  void wakeup();
+
+  void complete(Transfer* transfer, CURLcode rc);
+
+  void abort(Transfer* transfer, const char* reason);
+
+  // noncopyable.
+  HttpMultiEngine& operator=(const HttpMultiEngine& rhs);
+  HttpMultiEngine(const HttpMultiEngine& rhs);
+
+  CurlHandlePool* pool_;
+  CURLM* multi_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Transfer*> queue_;  // submitted, not added to multi_ yet
+  size_t pending_;
+  bool stopping_;
+
+  std::thread loop_;  // last, started after all above initialized
+};
+
+}  // namespace http
+}  // namespace aliyun
+
+#endif  // ALIYUN_HTTP_HTTP_MULTI_ENGINE_H_
@@ -21,8 +21,11 @@
 #define ALIYUN_HTTP_HTTP_REQUEST_H_
 
 #include <curl/curl.h>
+
+#include <atomic>
 #include <map>
 #include <string>
+#include <utility>
 
 #include "aliyun/exception.h"
 #include "aliyun/http/format_type.h"
@@ -31,6 +34,9 @@
 namespace aliyun {
 namespace http {
 
+class BodySink;
+class CurlHandlePool;
+
 class CurlException : public Exception {
  public:
   explicit CurlException(CURLcode rc);
@@ -43,6 +49,10 @@ class CurlHandle {
  public:
   CurlHandle();
 
+  // borrow handle from pool, and give it back when destruct.
+  // create a standalone handle if pool is NULL.
+  explicit CurlHandle(CurlHandlePool* pool);
+
   ~CurlHandle();
 
   // convert to CURL*
@@ -51,7 +61,6 @@ class CurlHandle {
   }
 
   curl_slist* head_;
-  char* post_;
 
  private:
   // noncopyable.
@@ -59,6 +68,7 @@ class CurlHandle {
   CurlHandle(const CurlHandle& rhs);
 
   CURL* curl_;
+  CurlHandlePool* pool_;
 };
 
 class HttpRequest {
@@ -71,20 +81,21 @@ class HttpRequest {
               const std::map<std::string, std::string>& headers);
 
   // getters and setters
-  std::string getUrl() const {
+  const std::string& getUrl() const {
     return url_;
   }
 
+  // takes over `url`, pass an rvalue to set it without a copy.
   void setUrl(std::string url) {
-    url_ = url;
+    url_ = std::move(url);
   }
 
   const std::string& getEncoding() const {
     return encoding_;
   }
 
-  void setEncoding(const std::string encoding) {
-    encoding_ = encoding;
+  void setEncoding(std::string encoding) {
+    encoding_ = std::move(encoding);
   }
 
   FormatType getContentType() const {
@@ -101,11 +112,11 @@ class HttpRequest {
     method_ = method;
   }
 
-  void setMethod(std::string method) {
+  void setMethod(const std::string& method) {
     method_ = MethodType(method);
   }
 
-  std::string getContent() const {
+  const std::string& getContent() const {
     return content_;
   }
 
@@ -114,21 +125,64 @@ class HttpRequest {
     return content_;
   }
 
-  std::string getHeaderValue(std::string name) const;
+  std::string getHeaderValue(const std::string& name) const;
 
   void putHeaderParameter(std::string name, std::string value);
 
-  void removeHeaderParameter(std::string name);
+  void removeHeaderParameter(const std::string& name);
 
-  void setContent(std::string content, std::string encoding, FormatType format);
+  // takes over `content`, pass an rvalue to set it without a copy.
+  void setContent(std::string content, const std::string& encoding,
+                  FormatType format);
 
   const std::map<std::string, std::string>& getHeaders() const {
     return headers_;
   }
 
-  void prepareCurlHandle(CurlHandle* curl);
+  // whole request timeout in milliseconds, 0 means never time out.
+  long getTimeout() const {  // long: follow libcurl
+    return timeout_;
+  }
+
+  void setTimeout(long timeout) {
+    timeout_ = timeout;
+  }
+
+  // connection phase timeout in milliseconds, 0 means libcurl default.
+  long getConnectTimeout() const {  // long: follow libcurl
+    return connectTimeout_;
+  }
+
+  void setConnectTimeout(long connectTimeout) {
+    connectTimeout_ = connectTimeout;
+  }
+
+  // body of the response is passed to `sink` while received and not kept
+  // in the response content. NULL by default, not owned.
+  BodySink* getBodySink() const {
+    return bodySink_;
+  }
+
+  void setBodySink(BodySink* sink) {
+    bodySink_ = sink;
+  }
 
-  std::string getContentTypeValue(FormatType contentType, std::string encoding);
+  // body of the response is written to `buffer` instead of the response
+  // content. the buffer is cleared first but keeps its capacity, so reusing
+  // one buffer saves the body allocation. NULL by default, not owned.
+  std::string* getBodyBuffer() const {
+    return bodyBuffer_;
+  }
+
+  void setBodyBuffer(std::string* buffer) {
+    bodyBuffer_ = buffer;
+  }
+
+  // set the request on the handle, the request itself is not changed.
+  void prepareCurlHandle(CurlHandle* curl) const;
+
+  std::string getContentTypeValue(FormatType contentType,
+                                  const std::string& encoding) const;
 
   static void setSSLVerifyHost(int option) {
     sSSLVerifyHost = option;
@@ -146,8 +200,16 @@ class HttpRequest {
     return sSSLVerifyPeer;
   }
 
+  // negotiate gzip/deflate response, decompressed while receiving.
+  // process-wide default for requests without an Accept-Encoding header,
+  // CloudsearchClient sets that header per request from its own option.
+  // no effect if built without zlib.
   static void enableGzip(bool enable);
 
+  static bool isGzipEnabled() {
+    return sGzipEnabled.load();
+  }
+
  protected:
   std::string url_;
   MethodType method_;
@@ -155,6 +217,10 @@ class HttpRequest {
   std::string content_;
   std::string encoding_;
   std::map<std::string, std::string> headers_;
+  long timeout_;  // long: follow libcurl
+  long connectTimeout_;  // long: follow libcurl
+  BodySink* bodySink_;
+  std::string* bodyBuffer_;
 
  private:
   // determines whether verifies the authenticity of the peer's certificate.
@@ -163,6 +229,9 @@ class HttpRequest {
   // determines whether verifies that the server cert is known.
   static long sSSLVerifyHost;  // long: follow libcurl
 
+  // determines whether sends Accept-Encoding: gzip, deflate.
+  static std::atomic<bool> sGzipEnabled;
+
  public:
   // default CURLOPT_SSL_VERIFYHOST is 2
   static const long DEFALT_VERIFYHOST_OPT = 2;  // long: follow libcurl
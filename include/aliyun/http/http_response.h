@@ -20,9 +20,11 @@
 #ifndef ALIYUN_HTTP_HTTP_RESPONSE_H_
 #define ALIYUN_HTTP_HTTP_RESPONSE_H_
 
+#include <map>
 #include <string>
 
 #include "aliyun/http/format_type.h"
+#include "aliyun/http/header_store.h"
 #include "aliyun/http/http_request.h"
 
 namespace aliyun {
@@ -35,23 +37,50 @@ class HttpResponse : public HttpRequest {
 
   HttpResponse() {
     status_ = 0;
+    headerMapValid_ = false;
   }
 
   explicit HttpResponse(std::string url)
-      : HttpRequest(url) {
+      : HttpRequest(std::move(url)) {
     status_ = 0;
+    headerMapValid_ = false;
   }
 
   // override
-  void setContent(string content, string encoding, FormatType format) {
-    content_ = content;
+  void setContent(string content, const string& encoding, FormatType format) {
+    content_ = std::move(content);
     encoding_ = encoding;
     contentType_ = format;
   }
 
-  std::string getHeaderValue(std::string name) const;
+  // received headers, names are case-insensitive.
+  std::string getHeaderValue(const std::string& name) const;
 
-  static HttpResponse getResponse(HttpRequest request);
+  const HeaderStore& getHeaderStore() const {
+    return headerStore_;
+  }
+
+  // modifiable, getHeaders() makes a new copy after this.
+  HeaderStore& headerStore() {
+    headerMapValid_ = false;
+    return headerStore_;
+  }
+
+  // drop all headers, as for an earlier response (100 Continue, redirects).
+  void clearHeaders() {
+    headerStore_.clear();
+    headerMap_.clear();
+    headerMapValid_ = false;
+  }
+
+  // copy of the header store as a map, made on first call.
+  const std::map<std::string, std::string>& getHeaders() const;
+
+  static HttpResponse getResponse(const HttpRequest& request);
+
+  // send request on a handle borrowed from pool, reuses its connections.
+  static HttpResponse getResponse(const HttpRequest& request,
+                                  CurlHandlePool* pool);
 
   int getStatus() const {
     return status_;
@@ -68,10 +97,16 @@ class HttpResponse : public HttpRequest {
   }
 
  private:
+  friend class LoopbackTransport;
+  friend struct HttpTransaction;
+
   static void parseParameters(HttpResponse* response);
 
  private:
   int status_;
+  HeaderStore headerStore_;
+  mutable std::map<std::string, std::string> headerMap_;
+  mutable bool headerMapValid_;
 };
 
 }  // namespace http
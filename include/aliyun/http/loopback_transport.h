@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_HTTP_LOOPBACK_TRANSPORT_H_
+#define ALIYUN_HTTP_LOOPBACK_TRANSPORT_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+
+#include "aliyun/http/transport.h"
+
+namespace aliyun {
+namespace http {
+
+// replays canned responses in process, no network involved. lets tests
+// and benchmarks run the whole client stack (signing, query building,
+// parsing) offline and reproducibly:
+//   LoopbackTransport transport;
+//   transport.addResponse("/search", "{\"status\":\"OK\",...}");
+//   client.setTransport(&transport);
+//
+// a response added for "/search" answers urls whose path ends with it,
+// such as "http://host/v2/api/search?query=...", the longest match wins.
+// set responses up before sending, send() itself is thread-safe.
+class LoopbackTransport : public Transport {
+ public:
+  static const size_t DEFAULT_CHUNK_SIZE = 16384;  // as CURL_MAX_WRITE_SIZE
+
+  LoopbackTransport();
+
+  // replaces an earlier response of the same path.
+  void addResponse(const std::string& path, const std::string& content,
+                   int status = 200,
+                   const std::string& contentType =
+                       "application/json;charset=utf-8");
+
+  // for paths without a response, 404 and empty by default.
+  void setDefaultResponse(const std::string& content, int status = 200,
+                          const std::string& contentType =
+                              "application/json;charset=utf-8");
+
+  // a body sink of the request gets the content in pieces of this size.
+  void setChunkSize(size_t size) {
+    chunkSize_ = size > 0 ? size : DEFAULT_CHUNK_SIZE;
+  }
+
+  // number of requests sent so far.
+  size_t getRequestCount() const {
+    return requests_.load();
+  }
+
+  HttpResponse send(const HttpRequest& request);
+
+  // "/v2/api/search" of "http://host/v2/api/search?query=...".
+  static std::string getPath(const std::string& url);
+
+ private:
+  struct Canned {
+    int status;
+    std::string content;
+    std::string contentType;
+    std::string contentLength;
+  };
+
+  const Canned& find(const std::string& path) const;
+
+  static Canned makeCanned(const std::string& content, int status,
+                           const std::string& contentType);
+
+  // noncopyable.
+  LoopbackTransport& operator=(const LoopbackTransport& rhs);
+  LoopbackTransport(const LoopbackTransport& rhs);
+
+  std::map<std::string, Canned> responses_;
+  Canned default_;
+  size_t chunkSize_;
+  std::atomic<size_t> requests_;
+};
+
+}  // namespace http
+}  // namespace aliyun
+
+#endif  // ALIYUN_HTTP_LOOPBACK_TRANSPORT_H_
@@ -58,9 +58,9 @@ class MethodType {
   //   assign from Value(MethodType <= Value), explicit need DIY
   MethodType(Value v = INVALID);
 
-  explicit MethodType(std::string method);
+  explicit MethodType(const std::string& method);
 
-  inline operator int() {
+  inline operator int() const {
     return value_;
   }
 
@@ -46,7 +46,7 @@ class ProtocolType {
     return value_;
   }
 
-  explicit ProtocolType(std::string protocol);
+  explicit ProtocolType(const std::string& protocol);
 
   std::string toString();
 
@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_HTTP_TRANSPORT_H_
+#define ALIYUN_HTTP_TRANSPORT_H_
+
+#include <exception>
+#include <functional>
+#include <mutex>
+
+#include "aliyun/http/http_request.h"
+#include "aliyun/http/http_response.h"
+
+namespace aliyun {
+namespace http {
+
+class CurlHandlePool;
+class HttpMultiEngine;
+
+// sends requests for CloudsearchClient.
+//
+// implementations honour the body sink and body buffer of the request the
+// same way HttpResponse::getResponse() does, and must be thread-safe.
+class Transport {
+ public:
+  // same as HttpMultiEngine::Callback.
+  typedef std::function<void(HttpResponse& response,  // NOLINT
+                             std::exception_ptr error)> Callback;
+
+  virtual ~Transport() {}
+
+  // throws CurlException if the request fails.
+  virtual HttpResponse send(const HttpRequest& request) = 0;
+
+  // sends the request asynchronously, callback invoked when done. the
+  // default sends on the calling thread and invokes callback before return.
+  virtual void submit(const HttpRequest& request, Callback callback);
+};
+
+// the default transport, libcurl on handles borrowed from `pool`.
+// asynchronous requests share one HttpMultiEngine, created when needed.
+class CurlTransport : public Transport {
+ public:
+  explicit CurlTransport(CurlHandlePool* pool = NULL);
+
+  ~CurlTransport();
+
+  HttpResponse send(const HttpRequest& request);
+
+  void submit(const HttpRequest& request, Callback callback);
+
+ private:
+  // noncopyable.
+  CurlTransport& operator=(const CurlTransport& rhs);
+  CurlTransport(const CurlTransport& rhs);
+
+  HttpMultiEngine* getEngine();
+
+  CurlHandlePool* pool_;
+  HttpMultiEngine* engine_;
+  std::mutex engineMutex_;
+};
+
+}  // namespace http
+}  // namespace aliyun
+
+#endif  // ALIYUN_HTTP_TRANSPORT_H_
@@ -25,5 +25,7 @@
 #include "opensearch/cloudsearch_index.h"
 #include "opensearch/cloudsearch_search.h"
 #include "opensearch/cloudsearch_suggest.h"
+#include "opensearch/ha_doc_importer.h"
+#include "opensearch/ha_doc_reader.h"
 
 #endif  // ALIYUN_OPENSEARCH_H_
@@ -21,14 +21,20 @@
 #define ALIYUN_OPENSEARCH_CLOUDSEARCH_CLIENT_H_
 
 #include <time.h>
+#include <future>
 #include <map>
+#include <mutex>
 #include <string>
 
 #include "aliyun/auth/url_encoder.h"
 #include "aliyun/auth/hmac_sha1.h"
+#include "aliyun/http/body_sink.h"
+#include "aliyun/http/curl_handle_pool.h"
 #include "aliyun/http/http_request.h"
 #include "aliyun/http/http_response.h"
+#include "aliyun/http/transport.h"
 #include "aliyun/utils/date.h"
+#include "aliyun/utils/deadline.h"
 #include "aliyun/utils/parameter_helper.h"
 #include "aliyun/utils/string_utils.h"
 #include "object/key_type_enum.h"
@@ -40,6 +46,12 @@ class Exception;
 namespace aliyun {
 namespace opensearch {
 
+/**
+ * opensearch 请求客户端。
+ *
+ * 线程安全：多个线程可以共享同一个client，共用其中的连接池。set开头的配置
+ * 方法需在client被多个线程共享之前调用，之后配置保持不变。
+ */
 class CloudsearchClient {
  public:
   typedef std::string string;
@@ -55,6 +67,16 @@ class CloudsearchClient {
 
   static const string METHOD_POST;  // = "POST";
 
+  /**
+   * 默认的请求超时时间，单位为：毫秒。
+   */
+  static const int DEFAULT_TIMEOUT = 10000;
+
+  /**
+   * 默认的连接超时时间，单位为：毫秒。
+   */
+  static const int DEFAULT_CONNECT_TIMEOUT = 5000;
+
   /**
    * 构造函数
    *
@@ -63,9 +85,10 @@ class CloudsearchClient {
    * @param opts 一些可选信息，包含：
    *              version 当前使用的API版本，默认值为 ：v2
    *              host 指定请求的host地址
-   *              timeout 指定请求超时时间，单位为：微秒。用户可以根据自己的场景来设定此值， 例如如果搜索可以设定时间稍短，如果推送文档，可以设定稍长的时间。默认为10000
-   *              connect_timeout 指定连接超时时间，单位为：微秒。默认为5000
-   *              gzip 指定使用gzip方式传输数据，默认为false
+   *              timeout 指定请求超时时间，单位为：毫秒。用户可以根据自己的场景来设定此值， 例如如果搜索可以设定时间稍短，如果推送文档，可以设定稍长的时间。默认为10000，0表示不超时
+   *              connect_timeout 指定连接超时时间，单位为：毫秒。默认为5000
+   *              gzip 指定使用gzip方式传输返回结果，只对本client生效，默认为false
+   *              gzip_request 指定push文档时使用gzip压缩请求body，默认为false
    * @throws UnknownHostException
    * @donotgenetatedoc
    */
@@ -80,16 +103,108 @@ class CloudsearchClient {
    * @param opts 一些可选信息，包含：
    *            version 当前使用的API版本，默认值为v2。
    *            host 指定请求的host地址，默认为：http://opensearch-cn-hangzhou.aliyuncs.com
-   *            timeout 指定请求超时时间，单位为：微秒。用户可以根据自己的场景来设定此值，例如如果搜索可以设定时间稍短，如果推送文档，可以设定稍长的时间。单位为：微妙，默认值为10000
-   *            connect_timeout 指定连接超时时间，单位为：微秒，默认值为5000
+   *            timeout 指定请求超时时间，单位为：毫秒。用户可以根据自己的场景来设定此值，例如如果搜索可以设定时间稍短，如果推送文档，可以设定稍长的时间。默认值为10000，0表示不超时
+   *            connect_timeout 指定连接超时时间，单位为：毫秒，默认值为5000
+   *            gzip 指定使用gzip方式传输返回结果，只对本client生效，默认为false
+   *            gzip_request 指定push文档时使用gzip压缩请求body，默认为false
    * @param keyType 指定当前的用户类型，取值范围为：KeyTypeEnum.OPENSEARCH，KeyTypeEnum.ALIYUN。默认值为KeyTypeEnum.OPENSEARCH
    * @throws UnknownHostException
    */
   CloudsearchClient(string accesskey, string secret, string host,
                     const std::map<string, string>& opts, KeyTypeEnum keyType);
 
+  ~CloudsearchClient();
+
+  /**
+   * 设置连接池中保持的最大空闲连接数
+   *
+   * 客户端会复用连接池中的连接(keep-alive)发送请求，避免每次请求重新建立TCP/TLS连接。
+   * 不限制并发请求数，超出时的请求使用新连接，用完后关闭。
+   *
+   * @param maxConns 最大空闲连接数，默认值为16。小于等于0时忽略。
+   */
   void setMaxConnections(int maxConns);
 
+  /**
+   * 获取连接池中保持的最大空闲连接数
+   *
+   * @return int 最大空闲连接数
+   */
+  int getMaxConnections() const {
+    return static_cast<int>(pool_.getMaxIdleHandles());
+  }
+
+  /**
+   * 获取请求超时时间
+   *
+   * @return int 请求超时时间，单位为：毫秒。
+   */
+  int getTimeout() const {
+    return timeout_;
+  }
+
+  /**
+   * 获取连接超时时间
+   *
+   * @return int 连接超时时间，单位为：毫秒。
+   */
+  int getConnectTimeout() const {
+    return connectTimeout_;
+  }
+
+  /**
+   * 设置是否使用gzip压缩POST请求的body
+   *
+   * 开启后，POST请求中的items参数(push的文档数据)将以gzip压缩的表单body发送
+   * (Content-Encoding: gzip)，其余参数和签名仍在query string中。
+   * 没有zlib支持时忽略。
+   *
+   * @param enable 是否开启，默认为false。
+   */
+  void setRequestGzip(bool enable);
+
+  /**
+   * 获取是否使用gzip压缩POST请求的body
+   *
+   * @return bool 是否开启
+   */
+  bool isRequestGzip() const {
+    return requestGzip_;
+  }
+
+  /**
+   * 获取是否请求gzip压缩的返回结果
+   *
+   * 由构造时的gzip选项决定，开启后每个请求带Accept-Encoding: gzip, deflate，
+   * 返回结果在接收时解压。没有zlib支持时为false。
+   *
+   * @return bool 是否开启
+   */
+  bool isResponseGzip() const {
+    return responseGzip_;
+  }
+
+  /**
+   * 设置发送请求使用的传输
+   *
+   * 默认使用libcurl。测试或者压测时可以设置为http::LoopbackTransport，
+   * 不经过网络返回预先设置的结果。
+   *
+   * @param transport 不为NULL时需在client之后销毁；NULL恢复默认的libcurl传输。
+   */
+  void setTransport(http::Transport* transport) {
+    transport_ = transport != NULL ? transport : &curlTransport_;
+  }
+
+  /**
+   * 获取发送请求使用的传输
+   *
+   * @return http::Transport* 当前使用的传输。
+   */
+  http::Transport* getTransport() const {
+    return transport_;
+  }
+
   /**
    * 向服务器发出请求并获得返回结果
    *
@@ -98,8 +213,8 @@ class CloudsearchClient {
    * @param method 当前请求的方法，取值为CloudsearchClient.METHOD_GET或者CloudsearchClient.METHOD_POST。默认值为CloudsearchClient.METHOD_GET
    * @return string 返回获取的结果。
    */
-  string call(string path, const std::map<string, string>& params,
-              string method, bool isPB) throw(aliyun::Exception) {
+  string call(const string& path, const std::map<string, string>& params,
+              const string& method, bool isPB) throw(aliyun::Exception) {
     string debugInfo;
     return call(path, params, method, isPB, debugInfo);
   }
@@ -115,8 +230,8 @@ class CloudsearchClient {
    * @throws ClientProtocolException
    * @donotgenetatedoc
    */
-  string call(string path, const std::map<string, string>& params, bool isPB)
-                  throw(aliyun::Exception) {
+  string call(const string& path, const std::map<string, string>& params,
+              bool isPB) throw(aliyun::Exception) {
     return call(path, params, DEFAULT_METHOD, isPB);
   }
 
@@ -131,8 +246,44 @@ class CloudsearchClient {
    * @return string 返回获取的结果。
    * @throws IOException
    */
-  string call(string path, const std::map<string, string>& params,
-              string method, bool isPB, stringref debugInfo);
+  string call(const string& path, const std::map<string, string>& params,
+              const string& method, bool isPB, stringref debugInfo) {
+    return call(path, params, method, isPB, debugInfo, utils::Deadline());
+  }
+
+  /**
+   * 向服务器发出请求并获得返回结果
+   *
+   * 请求的超时时间不会超过deadline，deadline已过时不再发出请求。
+   *
+   * @param path 当前请求的path路径。
+   * @param params 当前请求的所有参数数组。
+   * @param method 当前请求的方法，取值为CloudsearchClient.METHOD_GET或者CloudsearchClient.METHOD_POST。
+   * @param isPB 是否为protobuf类型，默认为false
+   * @param debugInfo 当前请求的调试信息
+   * @param deadline 本次调用的截止时间，超时抛出CurlException。
+   * @return string 返回获取的结果。
+   */
+  string call(const string& path, const std::map<string, string>& params,
+              const string& method, bool isPB, stringref debugInfo,
+              const utils::Deadline& deadline);
+
+  /**
+   * 向服务器发出请求，返回结果边接收边交给sink处理
+   *
+   * 结果不在内存中另外缓存，sink抛出的异常会中断请求并原样抛出。
+   *
+   * @param path 当前请求的path路径。
+   * @param params 当前请求的所有参数数组。
+   * @param method 当前请求的方法，取值为CloudsearchClient.METHOD_GET或者CloudsearchClient.METHOD_POST。
+   * @param debugInfo 当前请求的调试信息
+   * @param deadline 本次调用的截止时间，超时抛出CurlException。
+   * @param sink 接收返回结果的BodySink。
+   */
+  void call(const string& path, const std::map<string, string>& params,
+            const string& method, stringref debugInfo,
+            const utils::Deadline& deadline, http::BodySink* sink);
+
   /**
    * 向服务器发出请求并获得返回结果
    *
@@ -144,8 +295,8 @@ class CloudsearchClient {
    * @throws IOException
    * @donotgenetatedoc
    */
-  string call(string path, const std::map<string, string>& params,
-              string method) throw(aliyun::Exception) {
+  string call(const string& path, const std::map<string, string>& params,
+              const string& method) throw(aliyun::Exception) {
     return call(path, params, method, false);
   }
 
@@ -158,24 +309,89 @@ class CloudsearchClient {
    * @param debugInfo 当前请求的调试信息
    * @return string 返回获取的结果。
    */
-  string call(string path, const std::map<string, string>& params,
-              string method, stringref debugInfo) throw(aliyun::Exception) {
+  string call(const string& path, const std::map<string, string>& params,
+              const string& method, stringref debugInfo)
+                  throw(aliyun::Exception) {
     return call(path, params, method, false, debugInfo);
   }
 
+  /**
+   * 异步向服务器发出请求
+   *
+   * 请求由后台的事件循环线程统一驱动，调用方无需为每个请求创建线程，
+   * 可同时发出大量请求。请求的签名和调试信息在调用时同步生成。
+   *
+   * @param path 当前请求的path路径。
+   * @param params 当前请求的所有参数数组。
+   * @param method 当前请求的方法，取值为CloudsearchClient.METHOD_GET或者CloudsearchClient.METHOD_POST。
+   * @param isPB 是否为protobuf类型，默认为false
+   * @param debugInfo 当前请求的调试信息
+   * @return std::future<string> 通过future获取结果，请求失败时get()抛出异常。
+   */
+  std::future<string> callAsync(const string& path,
+                                const std::map<string, string>& params,
+                                const string& method, bool isPB,
+                                stringref debugInfo) {
+    return callAsync(path, params, method, isPB, debugInfo, utils::Deadline());
+  }
+
+  /**
+   * 异步向服务器发出请求
+   *
+   * @param path 当前请求的path路径。
+   * @param params 当前请求的所有参数数组。
+   * @param method 当前请求的方法，取值为CloudsearchClient.METHOD_GET或者CloudsearchClient.METHOD_POST。
+   * @param isPB 是否为protobuf类型，默认为false
+   * @param debugInfo 当前请求的调试信息
+   * @param deadline 本次调用的截止时间，超时时future抛出CurlException。
+   * @return std::future<string> 通过future获取结果，请求失败时get()抛出异常。
+   */
+  std::future<string> callAsync(const string& path,
+                                const std::map<string, string>& params,
+                                const string& method, bool isPB,
+                                stringref debugInfo,
+                                const utils::Deadline& deadline);
+
+  /**
+   * 异步向服务器发出请求
+   *
+   * @param path 当前请求的path路径。
+   * @param params 当前请求的所有参数数组。
+   * @param method 当前请求的方法，取值为CloudsearchClient.METHOD_GET或者CloudsearchClient.METHOD_POST。
+   * @return std::future<string> 通过future获取结果，请求失败时get()抛出异常。
+   */
+  std::future<string> callAsync(const string& path,
+                                const std::map<string, string>& params,
+                                const string& method) {
+    string debugInfo;
+    return callAsync(path, params, method, false, debugInfo);
+  }
+
  private:
   string getNonce();
 
-  string buildQuery(const std::map<string, string>& params);
+  class SignedParams;
+
+  // append canonical query of params but `skipKey` (if not NULL) for
+  // signing to `query`.
+  static void buildQuery(const SignedParams& params, const char* skipKey,
+                         string* query);
 
-  string doSign(std::map<string, string>* params);
+  string doSign(const SignedParams& params);
 
-  static string buildHttpParameterString(const std::map<string, string>& param);
+  // append "?k=v&..." of params but `skipKey` (if not NULL) to `url`.
+  static void buildHttpParameterString(const SignedParams& params,
+                                       const char* skipKey, string* url);
 
-  string getAliyunSign(std::map<string, string>* params, string method);
+  string getAliyunSign(const SignedParams& params, const string& method);
 
-  string doRequest(string url, const std::map<string, string>& requestParams,
-                   string method, bool isPB);
+  http::HttpRequest buildRequest(const string& path,
+                                 const std::map<string, string>& params,
+                                 const string& method, stringref debugInfo,
+                                 const utils::Deadline& deadline);
+
+  // takes the content out of `response`.
+  static string getResult(http::HttpResponse* response, bool isPB);
 
   /**
    * 用户的client id。
@@ -221,8 +437,52 @@ class CloudsearchClient {
    */
   string secret_;
 
+  /**
+   * secret_ + "&"的HMAC-SHA1密钥状态，构造时计算一次。
+   */
+  auth::HmacSha1Key aliyunKey_;
+
+  /**
+   * 是否使用gzip压缩POST请求的body。
+   */
+  bool requestGzip_;
+
+  /**
+   * 是否请求gzip压缩的返回结果。
+   */
+  bool responseGzip_;
+
+  /**
+   * 请求超时时间，单位为：毫秒。
+   */
+  int timeout_;
+
+  /**
+   * 连接超时时间，单位为：毫秒。
+   */
+  int connectTimeout_;
+
+  /**
+   * 可复用的curl连接池，所有请求共享。
+   */
+  http::CurlHandlePool pool_;
+
+  /**
+   * 默认的curl传输，使用pool_中的连接。
+   */
+  http::CurlTransport curlTransport_;
+
+  /**
+   * 发送请求使用的传输，默认为curlTransport_。
+   */
+  http::Transport* transport_;
+
   void initialize(const string &clientId, const string &clientSecret,
                   const string &host, const std::map<string, string> &opts);
+
+  // noncopyable.
+  CloudsearchClient& operator=(const CloudsearchClient& rhs);
+  CloudsearchClient(const CloudsearchClient& rhs);
 };
 
 }  // namespace opensearch
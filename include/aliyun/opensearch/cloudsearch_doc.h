@@ -22,11 +22,15 @@
 
 #include <stdint.h>
 
+#include <future>
 #include <map>
 #include <queue>
 #include <string>
 #include <vector>
 
+#include "aliyun/opensearch/ha_doc_importer.h"
+#include "aliyun/utils/rate_limiter.h"
+
 namespace aliyun {
 namespace opensearch {
 class CloudsearchClient;
@@ -106,7 +110,7 @@ class CloudsearchDoc {
    * @throws IOException
    * @throws ClientProtocolException
    */
-  string detail(string docId);
+  string detail(const string& docId);
 
   /**
    * 添加文档
@@ -148,20 +152,39 @@ class CloudsearchDoc {
    * @throws IOException
    * @throws ClientProtocolException
    */
-  string push(string tableName);
+  string push(const string& tableName);
 
   /**
    * 执行文档变更操作(2)
    *
    * 通过此接口可以直接将符合文档格式的数据直接推送到指定的表中
    *
-   * @param docs 此docs为用户push的数据，此字段为json类型的字符串。
+   * @param docs 此docs为用户push的数据，此字段为json类型的字符串。传入右值时不复制。
    * @param tableName 操作的表名。
    * @return 请求API并返回相应的结果。
    * @throws IOException
    * @throws ClientProtocolException
    */
-  string push(string docs, string tableName);
+  string push(string docs, const string& tableName);
+
+  /**
+   * 异步执行文档变更操作(1)
+   *
+   * 同push(tableName)，调用返回时已提交的文档数据即被清空，可以继续添加下一批文档。
+   *
+   * @param tableName 表名称
+   * @return std::future<string> 通过future获取返回的数据，请求失败时get()抛出异常。
+   */
+  std::future<string> pushAsync(const string& tableName);
+
+  /**
+   * 异步执行文档变更操作(2)
+   *
+   * @param docs 此docs为用户push的数据，此字段为json类型的字符串。传入右值时不复制。
+   * @param tableName 操作的表名。
+   * @return std::future<string> 通过future获取返回的数据，请求失败时get()抛出异常。
+   */
+  std::future<string> pushAsync(string docs, const string& tableName);
 
   /**
    * 通过文件导入数据(1)
@@ -198,7 +221,7 @@ class CloudsearchDoc {
    * @return 返回成功或者错误信息。
    * @throws JSONException
    */
-  string pushHADocFile(string filePath, string tableName);
+  string pushHADocFile(const string& filePath, const string& tableName);
 
   /**
    * 通过文件导入数据(2)
@@ -211,15 +234,54 @@ class CloudsearchDoc {
    * @return 返回成功或者错误信息。
    * @throws JSONException
    */
-  string pushHADocFile(string filePath, string tableName, int64_t offset);
+  string pushHADocFile(const string& filePath, const string& tableName,
+                       int64_t offset);
+
+  /**
+   * 通过文件导入数据(3)
+   *
+   * 导入HA3 doc数据到指定的应用的指定表中，解析、编码和推送以流水线方式并行执行。
+   *
+   * @param filePath 指定的文件路径。
+   * @param tableName 指定push数据的表名。
+   * @param offset 文档数据的偏移量，小于设定的offset行号的doc将被跳过
+   * @param options 导入选项，包括编码和推送的并发数等。
+   * @return 返回成功或者错误信息。错误信息中的行号为最后推送成功的文档的结束行号。
+   */
+  string pushHADocFile(const string& filePath, const string& tableName,
+                       int64_t offset, const HaDocImporter::Options& options);
 
   /**
    * 检查发送频率限制。
    *
+   * 已废弃，timeLimitQueue不再使用。设置了限流器时按限流器等待，
+   * 否则按PUSH_FREQUENCE使用进程内共享的限流器等待。
+   *
    * @param Queue<Long> timeLimitQueue
    */
   void timeLimitCheck(std::queue<time_t>* timeLimitQueue);
 
+  /**
+   * 设置限流器
+   *
+   * 设置后push、pushAsync和pushHADocFile在发送前按请求数和URL编码后的字节数限流。
+   * 同一个限流器可以被多个线程和多个CloudsearchDoc共享，生命周期由调用者管理。
+   *
+   * @param rateLimiter 限流器，为NULL时不限流(默认)。
+   */
+  void setRateLimiter(utils::RateLimiter* rateLimiter) {
+    this->rateLimiter_ = rateLimiter;
+  }
+
+  /**
+   * 获取限流器
+   *
+   * @return utils::RateLimiter* 限流器，没有设置时为NULL。
+   */
+  utils::RateLimiter* getRateLimiter() const {
+    return this->rateLimiter_;
+  }
+
   /**
    * 获取上次请求的信息
    *
@@ -230,7 +292,14 @@ class CloudsearchDoc {
   }
 
  private:
-  void operate(string cmd, const std::map<string, string>& fields);
+  friend class HaDocImporter;
+
+  void operate(const string& cmd, const std::map<string, string>& fields);
+
+  static std::map<string, string> buildPushParams(string docs,
+                                                  const string& tableName);
+
+  void throttle(const string& docs);
 
   /**
    * 索引名称。
@@ -256,6 +325,11 @@ class CloudsearchDoc {
    * 调用client时发送的请求串信息
    */
   string debugInfo_;
+
+  /**
+   * 限流器，为NULL时不限流。
+   */
+  utils::RateLimiter* rateLimiter_;
 };
 
 }  // namespace opensearch
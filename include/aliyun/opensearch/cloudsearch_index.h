@@ -49,7 +49,7 @@ class CloudsearchIndex {
    * @throws IOException
    * @throws ClientProtocolException
    */
-  std::string createByTemplateName(std::string templateName,
+  std::string createByTemplateName(const std::string& templateName,
                                    const std::map<std::string,
                                                   std::string> &opts);
 
@@ -61,7 +61,7 @@ class CloudsearchIndex {
    * @throws IOException
    * @throws ClientProtocolException
    */
-  std::string createByTemplateName(std::string templateName);
+  std::string createByTemplateName(const std::string& templateName);
 
 
   /**
@@ -74,7 +74,7 @@ class CloudsearchIndex {
    * @throws IOException
    * @throws ClientProtocolException
    */
-  std::string rename(std::string toIndexName,
+  std::string rename(const std::string& toIndexName,
                      const std::map<std::string, std::string> &opts);
 
 
@@ -139,8 +139,8 @@ class CloudsearchIndex {
    * @throws IOException
    * @donotgenetatedoc
    */
-  std::string createTask(std::string operate, std::string tableName,
-                         bool needBuild);
+  std::string createTask(const std::string& operate,
+                         const std::string& tableName, bool needBuild);
 
   /**
    * 创建一条重建索引的任务
@@ -162,7 +162,7 @@ class CloudsearchIndex {
    * @throws ClientProtocolException
    * @throws IOException
    */
-  std::string createImportTask(std::string tableName, bool needBuild);
+  std::string createImportTask(const std::string& tableName, bool needBuild);
 
   /**
    * 获取错误信息
@@ -20,11 +20,14 @@
 #ifndef ALIYUN_OPENSEARCH_CLOUDSEARCH_SEARCH_H_
 #define ALIYUN_OPENSEARCH_CLOUDSEARCH_SEARCH_H_
 
+#include <future>
 #include <map>
 #include <vector>
 #include <string>
+#include <utility>
 
 #include "aliyun/opensearch/cloudsearch_client.h"
+#include "aliyun/opensearch/object/search_result.h"
 #include "aliyun/opensearch/object/search_type_enum.h"
 #include "aliyun/utils/any.h"
 
@@ -119,6 +122,96 @@ class CloudsearchSearch {
    */
   std::string search();
 
+  /**
+   * 执行搜索请求(3)
+   *
+   * @param opts 同search(opts)。
+   * @param deadline 本次搜索的截止时间，超时抛出CurlException。
+   * @return std::string 返回搜索结果。
+   */
+  std::string search(SummaryMapRef opts, const utils::Deadline& deadline);
+
+  /**
+   * 执行搜索请求(4)
+   *
+   * @param deadline 本次搜索的截止时间，超时抛出CurlException。
+   * @return std::string 返回搜索结果。
+   */
+  std::string search(const utils::Deadline& deadline);
+
+  /**
+   * 执行搜索请求(5)
+   *
+   * 以json格式请求，并把结果解析到result中，不修改format设置。
+   *
+   * @param opts 同search(opts)。
+   * @param result 保存解析后的搜索结果。
+   * @throws JsonException 返回结果不是合法的json。
+   */
+  void search(SummaryMapRef opts, object::SearchResult* result);
+
+  /**
+   * 执行搜索请求(6)
+   *
+   * @param result 保存解析后的搜索结果。
+   */
+  void search(object::SearchResult* result);
+
+  /**
+   * 执行搜索请求(7)
+   *
+   * 同search(opts, result)。
+   *
+   * @param opts 同search(opts)。
+   * @param deadline 本次搜索的截止时间，超时抛出CurlException。
+   * @param result 保存解析后的搜索结果。
+   */
+  void search(SummaryMapRef opts, const utils::Deadline& deadline,
+              object::SearchResult* result);
+
+  /**
+   * 执行搜索请求(8)
+   *
+   * @param deadline 本次搜索的截止时间，超时抛出CurlException。
+   * @param result 保存解析后的搜索结果。
+   */
+  void search(const utils::Deadline& deadline, object::SearchResult* result);
+
+  /**
+   * 异步执行搜索请求(1)
+   *
+   * 请求参数在调用时确定，之后修改本对象不影响已发出的请求。
+   *
+   * @param opts 同search(opts)。
+   * @return std::future<std::string> 通过future获取搜索结果，请求失败时get()抛出异常。
+   */
+  std::future<std::string> searchAsync(SummaryMapRef opts);
+
+  /**
+   * 异步执行搜索请求(2)
+   *
+   * @return std::future<std::string> 通过future获取搜索结果，请求失败时get()抛出异常。
+   */
+  std::future<std::string> searchAsync();
+
+  /**
+   * 异步执行搜索请求(3)
+   *
+   * @param opts 同search(opts)。
+   * @param deadline 本次搜索的截止时间，超时时future抛出CurlException。
+   * @return std::future<std::string> 通过future获取搜索结果，请求失败时get()抛出异常。
+   */
+  std::future<std::string> searchAsync(SummaryMapRef opts,
+                                       const utils::Deadline& deadline);
+
+  /**
+   * 异步执行搜索请求(4)
+   *
+   * @param deadline 本次搜索的截止时间，超时时future抛出CurlException。
+   * @return std::future<std::string> 通过future获取搜索结果，请求失败时get()抛出异常。
+   */
+  std::future<std::string> searchAsync(const utils::Deadline& deadline);
+
   /**
    * 执行遍历搜索结果请求(1)
    *
@@ -176,7 +269,7 @@ class CloudsearchSearch {
    *
    * @param indexName 要移除的应用名称
    */
-  void removeIndex(std::string indexName);
+  void removeIndex(const std::string& indexName);
 
   /**
    * 获取当前请求中所有的应用名列表
@@ -195,7 +288,7 @@ class CloudsearchSearch {
    * @param formulaName 表达式名称。
    */
   void setFormulaName(std::string formulaName) {
-    this->formulaName_ = formulaName;
+    this->formulaName_ = std::move(formulaName);
   }
 
   /**
@@ -203,7 +296,7 @@ class CloudsearchSearch {
    *
    * @return std::string 返回当前设定的表达式名称。
    */
-  std::string getFormulaName() {
+  const std::string& getFormulaName() const {
     return this->formulaName_;
   }
 
@@ -215,7 +308,7 @@ class CloudsearchSearch {
    * @param formulaName 表达式名称。
    */
   void setFirstFormulaName(std::string formulaName) {
-    this->firstFormulaName_ = formulaName;
+    this->firstFormulaName_ = std::move(formulaName);
   }
 
   /**
@@ -223,7 +316,7 @@ class CloudsearchSearch {
    *
    * @return std::string 返回当前设定的表达式名称。
    */
-  std::string getFirstFormulaName() {
+  const std::string& getFirstFormulaName() const {
     return this->firstFormulaName_;
   }
 
@@ -241,8 +334,9 @@ class CloudsearchSearch {
    *
    * @return boolean 返回是否添加成功。
    */
-  bool addSummary(std::string fieldName, int len, std::string element,
-                  std::string ellipsis, int snippet);
+  bool addSummary(const std::string& fieldName, int len,
+                  const std::string& element, const std::string& ellipsis,
+                  int snippet);
 
   /**
    * 添加一条动态摘要(summary)信息(2)
@@ -253,7 +347,7 @@ class CloudsearchSearch {
    *
    * @return boolean 返回是否添加成功。
    */
-  bool addSummary(std::string fieldName);
+  bool addSummary(const std::string& fieldName);
 
   /**
    * 添加一条动态摘要(summary)信息(3)
@@ -269,9 +363,10 @@ class CloudsearchSearch {
    *
    * @return boolean 返回是否添加成功。
    */
-  bool addSummary(std::string fieldName, int len, std::string ellipsis,
-                  int snippet, std::string elementPrefix,
-                  std::string elementPostfix);
+  bool addSummary(const std::string& fieldName, int len,
+                  const std::string& ellipsis, int snippet,
+                  const std::string& elementPrefix,
+                  const std::string& elementPostfix);
 
   /**
    * 获取当前所有设定的摘要信息(summary)
@@ -289,7 +384,7 @@ class CloudsearchSearch {
    * 
    * @return SummaryMap 返回指定字段的summary信息。
    */
-  SummaryMap getSummary(std::string fieldName);
+  SummaryMap getSummary(const std::string& fieldName);
 
 
   /**
@@ -305,7 +400,7 @@ class CloudsearchSearch {
    *
    * @param format 数据格式名称，有xml, json和protobuf 三种类型。默认值为：“xml”
    */
-  void setFormat(std::string format) {
+  void setFormat(const std::string& format) {
     configMap_[KEY_FORMAT] = format;
   }
 
@@ -357,7 +452,7 @@ class CloudsearchSearch {
    * @param sortChar 排序方式，有升序“+”和降序“-”两种方式。默认值为“-”
    */
   void addSort(std::string field, std::string sortChar) {
-    sort_[field] = sortChar;
+    sort_[std::move(field)] = std::move(sortChar);
   }
 
   /**
@@ -366,7 +461,7 @@ class CloudsearchSearch {
    * @param field 指定排序的字段名称。
    */
   void addSort(std::string field) {
-    this->addSort(field, SORT_DECREASE);
+    this->addSort(std::move(field), SORT_DECREASE);
   }
 
   /**
@@ -374,7 +469,7 @@ class CloudsearchSearch {
    *
    * @param field 指定的字段名称。
    */
-  void removeSort(std::string field) {
+  void removeSort(const std::string& field) {
     if (sort_.size() > 0 && sort_.find(field) != sort_.end()) {
       sort_.erase(field);
     }
@@ -385,7 +480,7 @@ class CloudsearchSearch {
    *
    * @return 返回当前所有的排序字段及升降序方式。
    */
-  std::map<std::string, std::string> getSort() {
+  const std::map<std::string, std::string>& getSort() const {
     return sort_;
   }
 
@@ -405,7 +500,7 @@ class CloudsearchSearch {
    * @param paramValue 参数值。
    */
   void addCustomParam(std::string paramKey, std::string paramValue) {
-    this->customParams_[paramKey] = paramValue;
+    this->customParams_[std::move(paramKey)] = std::move(paramValue);
   }
 
   /**
@@ -413,7 +508,7 @@ class CloudsearchSearch {
    *
    * @return 返回自定义参数
    */
-  std::map<std::string, std::string> getCustomParam() {
+  const std::map<std::string, std::string>& getCustomParam() const {
     return this->customParams_;
   }
 
@@ -423,14 +518,14 @@ class CloudsearchSearch {
    * @param filter 过滤规则，例如fieldName >= 1。
    * @param operator 操作符，可以为 AND OR。默认为“AND”
    */
-  void addFilter(std::string filter, std::string op);
+  void addFilter(const std::string& filter, const std::string& op);
 
   /**
    * 增加过滤规则(filter)(2)
    *
    * @param filter 过滤规则。
    */
-  void addFilter(std::string filter) {
+  void addFilter(const std::string& filter) {
     this->addFilter(filter, "AND");
   }
 
@@ -439,7 +534,7 @@ class CloudsearchSearch {
    *
    * @return std::string 返回字符串类型的过滤规则。
    */
-  std::string getFilter() {
+  const std::string& getFilter() const {
     return this->filter_;
   }
 
@@ -464,10 +559,11 @@ class CloudsearchSearch {
    *
    * @return boolean 返回添加成功或失败。
    */
-  bool addAggregate(std::string groupKey, std::string aggFun, std::string range,
-                    std::string maxGroup, std::string aggFilter,
-                    std::string aggSamplerThresHold,
-                    std::string aggSamplerStep);
+  bool addAggregate(const std::string& groupKey, const std::string& aggFun,
+                    const std::string& range, const std::string& maxGroup,
+                    const std::string& aggFilter,
+                    const std::string& aggSamplerThresHold,
+                    const std::string& aggSamplerStep);
 
   /**
    * 添加统计信息(aggregate)相关参数(2)
@@ -478,7 +574,7 @@ class CloudsearchSearch {
    * @return boolean 返回添加成功或失败。
    */
 
-  bool addAggregate(std::string groupKey, std::string aggFun) {
+  bool addAggregate(const std::string& groupKey, const std::string& aggFun) {
     return addAggregate(groupKey, aggFun, "", "", "", "", "");
   }
 
@@ -519,9 +615,9 @@ class CloudsearchSearch {
    *
    * @return 返回是否添加成功。
    */
-  bool addDistinct(std::string key, int distCount, int distTimes,
-                   std::string reserved, std::string distFilter,
-                   std::string updateTotalHit,
+  bool addDistinct(const std::string& key, int distCount, int distTimes,
+                   const std::string& reserved, const std::string& distFilter,
+                   const std::string& updateTotalHit,
                    double grade);
 
   /**
@@ -531,7 +627,7 @@ class CloudsearchSearch {
    *
    * @return 返回是否添加成功。
    */
-  bool addDistinct(std::string key) {
+  bool addDistinct(const std::string& key) {
     return this->addDistinct(key, 0, 0, "", "", "", 0);
   }
 
@@ -543,7 +639,7 @@ class CloudsearchSearch {
    *
    * @return 返回是否添加成功。
    */
-  bool addDistinct(std::string key, int distCount) {
+  bool addDistinct(const std::string& key, int distCount) {
     return this->addDistinct(key, distCount, 0, "", "", "", 0);
   }
 
@@ -556,7 +652,7 @@ class CloudsearchSearch {
    *
    * @return 返回是否添加成功。
    */
-  bool addDistinct(std::string key, int distCount, int distTimes) {
+  bool addDistinct(const std::string& key, int distCount, int distTimes) {
     return this->addDistinct(key, distCount, distTimes, "", "", "", 0);
   }
 
@@ -569,8 +665,8 @@ class CloudsearchSearch {
    * @param reserved 为是否保留抽取之后剩余的结果，true为保留，false则丢弃，丢 弃时totalHits的个数会减去被distinct而丢弃的个数，但这个结果不一定准确，默认为true。
    * @return 返回是否添加成功。
    */
-  bool addDistinct(std::string key, int distCount, int distTimes,
-                   std::string reserved) {
+  bool addDistinct(const std::string& key, int distCount, int distTimes,
+                   const std::string& reserved) {
     return this->addDistinct(key, distCount, distTimes, reserved, "", "", 0);
   }
 
@@ -585,8 +681,8 @@ class CloudsearchSearch {
    *
    * @return 返回是否添加成功。
    */
-  bool addDistinct(std::string key, int distCount, int distTimes,
-                   std::string reserved, std::string distFilter) {
+  bool addDistinct(const std::string& key, int distCount, int distTimes,
+                   const std::string& reserved, const std::string& distFilter) {
     return this->addDistinct(key, distCount, distTimes, reserved, distFilter,
                              "", 0);
   }
@@ -602,9 +698,9 @@ class CloudsearchSearch {
    * @param updateTotalHit 当reserved为false时，设置update_total_hit为true，则最终total_hit会减去被distinct丢弃的的数目（不一定准确），为false则不减； 默认为false。
    * @return 返回是否添加成功。
    */
-  bool addDistinct(std::string key, int distCount, int distTimes,
-                   std::string reserved, std::string distFilter,
-                   std::string updateTotalHit) {
+  bool addDistinct(const std::string& key, int distCount, int distTimes,
+                   const std::string& reserved, const std::string& distFilter,
+                   const std::string& updateTotalHit) {
     return this->addDistinct(key, distCount, distTimes, reserved, distFilter,
                              updateTotalHit, 0);
   }
@@ -614,7 +710,7 @@ class CloudsearchSearch {
    *
    * @param distinctKey 要删除的dist key字段名称。
    */
-  void removeDistinct(std::string distinctKey);
+  void removeDistinct(const std::string& distinctKey);
 
   /**
    * 获取所有的distinct信息
@@ -650,7 +746,7 @@ class CloudsearchSearch {
    * @param query 设定搜索的查询语法。
    */
   void setQueryString(std::string query) {
-    this->query_ = query;
+    this->query_ = std::move(query);
   }
 
   /**
@@ -658,7 +754,7 @@ class CloudsearchSearch {
    *
    * @return 返回当前设定的查询query子句内容。
    */
-  std::string getQuery() {
+  const std::string& getQuery() const {
     return this->query_;
   }
 
@@ -669,7 +765,7 @@ class CloudsearchSearch {
    *
    */
   void setPair(std::string pair) {
-    this->kvpair_ = pair;
+    this->kvpair_ = std::move(pair);
   }
 
   /**
@@ -677,7 +773,7 @@ class CloudsearchSearch {
    *
    * @return std::string 返回当前设定的kvpair。
    */
-  std::string getPair() {
+  const std::string& getPair() const {
     return this->kvpair_;
   }
 
@@ -704,7 +800,7 @@ class CloudsearchSearch {
    *
    * @param fields 结果集返回的字段。
    */
-  void addFetchFields(std::vector<std::string> fields) {
+  void addFetchFields(const std::vector<std::string>& fields) {
     fetches_.insert(fetches_.end(), fields.begin(), fields.end());
   }
 
@@ -714,7 +810,7 @@ class CloudsearchSearch {
    * @param field 指定的字段名称。
    */
   void addFetchField(std::string field) {
-    fetches_.push_back(field);
+    fetches_.push_back(std::move(field));
   }
 
   /**
@@ -732,7 +828,7 @@ class CloudsearchSearch {
    * @param qpName 查询分析规则名称
    */
   void addQpName(std::string qpName) {
-    this->qp_.push_back(qpName);
+    this->qp_.push_back(std::move(qpName));
   }
 
   /**
@@ -740,7 +836,7 @@ class CloudsearchSearch {
    *
    * @param qpNames 查询分析规则名称
    */
-  void addQpNames(std::vector<std::string> qpNames) {
+  void addQpNames(const std::vector<std::string>& qpNames) {
     this->qp_.insert(this->qp_.end(), qpNames.begin(), qpNames.end());
   }
 
@@ -776,8 +872,9 @@ class CloudsearchSearch {
    * @param functionName 需要禁用的函数名称
    * @param value 待禁用函数的详细说明
    */
-  void addDisableFunction(std::string functionName, std::string value) {
-    this->disable_[functionName] =  value;
+  void addDisableFunction(std::string functionName,
+                          const std::string& value) {
+    this->disable_[std::move(functionName)] =  value;
   }
 
   /**
@@ -812,7 +909,7 @@ class CloudsearchSearch {
    * @param indexes
    * @return
    */
-  std::string getIndexInQp(std::vector<std::string> indexes);
+  std::string getIndexInQp(const std::vector<std::string>& indexes);
 
   /**
    * 关闭整个查询分析模块(qp)
@@ -828,7 +925,7 @@ class CloudsearchSearch {
    * @param expire 指定的scroll请求有效期 默认 1m 表示一分钟，支持的时间单位包括：w=Week, d=Day, h=Hour, m=minute, s=second
    */
   void setScrollExpire(std::string expire) {
-    this->scroll_ = expire;
+    this->scroll_ = std::move(expire);
   }
 
   /**
@@ -844,7 +941,7 @@ class CloudsearchSearch {
    * 获取设置的scroll请求有效期
    * @return std::string 设置的scroll请求有效期
    */
-  std::string getScrollExpire() {
+  const std::string& getScrollExpire() const {
     return this->scroll_;
   }
 
@@ -854,7 +951,7 @@ class CloudsearchSearch {
    * @param searchType 设置的搜索请求类型
    */
   void setSearchType(std::string searchType) {
-    this->searchType_ = searchType;
+    this->searchType_ = std::move(searchType);
   }
 
   /**
@@ -862,7 +959,7 @@ class CloudsearchSearch {
    *
    * @return std::string 设置的搜索请求类型
    */
-  std::string getSearchType() {
+  const std::string& getSearchType() const {
     return this->searchType_;
   }
 
@@ -872,7 +969,7 @@ class CloudsearchSearch {
    * @param scrollId scroll请求的起始id
    */
   void setScrollId(std::string scrollId) {
-    this->scrollId_ = scrollId;
+    this->scrollId_ = std::move(scrollId);
   }
 
   /**
@@ -880,7 +977,7 @@ class CloudsearchSearch {
    *
    * @return 设置的scroll请求起始id
    */
-  std::string getScrollId() {
+  const std::string& getScrollId() const {
     return this->scrollId_;
   }
 
@@ -903,6 +1000,34 @@ class CloudsearchSearch {
    */
   std::string call(SearchTypeEnum type);
 
+  /**
+   * 发起请求
+   *
+   * 同call(type)，请求在deadline之前完成，否则抛出CurlException。
+   *
+   * @return 返回API返回的结果。
+   */
+  std::string call(SearchTypeEnum type, const utils::Deadline& deadline);
+
+  /**
+   * 发起异步请求
+   *
+   * 同call(type)，结果通过future返回。
+   *
+   * @return 返回API返回结果的future。
+   */
+  std::future<std::string> callAsync(SearchTypeEnum type);
+
+  /**
+   * 发起异步请求
+   *
+   * 同callAsync(type)，请求在deadline之前完成，否则future抛出CurlException。
+   *
+   * @return 返回API返回结果的future。
+   */
+  std::future<std::string> callAsync(SearchTypeEnum type,
+                                     const utils::Deadline& deadline);
+
 
   /**
    * 获取config子句
@@ -922,14 +1047,14 @@ class CloudsearchSearch {
    */
   template <typename ValueType>
   void addCustomConfig(std::string key, ValueType value) {
-    configMap_[key] = value;
+    configMap_[std::move(key)] = value;
   }
 
   /**
    * 移除自定义配置
    * @param key 指定配置项的key
    */
-  void removeCustomConfig(std::string key) {
+  void removeCustomConfig(const std::string& key) {
     configMap_.erase(key);
   }
 
@@ -947,6 +1072,8 @@ class CloudsearchSearch {
 
   void extract(SummaryMapRef opts, SearchTypeEnum type);
 
+  std::map<std::string, std::string> buildParams(SearchTypeEnum type);
+
   CloudsearchClient *client_;
 
   /**
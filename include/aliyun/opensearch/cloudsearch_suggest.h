@@ -20,6 +20,8 @@
 #ifndef ALIYUN_OPENSEARCH_CLOUDSEARCH_SUGGEST_H_
 #define ALIYUN_OPENSEARCH_CLOUDSEARCH_SUGGEST_H_
 
+#include <future>
+#include <map>
 #include <string>
 
 #include "aliyun/opensearch/cloudsearch_client.h"
@@ -86,6 +88,29 @@ class CloudsearchSuggest {
    */
   std::string search();
 
+  /**
+   * 发起查询请求获取查询结果
+   *
+   * @param deadline 本次查询的截止时间，超时抛出CurlException。
+   * @return String 下拉提示查询结果
+   */
+  std::string search(const utils::Deadline& deadline);
+
+  /**
+   * 异步发起查询请求
+   *
+   * @return std::future<std::string> 通过future获取下拉提示查询结果，请求失败时get()抛出异常。
+   */
+  std::future<std::string> searchAsync();
+
+  /**
+   * 异步发起查询请求
+   *
+   * @param deadline 本次查询的截止时间，超时时future抛出CurlException。
+   * @return std::future<std::string> 通过future获取下拉提示查询结果，请求失败时get()抛出异常。
+   */
+  std::future<std::string> searchAsync(const utils::Deadline& deadline);
+
   /**
    * 获取上次请求的信息
    *
@@ -94,6 +119,8 @@ class CloudsearchSuggest {
   std::string getDebugInfo();
 
  private:
+  std::map<std::string, std::string> buildParams();
+
   /**
    * CloudsearchClient实例
    */
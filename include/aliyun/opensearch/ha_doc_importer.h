@@ -0,0 +1,281 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_OPENSEARCH_HA_DOC_IMPORTER_H_
+#define ALIYUN_OPENSEARCH_HA_DOC_IMPORTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "aliyun/opensearch/ha_doc_reader.h"
+#include "aliyun/utils/blocking_queue.h"
+#include "aliyun/utils/mapped_file.h"
+#include "aliyun/utils/rate_limiter.h"
+
+namespace aliyun {
+namespace opensearch {
+
+class CloudsearchClient;
+
+/**
+ * HA3 doc文件导入器
+ *
+ * 以流水线方式导入HA3 doc文件：
+ * <pre>
+ * 解析(1个线程，映射文件后用HaDocReader切片) -> JSON序列化和URL编码(encodeThreads个线程)
+ *   -> 按序打包(调用线程) -> push(pushThreads个线程)
+ * </pre>
+ * 打包阶段严格按文件顺序组织数据块，push确认后按顺序推进检查点，
+ * 检查点之前(含)的所有文档都已经推送成功。
+ *
+ * NOTE: pushThreads大于1时，不同数据块的推送顺序不再确定，
+ *       同一文档的多次变更(add/update/delete)分布在不同数据块时可能乱序生效。
+ */
+class HaDocImporter {
+ public:
+  typedef std::string string;
+  typedef CloudsearchClient& ClientRef;
+
+  /**
+   * 导入选项
+   */
+  struct Options {
+    /**
+     * JSON序列化和URL编码的线程数，默认为2。
+     */
+    int encodeThreads;
+
+    /**
+     * 并发push的线程数，默认为1，即保持文档的推送顺序。
+     */
+    int pushThreads;
+
+    /**
+     * 单次push请求的最大size(URL编码后)，默认为CloudsearchDoc::PUSH_MAX_SIZE。
+     */
+    size_t maxBatchSize;
+
+    /**
+     * 每秒最多push的次数，默认为CloudsearchDoc::PUSH_FREQUENCE。小于等于0时不限制。
+     * 空闲时最多积攒1秒的次数，之后可以连续发出。设置了rateLimiter时忽略。
+     */
+    int pushFrequence;
+
+    /**
+     * 共享的限流器，默认为NULL，即按pushFrequence使用导入器自己的限流器。
+     *
+     * 多个导入器或CloudsearchDoc共用一个配额时设置为同一个限流器，
+     * 每次push按请求数和URL编码后的字节数计数。限流器的生命周期由调用者管理。
+     */
+    utils::RateLimiter* rateLimiter;
+
+    /**
+     * 每个阶段之间缓冲的数据块个数，默认为8。
+     */
+    size_t queueCapacity;
+
+    /**
+     * 检查点文件路径，默认为空，即不记录检查点。
+     *
+     * 设置后导入过程中定期将检查点(字节偏移量和行号)写入该文件，
+     * 再次导入时如果该文件存在，直接跳到记录的字节偏移量继续导入，不再重新扫描之前的内容。
+     * 检查点同时记录文件路径、大小、修改时间和偏移量之前的一段内容的md5，
+     * 任一项不匹配(如换了文件，或文件被改写、追加)时忽略检查点，从头开始导入。
+     * 导入完成后文件保留，记录的是文件末尾，删除后重新导入将从头开始。
+     */
+    string checkpointFile;
+
+    /**
+     * 写检查点文件的最小间隔，单位为毫秒，默认为1000。导入结束时总会写一次。
+     */
+    int checkpointInterval;
+
+    Options();
+  };
+
+  /**
+   * 构造函数
+   *
+   * @param indexName 指定操作的索引名称。
+   * @param client CloudsearchClient实例。
+   * @param options 导入选项。
+   */
+  HaDocImporter(string indexName, ClientRef client,
+                const Options& options = Options());
+
+  /**
+   * 导入HA3 doc文件
+   *
+   * 文件格式同CloudsearchDoc::pushHADocFile。可以多次调用，每次调用重新开始，
+   * 检查点、文档个数等统计只反映最近一次导入。不能并发调用。
+   *
+   * @param filePath 指定的文件路径。
+   * @param tableName 指定push数据的表名。
+   * @param offset 文档数据的偏移量，小于设定的offset行号的doc将被跳过，
+   *        存在检查点文件时取两者中靠后的位置。
+   * @return 全部成功时返回最后一次push的结果，否则返回"last push not OK, line N"，
+   *         N为检查点，从N+1行开始重新导入即可继续。
+   * @throws aliyun::Exception 文件无法打开或请求异常时抛出
+   */
+  string import(const string& filePath, const string& tableName,
+                int64_t offset);
+
+  /**
+   * 获取检查点
+   *
+   * @return int64_t 最后一个已确认推送成功的文档的结束行号，没有时为offset - 1。
+   */
+  int64_t getCheckpoint() const;
+
+  /**
+   * 获取检查点的字节偏移量
+   *
+   * @return size_t 最后一个已确认推送成功的文档结束行之后的字节偏移量。
+   */
+  size_t getCheckpointOffset() const;
+
+  /**
+   * 获取已确认推送成功的文档个数
+   *
+   * @return int64_t 文档个数
+   */
+  int64_t getPushedDocs() const;
+
+  /**
+   * 获取因限流等待的总时间
+   *
+   * @return long 毫秒数
+   */
+  long getThrottleMillis() const;  // long: same as RateLimiter
+
+  /**
+   * 获取最后一次push的返回结果，失败时为失败的返回结果
+   *
+   * @return string 返回结果
+   */
+  string getLastResult() const;
+
+ private:
+  // docs parsed from file, the unit passed between stages.
+  struct Chunk {
+    int64_t seq;
+    std::vector<HaDocReader::Doc> docs;  // slices of the mapped file
+    std::vector<string> jsons;
+    std::vector<size_t> sizes;  // url encoded size of each json
+    std::vector<int64_t> lines;  // end line of each doc
+    std::vector<size_t> offsets;  // byte offset after each doc
+  };
+
+  // docs sent by one push request.
+  struct Batch {
+    int64_t seq;
+    string items;  // json array
+    int64_t lastLine;
+    size_t lastOffset;
+    int64_t docs;
+    size_t size;  // url encoded size
+  };
+
+  void parse(const char* data, size_t size, int64_t offset,
+             size_t resumeOffset, int64_t resumeLine);
+
+  // resume position from checkpoint file, false if none or not usable.
+  bool loadCheckpoint();
+
+  // path, size, mtime and md5 of the bytes just before `offset` of the
+  // file being imported, a checkpoint is only resumed if they all match.
+  void getFileIdentity(size_t offset,
+                       std::map<string, string>* identity) const;
+
+  // write checkpoint file, at most once per checkpointInterval unless forced.
+  void saveCheckpoint(bool force);
+
+  void encode();
+
+  void pack();
+
+  void push(const string& tableName);
+
+  bool putEncoded(Chunk chunk);
+
+  bool takeEncoded(int64_t seq, Chunk* chunk);
+
+  void ack(const Batch& batch, const string& result);
+
+  void fail(const string& result, std::exception_ptr error);
+
+  bool failed() const;
+
+  void throttle(size_t bytes);
+
+  static bool isPushOK(const string& result);
+
+  // noncopyable.
+  HaDocImporter& operator=(const HaDocImporter& rhs);
+  HaDocImporter(const HaDocImporter& rhs);
+
+  string indexName_;
+  CloudsearchClient* client_;
+  Options options_;
+
+  string filePath_;
+  const utils::MappedFile* file_;  // valid during import()
+
+  utils::BlockingQueue<Chunk> parsed_;
+  utils::BlockingQueue<Batch> batches_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::map<int64_t, Chunk> encoded_;  // out of order, waiting for pack
+  int64_t nextEncoded_;  // next chunk seq to pack
+  int64_t totalChunks_;  // -1 until parse done
+
+  std::map<int64_t, Batch> acked_;  // acked ahead of checkpoint
+  int64_t nextAck_;  // next batch seq to move checkpoint
+  int64_t checkpoint_;
+  size_t checkpointOffset_;
+  int64_t pushedDocs_;
+  int64_t lastResultSeq_;
+  string lastResult_;
+
+  bool failed_;
+  string failResult_;
+  std::exception_ptr error_;
+
+  std::mutex saveMutex_;
+  std::chrono::steady_clock::time_point lastSave_;
+  size_t savedOffset_;
+
+  utils::RateLimiter ownLimiter_;
+  utils::RateLimiter* limiter_;
+  long throttleMillis_;  // long: same as RateLimiter
+};
+
+}  // namespace opensearch
+}  // namespace aliyun
+
+#endif  // ALIYUN_OPENSEARCH_HA_DOC_IMPORTER_H_
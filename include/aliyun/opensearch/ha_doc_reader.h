@@ -0,0 +1,173 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_OPENSEARCH_HA_DOC_READER_H_
+#define ALIYUN_OPENSEARCH_HA_DOC_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "aliyun/utils/string_piece.h"
+
+namespace aliyun {
+namespace opensearch {
+
+/**
+ * HA3 doc数据读取器
+ *
+ * 直接扫描内存中(通常是MappedFile映射)的HA3 doc数据，
+ * 字段的key和value都是指向原始数据的切片，不做拷贝。
+ * 格式同CloudsearchDoc::pushHADocFile：每个字段以"\x1F\n"结尾，
+ * 每个文档以"\x1E\n"结尾，多值字段以"\x1D"分隔，字段的value可以跨行。
+ *
+ * 数据在读取器和读出的文档使用期间必须保持有效。
+ */
+class HaDocReader {
+ public:
+  typedef utils::StringPiece StringPiece;
+
+  /**
+   * 文档字段
+   */
+  struct Field {
+    StringPiece key;
+    StringPiece value;
+  };
+
+  /**
+   * 一个HA3文档
+   */
+  struct Doc {
+    /**
+     * CMD字段的值
+     */
+    StringPiece command;
+
+    /**
+     * 除CMD以外的字段，保持文件中的顺序。
+     */
+    std::vector<Field> fields;
+
+    /**
+     * 文档结束符所在的行号，从1开始。
+     */
+    int64_t line;
+
+    /**
+     * 文档结束行之后的字节偏移量，即下一个文档的起始偏移量。
+     */
+    size_t offset;
+
+    Doc();
+
+    void clear();
+
+    /**
+     * 追加文档的JSON格式，结果同相同字段的SingleDoc::getJsonString()。
+     *
+     * @param json 追加到的字符串。
+     */
+    void appendJson(std::string* json) const;
+
+    /**
+     * 获取文档的JSON格式
+     *
+     * @return std::string JSON格式的文档
+     */
+    std::string getJsonString() const;
+  };
+
+  /**
+   * 构造函数
+   *
+   * @param data 数据起始地址。
+   * @param size 数据长度。
+   */
+  HaDocReader(const char* data, size_t size);
+
+  /**
+   * 跳到指定的行开始读取，之前的内容将被忽略。
+   *
+   * 目标行在当前位置之后时从当前位置继续扫描，否则从头扫描。
+   *
+   * @param line 行号，从1开始，小于等于1时从头开始。
+   */
+  void seekLine(int64_t line);
+
+  /**
+   * 直接跳到指定的字节偏移量开始读取，不扫描之前的内容。
+   *
+   * @param offset 字节偏移量，必须是某一行的起始位置，超出数据长度时读取结束。
+   * @param line offset之前的行数，用于继续计算行号。
+   */
+  void seek(size_t offset, int64_t line);
+
+  /**
+   * 读取下一个文档
+   *
+   * 没有任何字段的文档将被跳过，数据末尾不完整的文档将被忽略。
+   *
+   * @param doc 读出的文档。
+   * @return bool 读到文档时为true，数据结束时为false。
+   */
+  bool next(Doc* doc);
+
+  /**
+   * 获取已读取的行数
+   *
+   * @return int64_t 已读取的完整行数。
+   */
+  int64_t getLineNumber() const {
+    return line_;
+  }
+
+  /**
+   * 获取已读取的字节数
+   *
+   * @return size_t 下一个未读取的字节相对数据起始的偏移量。
+   */
+  size_t getOffset() const {
+    return cur_ - begin_;
+  }
+
+ private:
+  // move cur_ forward to `pos`, counting lines passed.
+  void advance(const char* pos);
+
+  // position after the line break following a separator at `sep`,
+  // NULL if the separator is not at the end of a line.
+  const char* lineEnd(const char* sep) const;
+
+  // noncopyable.
+  HaDocReader& operator=(const HaDocReader& rhs);
+  HaDocReader(const HaDocReader& rhs);
+
+  const char* begin_;
+  const char* cur_;
+  const char* end_;
+  int64_t line_;
+};
+
+}  // namespace opensearch
+}  // namespace aliyun
+
+#endif  // ALIYUN_OPENSEARCH_HA_DOC_READER_H_
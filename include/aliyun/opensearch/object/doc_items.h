@@ -20,6 +20,8 @@
 #ifndef ALIYUN_OPENSEARCH_OBJECT_DOC_ITEMS_H_
 #define ALIYUN_OPENSEARCH_OBJECT_DOC_ITEMS_H_
 
+#include <stddef.h>
+
 #include <map>
 #include <string>
 #include <vector>
@@ -30,16 +32,59 @@ namespace aliyun {
 namespace opensearch {
 namespace object {
 
+// serialized docs of one push request.
+//
+// each doc is serialized once when added, sizes of the whole batch are
+// tracked incrementally, so checking batch size costs nothing.
 class DocItems {
  public:
+  DocItems();
+
   void addDoc(const SingleDoc& doc) {
-    docList_.push_back(doc);
+    addJson(doc.getJsonString());
   }
 
+  // add a doc already serialized by SingleDoc::getJsonString().
+  void addJson(const std::string& json);
+
+  // same as addJson(json), with known url encoded size of json.
+  void addJson(const std::string& json, size_t encodedSize);
+
+  // same as addJson(json), json is moved in instead of copied.
+  void addJson(std::string&& json);
+
+  void addJson(std::string&& json, size_t encodedSize);
+
   std::string getJsonString() const;
 
+  // docs as json array, the format push API accepts.
+  std::string getJsonArrayString() const;
+
+  // length of getJsonString() (or getJsonArrayString()).
+  size_t jsonSize() const;
+
+  // length of getJsonString() (or getJsonArrayString()) after url encoded.
+  size_t encodedSize() const;
+
+  // encodedSize() after adding a doc of `encodedSize` url encoded size.
+  size_t encodedSizeWith(size_t encodedSize) const;
+
+  size_t size() const {
+    return jsonList_.size();
+  }
+
+  bool empty() const {
+    return jsonList_.empty();
+  }
+
+  void clear();
+
  private:
-  std::vector<SingleDoc> docList_;
+  std::string join(char begin, char end) const;
+
+  std::vector<std::string> jsonList_;
+  size_t jsonBytes_;  // sum of json length
+  size_t encodedBytes_;  // sum of json length after url encoded
 };
 
 }  // namespace object
@@ -40,7 +40,7 @@ class KeyTypeEnum {
   //   assign from Value(KeyTypeEnum <= Value), explicit need DIY
   KeyTypeEnum(Value v = INVALID);
 
-  explicit KeyTypeEnum(std::string str);
+  explicit KeyTypeEnum(const std::string& str);
 
 #define IMPLEMENT_COMPARE(op) \
   bool operator op (const KeyTypeEnum& rhs) const { \
@@ -21,6 +21,7 @@
 #define ALIYUN_OPENSEARCH_OBJECT_SCHEMA_TABLE_H_
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "aliyun/opensearch/object/schema_table_field.h"
@@ -56,7 +57,7 @@ class SchemaTable {
   }
 
   void setTableName(std::string tableName) {
-    this->tableName_ = tableName;
+    this->tableName_ = std::move(tableName);
   }
 
  private:
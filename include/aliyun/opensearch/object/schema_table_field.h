@@ -21,6 +21,7 @@
 #define ALIYUN_OPENSEARCH_OBJECT_SCHEMA_TABLE_FIELD_H_
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "aliyun/opensearch/object/schema_table_field_type.h"
@@ -60,7 +61,7 @@ class SchemaTableField {
   }
 
   void setFieldName(std::string fieldName) {
-    this->fieldName_ = fieldName;
+    this->fieldName_ = std::move(fieldName);
   }
 
   bool isFilter() const {
@@ -88,7 +89,7 @@ class SchemaTableField {
   }
 
   void setOuterTable(std::string outerTable) {
-    this->outerTable_ = outerTable;
+    this->outerTable_ = std::move(outerTable);
   }
 
   bool isPrimarykey() const {
@@ -59,7 +59,7 @@ class SchemaTableFieldType {
 
   SchemaTableFieldType(Value v = INVALID);
 
-  SchemaTableFieldType(std::string type, std::string bigType);
+  SchemaTableFieldType(const std::string& type, const std::string& bigType);
 
   std::string getTypeName() const;
 
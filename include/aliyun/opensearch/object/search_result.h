@@ -0,0 +1,407 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_OPENSEARCH_OBJECT_SEARCH_RESULT_H_
+#define ALIYUN_OPENSEARCH_OBJECT_SEARCH_RESULT_H_
+
+#include <stddef.h>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "aliyun/utils/string_piece.h"
+
+namespace aliyun {
+namespace reader {
+class JsonReader;
+}  // namespace reader
+}  // namespace aliyun
+
+namespace aliyun {
+namespace opensearch {
+namespace object {
+
+class SearchResult;
+
+/**
+ * 搜索结果中的一条文档
+ *
+ * 只是SearchResult的一个视图，字段名和字段值都指向SearchResult保存的
+ * 原始返回结果，字段值在读取时才解码。使用期间SearchResult必须有效。
+ */
+class SearchHit {
+ public:
+  typedef std::string string;
+  typedef utils::StringPiece StringPiece;
+
+  SearchHit()
+      : result_(NULL),
+        first_(0),
+        count_(0) {
+  }
+
+  SearchHit(const SearchResult* result, size_t first, size_t count)
+      : result_(result),
+        first_(first),
+        count_(count) {
+  }
+
+  /**
+   * 获取字段数量
+   */
+  size_t getFieldCount() const {
+    return count_;
+  }
+
+  /**
+   * 获取第i个字段的名称
+   */
+  StringPiece getFieldName(size_t i) const;
+
+  /**
+   * 获取第i个字段的原始值，字符串带引号和转义，对象和数组为原始json串。
+   */
+  StringPiece getRawValue(size_t i) const;
+
+  /**
+   * 获取第i个字段的值
+   *
+   * 没有转义的字符串直接指向原始结果，否则解码到scratch中，null值返回空串。
+   *
+   * @param i 字段下标
+   * @param scratch 需要解码时使用的缓冲区
+   * @return StringPiece 字段值，在scratch下次修改前有效。
+   */
+  StringPiece getFieldView(size_t i, string* scratch) const;
+
+  /**
+   * 判断是否有指定字段
+   */
+  bool hasField(const StringPiece& name) const {
+    return find(name) != count_;
+  }
+
+  /**
+   * 获取指定字段的值，同getFieldView，没有该字段时返回空串。
+   */
+  StringPiece getFieldView(const StringPiece& name, string* scratch) const;
+
+  /**
+   * 获取指定字段解码后的值，没有该字段或值为null时返回空串。
+   */
+  string getField(const StringPiece& name) const;
+
+ private:
+  size_t find(const StringPiece& name) const;
+
+  const SearchResult* result_;
+  size_t first_;
+  size_t count_;
+};
+
+/**
+ * 搜索结果
+ *
+ * 解析json格式的搜索返回结果，status、request_id、errors及result中的
+ * searchtime、total、num、viewtotal和facet一次解析完成，items中的文档
+ * 只记录字段在原始结果中的位置，通过SearchHit按需读取。
+ *
+ * example：
+ * <code>
+ * SearchResult result;
+ * search.search(&result);
+ * std::string scratch;
+ * for (SearchResult::const_iterator it = result.begin();
+ *     it != result.end(); ++it) {
+ *   StringPiece title = it->getFieldView("title", &scratch);
+ * }
+ * </code>
+ */
+class SearchResult {
+ public:
+  typedef std::string string;
+  typedef utils::StringPiece StringPiece;
+
+  /**
+   * 错误信息
+   */
+  struct Error {
+    string code;
+    string message;
+  };
+
+  /**
+   * 统计结果中的一项
+   */
+  struct FacetItem {
+    string value;
+    int count;
+  };
+
+  /**
+   * aggregate子句的统计结果
+   */
+  struct Facet {
+    string key;
+    std::vector<FacetItem> items;
+  };
+
+  /**
+   * 文档的前向迭代器，不拷贝任何数据。
+   */
+  class const_iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef SearchHit value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const SearchHit* pointer;
+    typedef const SearchHit& reference;
+
+    const_iterator()
+        : result_(NULL),
+          index_(0) {
+    }
+
+    const_iterator(const SearchResult* result, size_t index)
+        : result_(result),
+          index_(index) {
+      load();
+    }
+
+    const SearchHit& operator*() const {
+      return hit_;
+    }
+
+    const SearchHit* operator->() const {
+      return &hit_;
+    }
+
+    const_iterator& operator++() {
+      index_++;
+      load();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return index_ == other.index_ && result_ == other.result_;
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    void load() {
+      if (result_ != NULL && index_ < result_->size()) {
+        hit_ = result_->getHit(index_);
+      }
+    }
+
+    const SearchResult* result_;
+    size_t index_;
+    SearchHit hit_;
+  };
+
+  class Parser;
+
+  /**
+   * 边接收边解析json格式的搜索结果
+   *
+   * 每收到一段数据调用feed，接收完成后调用finish。收到的数据直接追加到
+   * SearchResult保存的原始结果中，不需要另外缓存整个结果。
+   */
+  class StreamParser {
+   public:
+    explicit StreamParser(SearchResult* result);
+
+    ~StreamParser();
+
+    /**
+     * 开始解析一个新的结果，SearchResult之前的内容被清除。
+     */
+    void begin();
+
+    /**
+     * @throws JsonException 结果不是合法的json。
+     */
+    void feed(const char* data, size_t size);
+
+    /**
+     * @throws JsonException 结果不完整。
+     */
+    void finish();
+
+   private:
+    // noncopyable.
+    StreamParser& operator=(const StreamParser& rhs);
+    StreamParser(const StreamParser& rhs);
+
+    SearchResult* result_;
+    reader::JsonReader* reader_;
+    Parser* parser_;
+  };
+
+  SearchResult();
+
+  /**
+   * 解析json格式的搜索结果
+   *
+   * @param response 搜索返回的结果，由SearchResult保存。
+   * @throws JsonException 结果不是合法的json。
+   */
+  explicit SearchResult(string response);
+
+  /**
+   * 解析json格式的搜索结果，之前的内容被清除。
+   *
+   * @param response 搜索返回的结果，由SearchResult保存。
+   * @throws JsonException 结果不是合法的json。
+   */
+  void parse(string response);
+
+  /**
+   * 清除所有内容
+   */
+  void clear();
+
+  /**
+   * 是否成功，即status为OK。
+   */
+  bool isOk() const {
+    return status_ == "OK";
+  }
+
+  const string& getStatus() const {
+    return status_;
+  }
+
+  const string& getRequestId() const {
+    return requestId_;
+  }
+
+  double getSearchTime() const {
+    return searchTime_;
+  }
+
+  /**
+   * 获取命中的文档总数(result.total)
+   */
+  int getTotal() const {
+    return total_;
+  }
+
+  /**
+   * 获取本次返回的文档数(result.num)
+   */
+  int getNum() const {
+    return num_;
+  }
+
+  /**
+   * 获取可以翻页的文档总数(result.viewtotal)
+   */
+  int getViewTotal() const {
+    return viewTotal_;
+  }
+
+  const std::vector<Error>& getErrors() const {
+    return errors_;
+  }
+
+  const std::vector<Facet>& getFacets() const {
+    return facets_;
+  }
+
+  /**
+   * 获取保存的原始结果
+   */
+  const string& getResponse() const {
+    return response_;
+  }
+
+  /**
+   * 获取items中的文档数
+   */
+  size_t size() const {
+    return hits_.size();
+  }
+
+  bool empty() const {
+    return hits_.empty();
+  }
+
+  /**
+   * 获取第i个文档
+   */
+  SearchHit getHit(size_t i) const {
+    return SearchHit(this, hits_[i].first, hits_[i].count);
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, hits_.size());
+  }
+
+ private:
+  friend class SearchHit;
+
+  // field positions are offsets into response_ (or names_ for names with
+  // escapes), so copies stay valid.
+  struct Field {
+    size_t name;
+    size_t nameSize;
+    size_t value;
+    size_t valueSize;
+    bool escapedName;
+  };
+
+  struct Hit {
+    size_t first;
+    size_t count;
+  };
+
+  string response_;
+  string names_;
+  string status_;
+  string requestId_;
+  double searchTime_;
+  int total_;
+  int num_;
+  int viewTotal_;
+  std::vector<Error> errors_;
+  std::vector<Facet> facets_;
+  std::vector<Field> fields_;
+  std::vector<Hit> hits_;
+};
+
+}  // namespace object
+}  // namespace opensearch
+}  // namespace aliyun
+
+#endif  // ALIYUN_OPENSEARCH_OBJECT_SEARCH_RESULT_H_
@@ -40,7 +40,7 @@ class SearchTypeEnum {
   //   assign from Value(KeyTypeEnum <= Value), explicit need DIY
   SearchTypeEnum(Value v = INVALID);
 
-  explicit SearchTypeEnum(std::string str);
+  explicit SearchTypeEnum(const std::string& str);
 
 #define IMPLEMENT_COMPARE(op) \
   bool operator op (const SearchTypeEnum& rhs) const { \
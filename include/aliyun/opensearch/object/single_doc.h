@@ -22,6 +22,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 
 namespace aliyun {
 namespace opensearch {
@@ -42,7 +43,7 @@ class SingleDoc {
   }
 
   void setCommand(string command) {
-    command_ = command;
+    command_ = std::move(command);
   }
 
   const std::map<string, string>& getFields() const {
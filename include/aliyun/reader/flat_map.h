@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_READER_FLAT_MAP_H_
+#define ALIYUN_READER_FLAT_MAP_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aliyun {
+namespace reader {
+
+// path => value pairs in one vector sorted by path.
+//
+// cheaper to fill than std::map: entries are appended while parsing and
+// sorted once at the end, lookups are binary searches.
+class FlatMap {
+ public:
+  typedef std::string string;
+  typedef std::pair<string, string> value_type;
+  typedef std::vector<value_type>::const_iterator const_iterator;
+
+  // appends without keeping order, call sort() before lookups.
+  void append(const string& key, const string& value) {
+    entries_.push_back(value_type(key, value));
+  }
+
+  // sorts by key, the later one wins for duplicated keys, like map[key].
+  void sort() {
+    std::stable_sort(entries_.begin(), entries_.end(), keyLess);
+    std::vector<value_type>::iterator out = entries_.begin();
+    for (std::vector<value_type>::iterator it = entries_.begin();
+         it != entries_.end(); ++it) {
+      if (it + 1 != entries_.end() && (it + 1)->first == it->first) {
+        continue;
+      }
+      if (out != it) {
+        out->first.swap(it->first);
+        out->second.swap(it->second);
+      }
+      ++out;
+    }
+    entries_.erase(out, entries_.end());
+  }
+
+  const_iterator find(const string& key) const {
+    const_iterator it = std::lower_bound(entries_.begin(), entries_.end(),
+                                         key, keyLessThan);
+    return it != entries_.end() && it->first == key ? it : entries_.end();
+  }
+
+  // value of `key`, `defaultValue` if not found.
+  const string& get(const string& key, const string& defaultValue) const {
+    const_iterator it = find(key);
+    return it != entries_.end() ? it->second : defaultValue;
+  }
+
+  bool contains(const string& key) const {
+    return find(key) != entries_.end();
+  }
+
+  const_iterator begin() const {
+    return entries_.begin();
+  }
+
+  const_iterator end() const {
+    return entries_.end();
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  void reserve(size_t n) {
+    entries_.reserve(n);
+  }
+
+  void clear() {
+    entries_.clear();
+  }
+
+ private:
+  static bool keyLess(const value_type& lhs, const value_type& rhs) {
+    return lhs.first < rhs.first;
+  }
+
+  static bool keyLessThan(const value_type& lhs, const string& key) {
+    return lhs.first < key;
+  }
+
+  std::vector<value_type> entries_;
+};
+
+}  // namespace reader
+}  // namespace aliyun
+
+#endif  // ALIYUN_READER_FLAT_MAP_H_
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_READER_JSON_PULL_PARSER_H_
+#define ALIYUN_READER_JSON_PULL_PARSER_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "aliyun/reader/reader.h"
+#include "aliyun/utils/string_piece.h"
+
+namespace aliyun {
+namespace reader {
+
+// pulls json events from input fed in pieces, like XmlPullParser:
+//   parser.feed(data, size);  // any number of times
+//   parser.finish();          // no more input
+//   while ((event = parser.next()) != NEED_MORE && event != END_DOCUMENT)
+//
+// only the unconsumed tail of the input is kept. input after the first
+// value is ignored. errors throw JsonException with JsonReader's messages.
+class JsonPullParser {
+ public:
+  typedef std::string string;
+  typedef utils::StringPiece StringPiece;
+
+  enum Event {
+    OBJECT_BEGIN,
+    OBJECT_END,
+    ARRAY_BEGIN,
+    ARRAY_END,
+    KEY,
+    VALUE,
+    NEED_MORE,  // feed more input, or finish()
+    END_DOCUMENT
+  };
+
+  JsonPullParser();
+
+  void reset();
+
+  // pieces returned by getText() and getRaw() are invalidated.
+  void feed(const char* data, size_t size);
+
+  void finish();
+
+  Event next();
+
+  // KEY and VALUE, strings unescaped, other values as is.
+  StringPiece getText() const {
+    return text_;
+  }
+
+  ReaderHandler::ValueType getValueType() const {
+    return type_;
+  }
+
+  // raw token of KEY and VALUE, quotes and escapes kept.
+  StringPiece getRaw() const {
+    return raw_;
+  }
+
+  // offset into the whole input just after the last event.
+  size_t getOffset() const {
+    return dropped_ + pos_;
+  }
+
+  // number of open objects and arrays.
+  size_t getDepth() const {
+    return stack_.size();
+  }
+
+ private:
+  enum State {
+    VALUE_STATE,
+    FIRST_VALUE_STATE,  // after '['
+    KEY_STATE,
+    FIRST_KEY_STATE,  // after '{'
+    COLON_STATE,
+    NEXT_STATE,  // after a value, ',' or the end of the container
+    DONE_STATE
+  };
+
+  // each read* returns false if the token is not complete yet.
+  bool readString();
+
+  bool readNumber();
+
+  bool readLiteral();
+
+  Event close(char c);
+
+ private:
+  string buffer_;
+  size_t pos_;
+  size_t dropped_;  // input dropped before buffer_
+  size_t scanned_;  // bytes after pos_ searched for the string end
+  bool finished_;
+  State state_;
+  string stack_;  // '{' and '[' of open containers
+  StringPiece text_;
+  StringPiece raw_;
+  ReaderHandler::ValueType type_;
+  string unescaped_;
+};
+
+}  // namespace reader
+}  // namespace aliyun
+
+#endif  // ALIYUN_READER_JSON_PULL_PARSER_H_
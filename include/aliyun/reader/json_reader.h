@@ -20,10 +20,15 @@
 #ifndef ALIYUN_READER_JSON_READER_H_
 #define ALIYUN_READER_JSON_READER_H_
 
+#include <stddef.h>
+
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include "aliyun/exception.h"
+#include "aliyun/reader/flat_map.h"
+#include "aliyun/reader/json_pull_parser.h"
 #include "aliyun/reader/reader.h"
 
 namespace aliyun {
@@ -32,61 +37,127 @@ namespace reader {
 class JsonException : public Exception {
  public:
   explicit JsonException(std::string msg)
-      : Exception(msg) {
+      : Exception(std::move(msg)) {
   }
 };
 
+// reads json into dotted path => value pairs, in one pass.
+//
+// paths start with `endpoint`, members are joined by '.', array items are
+// indexed on the parent path, with its last segment dropped:
+//   {"result":{"items":[{"id":"1"}]}} => endpoint.result[0].id = 1,
+//                                        endpoint.result.Length = 1
+// true and false are read as "true" and "false", null is skipped.
+//
+// the path is kept in one buffer and only copied out for each value.
+// with a ReaderHandler nothing is copied unless a string has escapes.
 class JsonReader : public Reader {
-  static std::map<char, char> escapes;
-
  public:
   typedef std::string string;
+  typedef std::unordered_map<string, string> HashMap;
+
+  JsonReader();
+
+  std::map<string, string> read(const string& response,
+                                const string& endpoint);
+
+  // same pairs into a flat vector sorted by path.
+  void read(const string& response, const string& endpoint, FlatMap* result);
+
+  // same pairs into a hash map.
+  void read(const string& response, const string& endpoint, HashMap* result);
+
+  // reads from a borrowed buffer, not required to be NUL terminated.
+  void read(const char* data, size_t size, const string& endpoint,
+            FlatMap* result);
 
-  std::map<string, string> read(string response, string endpoint);
+  bool read(const string& response, ReaderHandler* handler);
+
+  bool read(const char* data, size_t size, ReaderHandler* handler);
+
+  void begin(ReaderHandler* handler);
+
+  bool feed(const char* data, size_t size);
+
+  bool finish();
+
+  // drops the reading state for another response, as XmlReader::reset().
+  // buffers are cleared, not freed, so their memory is reused.
+  void reset();
+
+  // offset into the input while a handler is called, just after the
+  // '{', '[', '}', ']', key or value reported.
+  size_t getOffset() const {
+    return streaming_ ? pull_.getOffset() : p_ - begin_;
+  }
+
+  // raw token of the key or value reported last, quotes and escapes kept.
+  utils::StringPiece getRawValue() const {
+    return streaming_ ? pull_.getRaw() : utils::StringPiece(raw_, p_ - raw_);
+  }
+
+  // unescapes a raw string token into `out`, other tokens are copied.
+  static void unescape(const utils::StringPiece& raw, string* out);
 
  private:
-  enum Token {
-    INIT_TOKEN,
-    ARRAY_BEGIN_TOKEN,
-    ARRAY_END_TOKEN,
-    OBJECT_BEGIN_TOKEN,
-    OBJECT_END_TOKEN,
-    STRING_TOKEN,
-    NUMBER_TOKEN,
-    BOOL_TOKEN,
-    COMMA_TOKEN,
-    COLON_TOKEN,
-    TABLE_TOKEN,
-    NEWLINE_TOKEN,
-    FEED_TOKEN,
-    END_TOKEN
-  };
+  typedef void (*PutFunc)(void* result, const string& key,
+                          const string& value);
 
-  Token readJson(string baseKey);
+  void parse(const char* data, size_t size, const string& endpoint,
+             PutFunc put, void* result);
 
-  void processObject(string baseKey);
+  void parseObject();
 
-  void processList(string baseKey);
+  void parseArray(bool list);
 
-  void processArray(string baseKey);
+  bool parseScalar(string* value);
 
-  void processNumber();
+  void parseString(string* out);
 
-  void processString();
+  void parseNumber(string* out);
 
-  void addDigits();
+  const char* skipNumber();
 
-  void addChar();
+  bool walkValue(ReaderHandler* handler);
 
-  static string trimFromLast(string str, string stripString);
+  bool walkObject(ReaderHandler* handler);
 
-  void reset();
+  bool walkArray(ReaderHandler* handler);
+
+  utils::StringPiece walkString(string* scratch);
+
+  void skipValue();
+
+  void skipNested();
+
+  void expect(char c, const char* error);
+
+  void skipSpace();
+
+  bool pump();
+
+  void put(const string& value) {
+    put_(result_, path_, value);
+  }
 
  private:
-  Token token_;
-  const char* s_;
-  string stringBuffer_;
-  std::map<string, string> map_;
+  const char* begin_;
+  const char* p_;
+  const char* end_;
+  const char* raw_;  // start of the last value for handler
+  string path_;  // path of the value being parsed
+  string value_;
+  string key_;  // unescaped key for handler
+  PutFunc put_;
+  void* result_;
+
+  // fed in pieces
+  bool streaming_;
+  JsonPullParser pull_;
+  ReaderHandler* handler_;
+  size_t skipDepth_;  // open objects and arrays being skipped
+  bool skipValue_;  // the value after a skipped key
+  bool stopped_;
 };
 
 }  // namespace reader
@@ -20,19 +20,91 @@
 #ifndef ALIYUN_READER_READER_H_
 #define ALIYUN_READER_READER_H_
 
+#include <stddef.h>
+
 #include <map>
 #include <string>
 
+#include "aliyun/utils/string_piece.h"
+
 namespace aliyun {
 namespace reader {
 
+// receives events while a reader walks the response, no result is built.
+//
+// each callback returns what the reader should do next:
+//   CONTINUE - go on.
+//   SKIP     - from onKey, skip the value of the key; from onObjectBegin
+//              or onArrayBegin, skip the contents and the end event.
+//              same as CONTINUE for the others.
+//   STOP     - stop reading at once, read() returns false.
+// pieces passed in are only valid during the callback.
+class ReaderHandler {
+ public:
+  typedef utils::StringPiece StringPiece;
+
+  enum Action {
+    CONTINUE,
+    SKIP,
+    STOP
+  };
+
+  enum ValueType {
+    STRING_VALUE,
+    NUMBER_VALUE,
+    BOOL_VALUE,
+    NULL_VALUE
+  };
+
+  virtual ~ReaderHandler() {}
+
+  virtual Action onObjectBegin() {
+    return CONTINUE;
+  }
+
+  virtual Action onObjectEnd() {
+    return CONTINUE;
+  }
+
+  virtual Action onArrayBegin() {
+    return CONTINUE;
+  }
+
+  virtual Action onArrayEnd() {
+    return CONTINUE;
+  }
+
+  virtual Action onKey(const StringPiece& /* key */) {
+    return CONTINUE;
+  }
+
+  virtual Action onValue(const StringPiece& /* value */,
+                         ValueType /* type */) {
+    return CONTINUE;
+  }
+};
+
 class Reader {
  public:
   typedef std::string string;
 
   virtual ~Reader() {}
 
-  virtual std::map<string, string> read(string response, string endpoint) = 0;
+  virtual std::map<string, string> read(const string& response,
+                                        const string& endpoint) = 0;
+
+  // walks the response and reports to `handler`.
+  // returns false if stopped by the handler.
+  virtual bool read(const string& response, ReaderHandler* handler) = 0;
+
+  // same as read(response, handler) with the response fed in pieces as
+  // received. begin() starts a new response, feed() and finish() return
+  // false once stopped by the handler.
+  virtual void begin(ReaderHandler* handler) = 0;
+
+  virtual bool feed(const char* data, size_t size) = 0;
+
+  virtual bool finish() = 0;
 };
 
 }  // namespace reader
@@ -42,6 +42,11 @@ class ReaderFactory {
     }
     return NULL;
   }
+
+  // a reader kept per thread and per format, owned by the factory.
+  // it is reset for each call, so it must not be used after the next
+  // call on the same thread.
+  static Reader* getThreadInstance(FormatType format);
 };
 
 
@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_READER_READER_SINK_H_
+#define ALIYUN_READER_READER_SINK_H_
+
+#include <stddef.h>
+
+#include "aliyun/http/body_sink.h"
+#include "aliyun/reader/reader.h"
+
+namespace aliyun {
+namespace reader {
+
+// parses the response body with `reader` while it is received:
+//   ReaderSink sink(reader, &handler);
+//   request.setBodySink(&sink);
+// a parse error aborts the transfer and is thrown to the caller.
+class ReaderSink : public http::BodySink {
+ public:
+  ReaderSink(Reader* reader, ReaderHandler* handler)
+      : reader_(reader),
+        handler_(handler) {
+  }
+
+  void onBegin() {
+    reader_->begin(handler_);
+  }
+
+  void onData(const char* data, size_t size) {
+    reader_->feed(data, size);
+  }
+
+  void onEnd() {
+    reader_->finish();
+  }
+
+ private:
+  Reader* reader_;
+  ReaderHandler* handler_;
+};
+
+}  // namespace reader
+}  // namespace aliyun
+
+#endif  // ALIYUN_READER_READER_SINK_H_
@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_READER_XML_PULL_PARSER_H_
+#define ALIYUN_READER_XML_PULL_PARSER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "aliyun/utils/string_piece.h"
+
+namespace aliyun {
+namespace reader {
+
+// pulls xml events from input fed in pieces, without building a tree:
+//   parser.feed(data, size);  // any number of times
+//   parser.finish();          // no more input
+//   while ((event = parser.next()) != NEED_MORE && event != END_DOCUMENT)
+//
+// only the unconsumed tail of the input is kept. text may come in several
+// TEXT events, entities and CDATA are decoded. attributes, comments,
+// processing instructions and the doctype are skipped. errors throw
+// XmlException.
+class XmlPullParser {
+ public:
+  typedef std::string string;
+  typedef utils::StringPiece StringPiece;
+
+  enum Event {
+    START_ELEMENT,
+    END_ELEMENT,
+    TEXT,
+    NEED_MORE,  // feed more input, or finish()
+    END_DOCUMENT
+  };
+
+  XmlPullParser();
+
+  void reset();
+
+  // pieces returned by getName() and getText() are invalidated.
+  void feed(const char* data, size_t size);
+
+  void finish();
+
+  Event next();
+
+  // element name of START_ELEMENT and END_ELEMENT, with its prefix.
+  StringPiece getName() const {
+    return name_;
+  }
+
+  // decoded text of TEXT.
+  StringPiece getText() const {
+    return text_;
+  }
+
+  // number of open elements.
+  size_t getDepth() const {
+    return openStarts_.size();
+  }
+
+ private:
+  // each read* consumes one token, returns true with `event` set when it
+  // is to be reported, false to go on.
+  bool readText(const char* p, const char* end, Event* event);
+
+  bool readMarkup(const char* p, const char* end, Event* event);
+
+  bool readStartTag(const char* p, const char* end, Event* event);
+
+  bool readEndTag(const char* p, const char* end, Event* event);
+
+  const char* find(const char* p, const char* end, const char* term);
+
+  bool needMore(Event* event);
+
+  void decode(const char* p, const char* end);
+
+ private:
+  string buffer_;
+  size_t pos_;
+  size_t scanned_;  // bytes after pos_ searched for the token end
+  bool finished_;
+  bool rootSeen_;
+  bool pendingEnd_;  // after an empty element tag
+  string openNames_;
+  std::vector<size_t> openStarts_;
+  StringPiece name_;
+  StringPiece text_;
+  string decoded_;
+};
+
+}  // namespace reader
+}  // namespace aliyun
+
+#endif  // ALIYUN_READER_XML_PULL_PARSER_H_
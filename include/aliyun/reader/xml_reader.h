@@ -27,6 +27,7 @@
 
 #include "aliyun/exception.h"
 #include "aliyun/reader/reader.h"
+#include "aliyun/reader/xml_pull_parser.h"
 
 namespace aliyun {
 namespace reader {
@@ -34,7 +35,7 @@ namespace reader {
 class XmlException : public aliyun::Exception {
  public:
   explicit XmlException(std::string msg)
-      : aliyun::Exception(msg) {
+      : aliyun::Exception(std::move(msg)) {
   }
 };
 
@@ -48,41 +49,73 @@ class XmlReader : public Reader {
 
   ~XmlReader();
 
-  apr_xml_doc * getDocument(string xml);
+  // the document is valid till the next getDocument() or reset().
+  apr_xml_doc * getDocument(const string& xml);
+
+  // releases the document and the reading state for another response.
+  // the pool is cleared, not destroyed, so its memory is reused.
+  void reset();
 
   static string getContent(node* n);
 
-  static const char * getAttribute(node* n, string name);
+  static const char * getAttribute(node* n, const string& name);
+
+  static std::vector<node*> getElementsByTagName(document* doc,
+                                                 const string& tag);
+
+  static std::vector<node*> getElementsByTagName(node* curr,
+                                                 const string& tag);
+
+  std::map<string, string> read(const string& response,
+                                const string& endpoint);
 
-  static std::vector<node*> getElementsByTagName(document* doc, string tag);
+  // elements with children are reported as objects, others as string
+  // values, attributes are ignored. there is no array in xml, repeated
+  // elements are reported as repeated keys.
+  bool read(const string& response, ReaderHandler* handler);
 
-  static std::vector<node*> getElementsByTagName(node* curr, string tag);
+  // same events, reported as the response is fed in pieces:
+  //   reader.begin(handler);
+  //   reader.feed(data, size);  // for each piece received
+  //   reader.finish();
+  // feed() and finish() return false once the handler stopped.
+  void begin(ReaderHandler* handler);
 
-  std::map<string, string> read(string response, string endpoint);
+  bool feed(const char* data, size_t size);
+
+  bool finish();
 
   void dump();
 
   static std::vector<apr_xml_elem*> getChildElements(apr_xml_elem* parent);
 
   static std::vector<apr_xml_elem*> getChildElements(apr_xml_elem* parent,
-                                                     string tagName);
+                                                     const string& tagName);
 
  private:
+  class PathBuilder;
+
   static void dumpElements(apr_xml_elem* e, int depth);
 
   void prepareParser();
 
-  void read(apr_xml_elem* element, string path, bool appendPath);
+  bool pump();
 
-  string buildPath(apr_xml_elem* element, const string& path, bool appendPath);
+  bool startElement();
 
-  void elementsAsList(std::vector<apr_xml_elem*>* elems, string path);
+  bool endElement();
 
  private:
-  std::map<string, string> map_;
   apr_pool_t* pool_;
   apr_xml_doc* pdoc_;
   apr_xml_parser* parser_;
+
+  XmlPullParser pull_;
+  ReaderHandler* handler_;
+  std::vector<bool> open_;  // whether each open element has a child
+  string text_;
+  size_t skipDepth_;  // open elements being skipped
+  bool stopped_;
 };
 
 }  // namespace reader
@@ -36,9 +36,11 @@ class Base64Helper {
 
   static std::string encode(const byte* buffer, int length);
 
-  static std::string encode(std::string str, std::string encoding);
+  static std::string encode(const std::string& str,
+                            const std::string& encoding);
 
-  static std::string decode(std::string str, std::string encoding);
+  static std::string decode(const std::string& str,
+                            const std::string& encoding);
 
  private:
   static const char BASE64_CODE[];
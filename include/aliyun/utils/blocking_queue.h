@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_UTILS_BLOCKING_QUEUE_H_
+#define ALIYUN_UTILS_BLOCKING_QUEUE_H_
+
+#include <stddef.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace aliyun {
+namespace utils {
+
+// bounded multi-producer multi-consumer queue for pipeline stages.
+template<typename T>
+class BlockingQueue {
+ public:
+  explicit BlockingQueue(size_t capacity)
+      : capacity_(capacity > 0 ? capacity : 1),
+        closed_(false) {
+  }
+
+  // block while full, return false if queue closed.
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!closed_ && queue_.size() >= capacity_) {
+      notFull_.wait(lock);
+    }
+    if (closed_) {
+      return false;
+    }
+    queue_.push_back(std::move(item));
+    notEmpty_.notify_one();
+    return true;
+  }
+
+  // block while empty, return false if queue closed and drained.
+  bool pop(T* item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!closed_ && queue_.empty()) {
+      notEmpty_.wait(lock);
+    }
+    if (queue_.empty()) {
+      return false;
+    }
+    *item = std::move(queue_.front());
+    queue_.pop_front();
+    notFull_.notify_one();
+    return true;
+  }
+
+  // no more push, consumers drain what is left.
+  void close() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    closed_ = true;
+    notEmpty_.notify_all();
+    notFull_.notify_all();
+  }
+
+  // drop what is left and accept pushes again, only while nobody waits.
+  void reopen() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    queue_.clear();
+    closed_ = false;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return queue_.size();
+  }
+
+ private:
+  // noncopyable.
+  BlockingQueue& operator=(const BlockingQueue& rhs);
+  BlockingQueue(const BlockingQueue& rhs);
+
+  mutable std::mutex mutex_;
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+  std::deque<T> queue_;
+  size_t capacity_;
+  bool closed_;
+};
+
+}  // namespace utils
+}  // namespace aliyun
+
+#endif  // ALIYUN_UTILS_BLOCKING_QUEUE_H_
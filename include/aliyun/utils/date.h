@@ -26,7 +26,7 @@
 namespace aliyun {
 namespace utils {
 
-// depends on time.h, no guarantee to ensure thread safety
+// a point in time and its broken-down time, reentrant.
 class Date {
  public:
   static const int kNumMonth = 12;
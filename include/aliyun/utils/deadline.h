@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_UTILS_DEADLINE_H_
+#define ALIYUN_UTILS_DEADLINE_H_
+
+#include <chrono>
+
+namespace aliyun {
+namespace utils {
+
+// absolute point in time a call must finish before.
+//
+// based on monotonic clock, not affected by system time changes.
+// a default constructed deadline never expires.
+class Deadline {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  Deadline();
+
+  // deadline `millis` milliseconds from now.
+  static Deadline after(long millis);
+
+  bool isSet() const {
+    return set_;
+  }
+
+  bool expired() const;
+
+  // milliseconds left, 0 if expired, -1 if not set.
+  long remainingMillis() const;  // long: follow libcurl
+
+  // the earlier one of two deadlines.
+  static Deadline min(const Deadline& lhs, const Deadline& rhs);
+
+ private:
+  Clock::time_point at_;
+  bool set_;
+};
+
+}  // namespace utils
+}  // namespace aliyun
+
+#endif  // ALIYUN_UTILS_DEADLINE_H_
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_UTILS_GZIP_HELPER_H_
+#define ALIYUN_UTILS_GZIP_HELPER_H_
+
+#include <stddef.h>
+#include <string>
+
+#include "aliyun/exception.h"
+
+struct z_stream_s;  // zlib
+
+namespace aliyun {
+namespace utils {
+
+class GzipException : public Exception {
+ public:
+  explicit GzipException(std::string msg)
+      : Exception(std::move(msg)) {
+  }
+};
+
+// incremental decoder for gzip/zlib/raw deflate streams.
+//
+// compressed data can be fed in pieces of any size (e.g. as received from
+// network), decoded data is appended to output immediately.
+class GzipInflater {
+ public:
+  GzipInflater();
+
+  ~GzipInflater();
+
+  // decode `length` bytes of compressed data, append result to `out`.
+  void inflate(const char* data, size_t length, std::string* out);
+
+  // whether the end of compressed stream has been reached.
+  bool finished() const {
+    return finished_;
+  }
+
+  // whether zlib is compiled in, GzipInflater throws when it is not.
+  static bool isSupported();
+
+ private:
+  int feed(const char* data, size_t length, std::string* out);
+
+  // noncopyable.
+  GzipInflater& operator=(const GzipInflater& rhs);
+  GzipInflater(const GzipInflater& rhs);
+
+  z_stream_s* stream_;
+  std::string head_;  // input kept until format detected
+  bool detected_;
+  bool raw_;
+  bool finished_;
+};
+
+class GzipHelper {
+ public:
+  static const int DEFAULT_LEVEL = 6;  // same as gzip(1)
+
+  // compress `data` to gzip format.
+  static std::string compress(const std::string& data,
+                              int level = DEFAULT_LEVEL);
+
+  // decompress gzip, zlib or raw deflate `data`.
+  static std::string decompress(const std::string& data);
+
+  // whether zlib is compiled in, compress and decompress throw when it is not.
+  static bool isSupported();
+};
+
+}  // namespace utils
+}  // namespace aliyun
+
+#endif  // ALIYUN_UTILS_GZIP_HELPER_H_
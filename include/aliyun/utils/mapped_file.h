@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_UTILS_MAPPED_FILE_H_
+#define ALIYUN_UTILS_MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "aliyun/exception.h"
+#include "aliyun/utils/string_piece.h"
+
+namespace aliyun {
+namespace utils {
+
+// read-only memory mapping of a whole file.
+//
+// the mapping is released on destruction, slices taken from it
+// must not outlive the MappedFile.
+class MappedFile {
+ public:
+  // throws aliyun::Exception if the file can not be opened or mapped.
+  explicit MappedFile(const std::string& path) throw(aliyun::Exception);
+
+  ~MappedFile();
+
+  // NULL for empty file.
+  const char* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  StringPiece piece() const {
+    return StringPiece(data_, size_);
+  }
+
+  // last modification time when mapped, seconds since the epoch.
+  int64_t mtime() const {
+    return mtime_;
+  }
+
+ private:
+  // noncopyable.
+  MappedFile& operator=(const MappedFile& rhs);
+  MappedFile(const MappedFile& rhs);
+
+  const char* data_;
+  size_t size_;
+  int64_t mtime_;
+};
+
+}  // namespace utils
+}  // namespace aliyun
+
+#endif  // ALIYUN_UTILS_MAPPED_FILE_H_
@@ -32,7 +32,7 @@ namespace utils {
 class ParseDateException : public Exception {
  public:
   explicit ParseDateException(std::string msg)
-      : Exception(msg) {
+      : Exception(std::move(msg)) {
   }
 };
 
@@ -41,23 +41,27 @@ class ParameterHelper {
   typedef unsigned char byte;
   typedef std::string string;
 
-  static std::string md5hex(std::string str);
+  static std::string md5hex(const std::string& str);
 
-  static std::string md5Sum(std::string str);
+  static std::string md5Sum(const std::string& str);
 
+  // digest is kept per thread until the next call of the same thread.
   static byte * md5(const byte* data, size_t len);
 
+  static void md5(const byte* data, size_t len, byte digest[16]);
+
+  // thread-safe.
   static string getUUID();
 
   static string getISO8601Date(Date date);
 
   static string getRFC2616Date(Date date);
 
-  static Date parse(string strDate);
+  static Date parse(const string& strDate);
 
-  static Date parseISO8601(string strDate);
+  static Date parseISO8601(const string& strDate);
 
-  static Date parseRFC2616(string strDate);
+  static Date parseRFC2616(const string& strDate);
 };
 
 }  // namespace utils
@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_UTILS_RATE_LIMITER_H_
+#define ALIYUN_UTILS_RATE_LIMITER_H_
+
+#include <stddef.h>
+
+#include <chrono>
+#include <mutex>
+
+namespace aliyun {
+namespace utils {
+
+// token bucket limiting requests per second and bytes per second.
+//
+// based on monotonic clock. each acquire reserves the earliest slot both
+// buckets allow under the lock and sleeps outside of it, so concurrent
+// callers are served in order and the rate holds across threads.
+// each bucket saves up to `burstSeconds` of its rate while unused, so a
+// late caller or a pause between batches is made up for afterwards and
+// the long-run rate stays at the quota. 0 paces sends at exactly the rate.
+// a request larger than the bucket is allowed once it is full, the
+// following ones wait for it to be paid back.
+//
+// a rate <= 0 means unlimited.
+class RateLimiter {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  static const double DEFAULT_BURST_SECONDS;  // 1 second of rate
+
+  // where time is read and waited for, replaceable in tests.
+  // the default one uses Clock and sleeps the calling thread.
+  class TimeSource {
+   public:
+    virtual ~TimeSource() {}
+
+    virtual Clock::time_point now();
+
+    virtual void sleepUntil(Clock::time_point at);
+  };
+
+  explicit RateLimiter(double requestsPerSecond, double bytesPerSecond = 0,
+                       double burstSeconds = DEFAULT_BURST_SECONDS);
+
+  // blocks until one request of `bytes` may be sent.
+  // returns milliseconds waited.
+  long acquire(size_t bytes = 0);  // long: same as Deadline
+
+  // takes the slot only if no wait is needed.
+  bool tryAcquire(size_t bytes = 0);
+
+  // milliseconds the next acquire would wait now.
+  long getWaitMillis() const;
+
+  // total milliseconds callers waited in acquire.
+  long getTotalWaitMillis() const;
+
+  void setRate(double requestsPerSecond, double bytesPerSecond = 0);
+
+  double getRequestsPerSecond() const;
+
+  double getBytesPerSecond() const;
+
+  void setBurstSeconds(double burstSeconds);
+
+  double getBurstSeconds() const;
+
+  // NULL for the default one. the time source must outlive the limiter,
+  // set it before the limiter is shared.
+  void setTimeSource(TimeSource* timeSource);
+
+ private:
+  // earliest time a request of `bytes` may be sent, lock held.
+  Clock::time_point readyAt(Clock::time_point now, size_t bytes) const;
+
+  // take the slot at `at`, lock held.
+  void reserve(Clock::time_point at, size_t bytes);
+
+  // noncopyable.
+  RateLimiter& operator=(const RateLimiter& rhs);
+  RateLimiter(const RateLimiter& rhs);
+
+  mutable std::mutex mutex_;
+  double requestsPerSecond_;
+  double bytesPerSecond_;
+  Clock::duration burst_;
+  // the bucket is empty until then, paid off time of all reservations.
+  Clock::time_point requestsPaid_;
+  Clock::time_point bytesPaid_;
+  Clock::duration totalWait_;
+  TimeSource* timeSource_;
+};
+
+}  // namespace utils
+}  // namespace aliyun
+
+#endif  // ALIYUN_UTILS_RATE_LIMITER_H_
@@ -0,0 +1,143 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALIYUN_UTILS_STRING_PIECE_H_
+#define ALIYUN_UTILS_STRING_PIECE_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#include <string>
+
+namespace aliyun {
+namespace utils {
+
+// non-owning slice of characters, like std::string_view in C++17.
+// the referenced buffer must outlive the piece.
+class StringPiece {
+ public:
+  typedef const char* const_iterator;
+
+  static const size_t npos = static_cast<size_t>(-1);
+
+  StringPiece()
+      : data_(NULL),
+        size_(0) {
+  }
+
+  StringPiece(const char* data, size_t size)
+      : data_(data),
+        size_(size) {
+  }
+
+  // implicit for convenience, like std::string_view.
+  StringPiece(const char* str)
+      : data_(str),
+        size_(str ? ::strlen(str) : 0) {
+  }
+
+  StringPiece(const std::string& str)
+      : data_(str.data()),
+        size_(str.size()) {
+  }
+
+  const char* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  size_t length() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  const_iterator begin() const {
+    return data_;
+  }
+
+  const_iterator end() const {
+    return data_ + size_;
+  }
+
+  char operator[](size_t i) const {
+    return data_[i];
+  }
+
+  size_t find(char c, size_t pos = 0) const {
+    if (pos >= size_) {
+      return npos;
+    }
+    const void* p = ::memchr(data_ + pos, c, size_ - pos);
+    return p ? static_cast<const char*>(p) - data_ : npos;
+  }
+
+  StringPiece substr(size_t pos, size_t n = npos) const {
+    if (pos > size_) {
+      pos = size_;
+    }
+    if (n > size_ - pos) {
+      n = size_ - pos;
+    }
+    return StringPiece(data_ + pos, n);
+  }
+
+  int compare(const StringPiece& rhs) const {
+    size_t n = size_ < rhs.size_ ? size_ : rhs.size_;
+    int r = n ? ::memcmp(data_, rhs.data_, n) : 0;
+    if (r == 0) {
+      r = size_ < rhs.size_ ? -1 : (size_ > rhs.size_ ? 1 : 0);
+    }
+    return r;
+  }
+
+  void appendTo(std::string* out) const {
+    out->append(data_, size_);
+  }
+
+  std::string toString() const {
+    return std::string(data_, size_);
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
+inline bool operator==(const StringPiece& lhs, const StringPiece& rhs) {
+  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+}
+
+inline bool operator!=(const StringPiece& lhs, const StringPiece& rhs) {
+  return !(lhs == rhs);
+}
+
+inline bool operator<(const StringPiece& lhs, const StringPiece& rhs) {
+  return lhs.compare(rhs) < 0;
+}
+
+}  // namespace utils
+}  // namespace aliyun
+
+#endif  // ALIYUN_UTILS_STRING_PIECE_H_
@@ -37,8 +37,9 @@ namespace aliyun {
 namespace utils {
 namespace StringUtils {  // string utility functions
 
-bool RegexMatch(std::string str, std::string pat);
+bool RegexMatch(const std::string& str, const std::string& pat);
 
+// `str` is changed in place and returned, pass an rvalue to save the copy.
 std::string ToLowerCase(std::string str);
 
 std::string ToUpperCase(std::string str);
@@ -51,9 +52,9 @@ std::string ToString(T t) {
 }
 
 // TODO(xu): string encoding convert
-std::string ToEncoding(std::string src, std::string encoding);
+std::string ToEncoding(std::string src, const std::string& encoding);
 
-std::string hexString(std::string src, bool caps = true);
+std::string hexString(const std::string& src, bool caps = true);
 
 std::string hexDump(void* ptr, int len, bool caps = true);
 
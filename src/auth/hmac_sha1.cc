@@ -25,9 +25,8 @@
 namespace aliyun {
 namespace auth {
 
-HmacSha1* HmacSha1::sInstance_ = NULL;
-
-std::string HmacSha1::signString(std::string source, std::string accessSecret)
+std::string HmacSha1::signString(const std::string& source,
+                                 const std::string& accessSecret)
                                      throw(aliyun::Exception) {
   unsigned char hmac[DIGEST_LENTH];
   HMAC_SHA1(hmac, reinterpret_cast<const unsigned char*>(accessSecret.c_str()),
@@ -40,16 +39,29 @@ std::string HmacSha1::signString(std::string source, std::string accessSecret)
 void HmacSha1::HMAC_SHA1(unsigned char hmac[20], const unsigned char *key,
                          int key_len, const unsigned char *message,
                          int message_len) {
-  unsigned char kopad[64], kipad[64];
-  int i;
-  unsigned char digest[APR_SHA1_DIGESTSIZE];
-  apr_sha1_ctx_t context;
+  HmacSha1Key keyed(std::string(reinterpret_cast<const char*>(key), key_len));
+  keyed.sign(reinterpret_cast<const char*>(message), message_len, hmac);
+}
 
-  if (key_len > 64) {
-    key_len = 64;
-  }
+HmacSha1* HmacSha1::getInstance() {
+  static HmacSha1 stub;  // initialized once, thread-safe
+  return &stub;
+}
+
+std::string HmacSha1::getSignerName() {
+  return "HMAC-SHA1";
+}
+
+std::string HmacSha1::getSignerVersion() {
+  return "1.0";
+}
 
-  for (i = 0; i < key_len; i++) {
+HmacSha1Key::HmacSha1Key(const std::string& key) {
+  unsigned char kopad[64], kipad[64];
+  size_t keyLen = key.length() > 64 ? 64 : key.length();
+  size_t i;
+
+  for (i = 0; i < keyLen; i++) {
     kopad[i] = key[i] ^ 0x5c;
     kipad[i] = key[i] ^ 0x36;
   }
@@ -59,31 +71,28 @@ void HmacSha1::HMAC_SHA1(unsigned char hmac[20], const unsigned char *key,
     kipad[i] = 0 ^ 0x36;
   }
 
-  apr_sha1_init(&context);
-  apr_sha1_update(&context, (const char *) kipad, 64);
-  apr_sha1_update(&context, (const char *) message, (unsigned int) message_len);
-  apr_sha1_final(digest, &context);
-
-  apr_sha1_init(&context);
-  apr_sha1_update(&context, (const char *) kopad, 64);
-  apr_sha1_update(&context, (const char *) digest, 20);
-  apr_sha1_final(hmac, &context);
+  apr_sha1_init(&inner_);
+  apr_sha1_update(&inner_, (const char *) kipad, 64);
+  apr_sha1_init(&outer_);
+  apr_sha1_update(&outer_, (const char *) kopad, 64);
 }
 
-HmacSha1* HmacSha1::getInstance() {
-  if (sInstance_ == NULL) {
-    static HmacSha1 stub;
-    sInstance_ = &stub;
-  }
-  return sInstance_;
-}
+void HmacSha1Key::sign(const char* message, size_t size,
+                       unsigned char hmac[HmacSha1::DIGEST_LENTH]) const {
+  unsigned char digest[APR_SHA1_DIGESTSIZE];
+  apr_sha1_ctx_t context = inner_;
+  apr_sha1_update(&context, message, (unsigned int) size);
+  apr_sha1_final(digest, &context);
 
-std::string HmacSha1::getSignerName() {
-  return "HMAC-SHA1";
+  context = outer_;
+  apr_sha1_update(&context, (const char *) digest, APR_SHA1_DIGESTSIZE);
+  apr_sha1_final(hmac, &context);
 }
 
-std::string HmacSha1::getSignerVersion() {
-  return "1.0";
+std::string HmacSha1Key::signString(const std::string& message) const {
+  unsigned char hmac[HmacSha1::DIGEST_LENTH];
+  sign(message.data(), message.size(), hmac);
+  return utils::Base64Helper::encode(hmac, HmacSha1::DIGEST_LENTH);
 }
 
 }  // namespace auth
@@ -30,8 +30,6 @@ namespace aliyun {
 
 namespace auth {
 
-HmacSha256* HmacSha256::sInstance_ = NULL;
-
 HmacSha256::HmacSha256()
     : pool_(NULL),
       hash_(NULL) {
@@ -53,7 +51,8 @@ HmacSha256::~HmacSha256() {
   }
 }
 
-std::string HmacSha256::signString(std::string source, std::string accessSecret)
+std::string HmacSha256::signString(const std::string& source,
+                                   const std::string& accessSecret)
                                        throw(aliyun::Exception) {
   unsigned char hmac[DIGEST_LENTH];
   HMAC_SHA256(hmac,
@@ -85,6 +84,7 @@ void HmacSha256::HMAC_SHA256(unsigned char hmac[32], const unsigned char *key,
     kipad[i] = 0 ^ 0x36;
   }
 
+  std::lock_guard<std::mutex> guard(mutex_);
   hash_->init(hash_);
   hash_->add(hash_, (const char *) kipad, 64);
   hash_->add(hash_, (const char *) message, (unsigned int) message_len);
@@ -97,11 +97,8 @@ void HmacSha256::HMAC_SHA256(unsigned char hmac[32], const unsigned char *key,
 }
 
 HmacSha256* HmacSha256::getInstance() {
-  if (sInstance_ == NULL) {
-    static HmacSha256 stub;
-    sInstance_ = &stub;
-  }
-  return sInstance_;
+  static HmacSha256 stub;  // initialized once, thread-safe
+  return &stub;
 }
 
 std::string HmacSha256::getSignerName() {
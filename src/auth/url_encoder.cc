@@ -17,51 +17,79 @@
  * under the License.
  */
 
-
 #include "aliyun/auth/url_encoder.h"
 
+#include <string.h>
+
 namespace aliyun {
 
 namespace auth {
 
-UrlEncoder *UrlEncoder::sInstance_ = NULL;
+// 1 for bytes kept as is: ALPHA / DIGIT / "-" / "." / "_" / "~".
+static const unsigned char UNRESERVED[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x00
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x10
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0,  // 0x20 - .
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,  // 0x30 0-9
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0x40 A-O
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,  // 0x50 P-Z _
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0x60 a-o
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0,  // 0x70 p-z ~
+  // 0x80 - 0xff are all encoded.
+};
+
+static const char HEX[] = "0123456789ABCDEF";
 
-UrlEncoder::UrlEncoder()
-    : curl_(NULL),
-      uri_(NULL) {
-  curl_ = curl_easy_init();
+UrlEncoder::UrlEncoder() {
 }
 
 UrlEncoder::~UrlEncoder() {
-  curl_easy_cleanup(curl_);
-  curl_free(uri_);
 }
 
-UrlEncoder::string UrlEncoder::encodeString(string input) {
-  if (input.length() == 0) {
-    return "";
-  }
-  char* uri = curl_easy_escape(curl_, input.c_str(), input.length());
-  updateUri(uri);
-  return uri;
+UrlEncoder::string UrlEncoder::encodeString(const string& input) {
+  return encode(input);
 }
 
-UrlEncoder *UrlEncoder::getInstance() {
-  if (sInstance_ == NULL) {
-    static UrlEncoder stub;
-    sInstance_ = &stub;
+void UrlEncoder::appendEncoded(const char* data, size_t size, string* out) {
+  size_t offset = out->size();
+  out->resize(offset + encodedLength(data, size));
+  char* p = &(*out)[0] + offset;
+
+  const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+  const unsigned char* end = in + size;
+  while (in < end) {
+    // copy runs of plain bytes at once, json is mostly plain.
+    const unsigned char* run = in;
+    while (in < end && UNRESERVED[*in]) {
+      in++;
+    }
+    if (in > run) {
+      ::memcpy(p, run, in - run);
+      p += in - run;
+    }
+    if (in < end) {
+      p[0] = '%';
+      p[1] = HEX[*in >> 4];
+      p[2] = HEX[*in & 0x0F];
+      p += 3;
+      in++;
+    }
   }
-  return sInstance_;
 }
 
-void UrlEncoder::updateUri(char* uri) {
-  if (NULL != uri_) {
-    curl_free(uri_);
+size_t UrlEncoder::encodedLength(const char* data, size_t size) {
+  const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+  size_t length = size;
+  for (size_t i = 0; i < size; i++) {
+    length += UNRESERVED[in[i]] ? 0 : 2;  // %XX
   }
-  uri_ = uri;
+  return length;
 }
 
-}  // namespace auth
+UrlEncoder *UrlEncoder::getInstance() {
+  static UrlEncoder stub;  // initialized once, thread-safe
+  return &stub;
+}
 
+}  // namespace auth
 }  // namespace aliyun
-
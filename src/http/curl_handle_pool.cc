@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/http/curl_handle_pool.h"
+#include "aliyun/http/http_request.h"
+#include "aliyun/utils/details/global_initializer.h"
+
+namespace aliyun {
+namespace http {
+
+const size_t CurlHandlePool::DEFAULT_MAX_IDLE_HANDLES;
+
+CurlHandlePool::CurlHandlePool(size_t maxIdleHandles)
+    : maxIdleHandles_(maxIdleHandles) {
+}
+
+CurlHandlePool::~CurlHandlePool() {
+  for (size_t i = 0; i < idle_.size(); i++) {
+    curl_easy_cleanup(idle_[i]);
+  }
+  idle_.clear();
+}
+
+CURL* CurlHandlePool::acquire() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!idle_.empty()) {
+      // LIFO, the most recently used handle most likely has a live connection.
+      CURL* curl = idle_.back();
+      idle_.pop_back();
+      return curl;
+    }
+  }
+
+  CURL* curl = curl_easy_init();
+  if (NULL == curl) {
+    throw CurlException("curl init fail");
+  }
+  return curl;
+}
+
+void CurlHandlePool::release(CURL* curl) {
+  if (NULL == curl) {
+    return;
+  }
+
+  // drop options of last request, keeps live connections and caches.
+  curl_easy_reset(curl);
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (idle_.size() < maxIdleHandles_) {
+      idle_.push_back(curl);
+      return;
+    }
+  }
+  curl_easy_cleanup(curl);
+}
+
+void CurlHandlePool::setMaxIdleHandles(size_t maxIdleHandles) {
+  std::vector<CURL*> extras;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    maxIdleHandles_ = maxIdleHandles;
+    if (idle_.size() > maxIdleHandles_) {
+      // the oldest idle handles are at front.
+      size_t excess = idle_.size() - maxIdleHandles_;
+      extras.assign(idle_.begin(), idle_.begin() + excess);
+      idle_.erase(idle_.begin(), idle_.begin() + excess);
+    }
+  }
+  for (size_t i = 0; i < extras.size(); i++) {
+    curl_easy_cleanup(extras[i]);
+  }
+}
+
+size_t CurlHandlePool::getMaxIdleHandles() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return maxIdleHandles_;
+}
+
+size_t CurlHandlePool::getIdleHandles() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return idle_.size();
+}
+
+}  // namespace http
+}  // namespace aliyun
@@ -47,7 +47,7 @@ std::string FormatType::mapFormatToAccept(FormatType format) {
   return "application/octet-stream";
 }
 
-FormatType FormatType::mapAcceptToFormat(std::string accept) {
+FormatType FormatType::mapAcceptToFormat(const std::string& accept) {
   if (strncasecmp(accept.c_str(), "application/xml",
                     sizeof("application/xml")) == 0
       || strncasecmp(accept.c_str(), "text/xml", sizeof("text/xml")) == 0)
@@ -0,0 +1,154 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/http/header_store.h"
+
+namespace aliyun {
+namespace http {
+
+using utils::StringPiece;
+
+static const size_t MIN_BUCKETS = 32;
+
+static const char* const HOT_HEADERS[] = {
+  "Content-Type",
+  "Content-Length",
+  "Content-Encoding",
+  "Connection"
+};
+
+static inline char toLower(char c) {
+  return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+HeaderStore::HeaderStore()
+    : buckets_(MIN_BUCKETS, -1) {
+  for (int i = 0; i < OTHER_HEADER; i++) {
+    hot_[i] = -1;
+  }
+}
+
+void HeaderStore::clear() {
+  buffer_.clear();
+  entries_.clear();
+  buckets_.assign(buckets_.size(), -1);
+  for (int i = 0; i < OTHER_HEADER; i++) {
+    hot_[i] = -1;
+  }
+}
+
+HeaderStore::HotHeader HeaderStore::add(const StringPiece& name,
+                                        const StringPiece& value) {
+  size_t h = hash(name);
+  size_t bucket = probe(name, h);
+  int index = buckets_[bucket];
+  if (index >= 0) {
+    // replaced, the old value is left unused in the buffer.
+    entries_[index].value = buffer_.size();
+    entries_[index].valueSize = value.size();
+    value.appendTo(&buffer_);
+  } else {
+    Entry entry;
+    entry.name = buffer_.size();
+    entry.nameSize = name.size();
+    name.appendTo(&buffer_);
+    entry.value = buffer_.size();
+    entry.valueSize = value.size();
+    value.appendTo(&buffer_);
+    entry.hash = h;
+
+    index = static_cast<int>(entries_.size());
+    entries_.push_back(entry);
+    buckets_[bucket] = index;
+    if (entries_.size() * 2 > buckets_.size()) {
+      rehash(buckets_.size() * 2);
+    }
+  }
+
+  for (int i = 0; i < OTHER_HEADER; i++) {
+    if (equalsIgnoreCase(name, HOT_HEADERS[i])) {
+      hot_[i] = index;
+      return static_cast<HotHeader>(i);
+    }
+  }
+  return OTHER_HEADER;
+}
+
+StringPiece HeaderStore::get(const StringPiece& name) const {
+  int index = find(name);
+  return index < 0 ? StringPiece() : getValue(index);
+}
+
+bool HeaderStore::equalsIgnoreCase(const StringPiece& lhs,
+                                   const StringPiece& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.size(); i++) {
+    if (toLower(lhs[i]) != toLower(rhs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// FNV-1a of the lowercased name.
+size_t HeaderStore::hash(const StringPiece& name) {
+  size_t h = 2166136261u;
+  for (size_t i = 0; i < name.size(); i++) {
+    h ^= static_cast<unsigned char>(toLower(name[i]));
+    h *= 16777619u;
+  }
+  return h;
+}
+
+int HeaderStore::find(const StringPiece& name) const {
+  return buckets_[probe(name, hash(name))];
+}
+
+size_t HeaderStore::probe(const StringPiece& name, size_t h) const {
+  size_t mask = buckets_.size() - 1;
+  size_t bucket = h & mask;
+  for (;;) {
+    int index = buckets_[bucket];
+    if (index < 0) {
+      return bucket;
+    }
+    const Entry& entry = entries_[index];
+    if (entry.hash == h && equalsIgnoreCase(getName(index), name)) {
+      return bucket;
+    }
+    bucket = (bucket + 1) & mask;
+  }
+}
+
+void HeaderStore::rehash(size_t buckets) {
+  buckets_.assign(buckets, -1);
+  size_t mask = buckets - 1;
+  for (size_t i = 0; i < entries_.size(); i++) {
+    size_t bucket = entries_[i].hash & mask;
+    while (buckets_[bucket] >= 0) {
+      bucket = (bucket + 1) & mask;
+    }
+    buckets_[bucket] = static_cast<int>(i);
+  }
+}
+
+}  // namespace http
+}  // namespace aliyun
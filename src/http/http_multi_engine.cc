@@ -0,0 +1,235 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/http/http_multi_engine.h"
+
+#include <memory>
+#include <set>
+
+#include "aliyun/http/curl_handle_pool.h"
+#include "aliyun/http/details/http_transaction.h"
+#include "aliyun/utils/details/global_initializer.h"
+
+namespace aliyun {
+namespace http {
+
+// libcurl older than 7.68.0 has no curl_multi_wakeup, poll in short interval.
+#if LIBCURL_VERSION_NUM >= 0x074400
+#define ALIYUN_HAVE_MULTI_WAKEUP 1
+static const int POLL_TIMEOUT_MS = 1000;
+#else
+static const int POLL_TIMEOUT_MS = 10;
+#endif
+
+struct HttpMultiEngine::Transfer {
+  HttpRequest request;
+  HttpResponse response;
+  CurlHandle curl;
+  HttpTransaction trans;
+  Callback callback;
+
+  Transfer(const HttpRequest& req, CurlHandlePool* pool, Callback cb)
+      : request(req),
+        response(),
+        curl(pool),
+        trans(curl, &request, &response),
+        callback(cb) {
+  }
+};
+
+HttpMultiEngine::HttpMultiEngine(CurlHandlePool* pool)
+    : pool_(pool),
+      multi_(NULL),
+      pending_(0),
+      stopping_(false) {
+  multi_ = curl_multi_init();
+  if (NULL == multi_) {
+    throw CurlException("curl multi init fail");
+  }
+  loop_ = std::thread(&HttpMultiEngine::run, this);
+}
+
+HttpMultiEngine::~HttpMultiEngine() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopping_ = true;
+  }
+  cond_.notify_all();
+  wakeup();
+  loop_.join();
+  curl_multi_cleanup(multi_);
+}
+
+void HttpMultiEngine::submit(const HttpRequest& request, Callback callback) {
+  Transfer* transfer = new Transfer(request, pool_, callback);
+  try {
+    transfer->request.prepareCurlHandle(&transfer->curl);
+    transfer->trans.setup();
+    CURLcode rc = curl_easy_setopt(transfer->curl, CURLOPT_PRIVATE, transfer);
+    if (rc != CURLE_OK) {
+      throw CurlException(rc);
+    }
+  } catch (...) {
+    delete transfer;
+    throw;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (stopping_) {
+      delete transfer;
+      throw CurlException("multi engine stopped");
+    }
+    queue_.push_back(transfer);
+    pending_++;
+  }
+  cond_.notify_one();
+  wakeup();
+}
+
+std::future<HttpResponse> HttpMultiEngine::submit(const HttpRequest& request) {
+  std::shared_ptr<std::promise<HttpResponse> > promise =
+      std::make_shared<std::promise<HttpResponse> >();
+  submit(request, [promise](HttpResponse& response, std::exception_ptr error) {
+    if (error) {
+      promise->set_exception(error);
+    } else {
+      promise->set_value(response);
+    }
+  });
+  return promise->get_future();
+}
+
+size_t HttpMultiEngine::getPendingCount() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return pending_;
+}
+
+void HttpMultiEngine::run() {
+  std::set<Transfer*> active;  // added to multi_, only touched by this thread
+  int running = 0;
+
+  for (;;) {
+    std::deque<Transfer*> incoming;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!stopping_ && queue_.empty() && active.empty()) {
+        cond_.wait(lock);
+      }
+      if (stopping_) {
+        break;
+      }
+      incoming.swap(queue_);
+    }
+
+    for (size_t i = 0; i < incoming.size(); i++) {
+      CURLMcode mc = curl_multi_add_handle(multi_, incoming[i]->curl);
+      if (mc != CURLM_OK) {
+        abort(incoming[i], curl_multi_strerror(mc));
+      } else {
+        active.insert(incoming[i]);
+      }
+    }
+
+    curl_multi_perform(multi_, &running);
+
+    CURLMsg* msg = NULL;
+    int left = 0;
+    while ((msg = curl_multi_info_read(multi_, &left)) != NULL) {
+      if (msg->msg != CURLMSG_DONE) {
+        continue;
+      }
+      CURL* easy = msg->easy_handle;
+      CURLcode rc = msg->data.result;  // msg is invalid after remove
+      char* priv = NULL;
+      curl_easy_getinfo(easy, CURLINFO_PRIVATE, &priv);
+      curl_multi_remove_handle(multi_, easy);
+
+      Transfer* transfer = reinterpret_cast<Transfer*>(priv);
+      active.erase(transfer);
+      complete(transfer, rc);
+    }
+
+    if (!active.empty()) {
+#ifdef ALIYUN_HAVE_MULTI_WAKEUP
+      curl_multi_poll(multi_, NULL, 0, POLL_TIMEOUT_MS, NULL);
+#else
+      curl_multi_wait(multi_, NULL, 0, POLL_TIMEOUT_MS, NULL);
+#endif
+    }
+  }
+
+  // stopping, abort everything left.
+  for (std::set<Transfer*>::iterator it = active.begin(); it != active.end();
+       ++it) {
+    curl_multi_remove_handle(multi_, (*it)->curl);
+    abort(*it, "multi engine stopped");
+  }
+  std::deque<Transfer*> left;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    left.swap(queue_);
+  }
+  for (size_t i = 0; i < left.size(); i++) {
+    abort(left[i], "multi engine stopped");
+  }
+}
+
+void HttpMultiEngine::wakeup() {
+#ifdef ALIYUN_HAVE_MULTI_WAKEUP
+  curl_multi_wakeup(multi_);
+#endif
+}
+
+void HttpMultiEngine::complete(Transfer* transfer, CURLcode rc) {
+  std::exception_ptr error;
+  try {
+    if (rc != CURLE_OK) {
+      transfer->trans.fail(rc);
+    }
+    transfer->trans.finish();
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  try {
+    transfer->callback(transfer->response, error);
+  } catch (...) {
+    // never let user callback break the event loop.
+  }
+
+  delete transfer;  // give back curl handle
+  std::lock_guard<std::mutex> guard(mutex_);
+  pending_--;
+}
+
+void HttpMultiEngine::abort(Transfer* transfer, const char* reason) {
+  try {
+    transfer->callback(transfer->response,
+                       std::make_exception_ptr(CurlException(reason)));
+  } catch (...) {
+  }
+
+  delete transfer;
+  std::lock_guard<std::mutex> guard(mutex_);
+  pending_--;
+}
+
+}  // namespace http
+}  // namespace aliyun
@@ -17,10 +17,12 @@
  * under the License.
  */
 
-#include <string.h>
-#include <vector>
+#include <string>
+#include <utility>
 
+#include "aliyun/http/curl_handle_pool.h"
 #include "aliyun/http/http_request.h"
+#include "aliyun/utils/gzip_helper.h"
 #include "aliyun/utils/parameter_helper.h"
 #include "aliyun/utils/string_utils.h"
 #include "aliyun/utils/details/global_initializer.h"
@@ -31,6 +33,7 @@ namespace http {
 // long: follow libcurl API
 long HttpRequest::sSSLVerifyHost = HttpRequest::DEFALT_VERIFYHOST_OPT;
 long HttpRequest::sSSLVerifyPeer = HttpRequest::DEFALT_VERIFYPEER_OPT;
+std::atomic<bool> HttpRequest::sGzipEnabled(false);
 
 
 CurlException::CurlException(CURLcode rc)
@@ -38,42 +41,69 @@ CurlException::CurlException(CURLcode rc)
 }
 
 CurlException::CurlException(std::string what)
-    : Exception(what) {
+    : Exception(std::move(what)) {
 }
 
 CurlHandle::CurlHandle()
     : head_(0),
-      post_(0),
-      curl_(NULL) {
+      curl_(NULL),
+      pool_(NULL) {
   curl_ = curl_easy_init();
   if (NULL == curl_) {
     throw CurlException("curl init fail");
   }
 }
 
+CurlHandle::CurlHandle(CurlHandlePool* pool)
+    : head_(0),
+      curl_(NULL),
+      pool_(pool) {
+  curl_ = pool_ ? pool_->acquire() : curl_easy_init();
+  if (NULL == curl_) {
+    throw CurlException("curl init fail");
+  }
+}
+
 CurlHandle::~CurlHandle() {
-  if (curl_) curl_easy_cleanup(curl_);
+  if (curl_) {
+    if (pool_) {
+      pool_->release(curl_);  // keep connection alive for next request
+    } else {
+      curl_easy_cleanup(curl_);
+    }
+  }
   if (head_) curl_slist_free_all(head_);
-  if (post_) free(post_);  // free here
 }
 
 HttpRequest::HttpRequest() {
   method_ = MethodType::INVALID;
   contentType_ = FormatType::INVALID;
+  timeout_ = 0;
+  connectTimeout_ = 0;
+  bodySink_ = NULL;
+  bodyBuffer_ = NULL;
 }
 
-HttpRequest::HttpRequest(std::string url) {
-  url_ = url;
+HttpRequest::HttpRequest(std::string url)
+    : url_(std::move(url)) {
   method_ = MethodType::INVALID;
   contentType_ = FormatType::INVALID;
+  timeout_ = 0;
+  connectTimeout_ = 0;
+  bodySink_ = NULL;
+  bodyBuffer_ = NULL;
 }
 
 HttpRequest::HttpRequest(std::string url,
-                         const std::map<std::string, std::string>& headers) {
-  url_ = url;
-  headers_ = headers;
+                         const std::map<std::string, std::string>& headers)
+    : url_(std::move(url)),
+      headers_(headers) {
   method_ = MethodType::INVALID;
   contentType_ = FormatType::INVALID;
+  timeout_ = 0;
+  connectTimeout_ = 0;
+  bodySink_ = NULL;
+  bodyBuffer_ = NULL;
 }
 
 void HttpRequest::setContentType(FormatType contentType) {
@@ -86,7 +116,7 @@ void HttpRequest::setContentType(FormatType contentType) {
   }
 }
 
-std::string HttpRequest::getHeaderValue(std::string name) const {
+std::string HttpRequest::getHeaderValue(const std::string& name) const {
   std::string value;
   std::map<std::string, std::string>::const_iterator it;
   it = headers_.find(name);
@@ -98,18 +128,18 @@ std::string HttpRequest::getHeaderValue(std::string name) const {
 
 void HttpRequest::putHeaderParameter(std::string name, std::string value) {
   if (name.length() != 0 && value.length() != 0) {
-    headers_[name] = value;
+    headers_[std::move(name)] = std::move(value);
   }
 }
 
-void HttpRequest::removeHeaderParameter(std::string name) {
+void HttpRequest::removeHeaderParameter(const std::string& name) {
   std::map<std::string, std::string>::iterator it = headers_.find(name);
   if (it != headers_.end()) {
     headers_.erase(it);
   }
 }
 
-void HttpRequest::setContent(std::string content, std::string encoding,
+void HttpRequest::setContent(std::string content, const std::string& encoding,
                              FormatType format) {
   if (content.length() == 0) {
     removeHeaderParameter("Content-MD5");
@@ -120,7 +150,7 @@ void HttpRequest::setContent(std::string content, std::string encoding,
     encoding_.clear();
     return;
   }
-  content_ = content;
+  content_ = std::move(content);
   encoding_ = encoding;
 
   if (FormatType::INVALID != format) {
@@ -134,20 +164,18 @@ void HttpRequest::setContent(std::string content, std::string encoding,
   headers_["Content-Type"] = getContentTypeValue(contentType_, encoding_);
 }
 
-void HttpRequest::prepareCurlHandle(CurlHandle* curl) {
-  std::string url = url_;
-  std::vector<std::string> urlArray;
-
-  // split arguments for POST
-  if (MethodType::POST == method_ && getContent().length() == 0) {
-    std::string::size_type pos = 0;
-    pos = url_.find("?");
-    if (pos != std::string::npos) {
-      urlArray.push_back(url_.substr(0, pos));
-      urlArray.push_back(url_.substr(pos + 1, url_.length() - (pos + 1)));
-      url = urlArray[0];
-    }
+void HttpRequest::prepareCurlHandle(CurlHandle* curl) const {
+  // arguments of a POST without content go in the body, curl copies both
+  // parts, so nothing but the address is copied here.
+  std::string::size_type query = std::string::npos;
+  if (MethodType::POST == method_ && content_.length() == 0) {
+    query = url_.find('?');
+  }
+  std::string address;
+  if (query != std::string::npos) {
+    address.assign(url_, 0, query);
   }
+  const std::string& url = query != std::string::npos ? address : url_;
   if (url.length() == 0) {
     throw Exception("bad URL");
   }
@@ -173,6 +201,10 @@ void HttpRequest::prepareCurlHandle(CurlHandle* curl) {
       break;
     case MethodType::POST:
       curl_easy_setopt_throw(CURLOPT_POST, 1);
+      if (content_.length() != 0) {  // sent by read callback, not chunked
+        curl_easy_setopt_throw(CURLOPT_POSTFIELDSIZE_LARGE,
+                               static_cast<curl_off_t>(content_.length()));
+      }
       break;
     case MethodType::Delete:
       curl_easy_setopt_throw(CURLOPT_CUSTOMREQUEST, "DELETE");
@@ -184,6 +216,13 @@ void HttpRequest::prepareCurlHandle(CurlHandle* curl) {
       break;
   }
 
+  if (timeout_ > 0) {
+    curl_easy_setopt_throw(CURLOPT_TIMEOUT_MS, timeout_);
+  }
+  if (connectTimeout_ > 0) {
+    curl_easy_setopt_throw(CURLOPT_CONNECTTIMEOUT_MS, connectTimeout_);
+  }
+
   if (sSSLVerifyHost != DEFALT_VERIFYHOST_OPT) {
     curl_easy_setopt_throw(CURLOPT_SSL_VERIFYHOST, sSSLVerifyHost);
   }
@@ -191,32 +230,40 @@ void HttpRequest::prepareCurlHandle(CurlHandle* curl) {
     curl_easy_setopt_throw(CURLOPT_SSL_VERIFYPEER, sSSLVerifyPeer);
   }
 
-  std::string contType = getHeaderValue("Content-Type");
-  if (contType.length() == 0) {
-    contType = getContentTypeValue(contentType_, encoding_);
+  std::string header;
+  std::map<std::string, std::string>::const_iterator iter;
+  for (iter = headers_.begin(); iter != headers_.end(); iter++) {
+    header.assign(iter->first);
+    header += ": ";
+    header += iter->second;
+    curl->head_ = curl_slist_append(curl->head_, header.c_str());
+  }
+  if (headers_.find("Content-Type") == headers_.end()) {
+    std::string contType = getContentTypeValue(contentType_, encoding_);
     if (contType.length() != 0) {
-      putHeaderParameter("Content-Type", contType);
+      header.assign("Content-Type: ");
+      header += contType;
+      curl->head_ = curl_slist_append(curl->head_, header.c_str());
     }
   }
-
-  std::map<std::string, std::string>::iterator iter;
-  for (iter = headers_.begin(); iter != headers_.end(); iter++) {
-    std::string s = iter->first + ": " + iter->second;
-    curl->head_ = curl_slist_append(curl->head_, s.c_str());
+  if (sGzipEnabled && headers_.find("Accept-Encoding") == headers_.end()) {
+    curl->head_ = curl_slist_append(curl->head_,
+                                    "Accept-Encoding: gzip, deflate");
   }
 
   if (NULL != curl->head_) {
     curl_easy_setopt_throw(CURLOPT_HTTPHEADER, curl->head_);
   }
 
-  if (MethodType::POST == method_ && urlArray.size() == 2) {
-    curl->post_ = ::strdup(urlArray[1].c_str());  // duplicate in heap
-    curl_easy_setopt_throw(CURLOPT_POSTFIELDS, curl->post_);
+  if (query != std::string::npos) {
+    curl_easy_setopt_throw(CURLOPT_POSTFIELDSIZE_LARGE,
+                           static_cast<curl_off_t>(url_.length() - query - 1));
+    curl_easy_setopt_throw(CURLOPT_COPYPOSTFIELDS, url_.c_str() + query + 1);
   }
 }
 
-std::string HttpRequest::getContentTypeValue(FormatType contentType,
-                                             std::string encoding) {
+std::string HttpRequest::getContentTypeValue(
+    FormatType contentType, const std::string& encoding) const {
   if (FormatType::INVALID != contentType && encoding.length() != 0) {
     return FormatType::mapFormatToAccept(contentType) + ";charset="
         + aliyun::utils::StringUtils::ToLowerCase(encoding);
@@ -228,7 +275,7 @@ std::string HttpRequest::getContentTypeValue(FormatType contentType,
 }
 
 void HttpRequest::enableGzip(bool enable) {
-  // TODO(xu): implement gzip on curl
+  sGzipEnabled = enable && utils::GzipHelper::isSupported();
 }
 
 }  // namespace http
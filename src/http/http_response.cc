@@ -20,49 +20,31 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "aliyun/http/body_sink.h"
 #include "aliyun/http/method_type.h"
 #include "aliyun/http/http_response.h"
+#include "aliyun/http/details/http_transaction.h"
+#include "aliyun/utils/gzip_helper.h"
 #include "aliyun/utils/string_utils.h"
 
 namespace aliyun {
 namespace http {
 
-std::string HttpResponse::getHeaderValue(std::string name) const {
-  std::map<std::string, std::string>::const_iterator it;
-  it = headers_.find(name);
-  if (it != headers_.end())
-    return it->second;
-  it = headers_.find(utils::StringUtils::ToLowerCase(name));
-  if (it != headers_.end())
-    return it->second;
-  return "";
-}
-
-struct HttpTransaction {
-  CURL* curl_;
-  HttpRequest* request_;
-  HttpResponse* response_;
-  size_t bodySends_;
-  size_t bodyReceives_;
-
-  enum {
-    INIT,
-    HEADER,
-    BODY_IN,
-    BODY_OUT,
-    ABORT,
-    DONE,
-  } state_;
-
-  HttpTransaction(CURL* curl, HttpRequest* req, HttpResponse* resp)
-      : curl_(curl),
-        request_(req),
-        response_(resp),
-        bodySends_(0),
-        bodyReceives_(0),
-        state_(INIT) {
-  }
-};
+std::string HttpResponse::getHeaderValue(const std::string& name) const {
+  return headerStore_.get(name).toString();
+}
+
+const std::map<std::string, std::string>& HttpResponse::getHeaders() const {
+  if (!headerMapValid_) {
+    headerMap_.clear();
+    for (size_t i = 0; i < headerStore_.size(); i++) {
+      headerMap_[headerStore_.getName(i).toString()] =
+          headerStore_.getValue(i).toString();
+    }
+    headerMapValid_ = true;
+  }
+  return headerMap_;
+}
 
 static void updateTransactionInfo(HttpTransaction* t) {
 #define curl_easy_getinfo_throw(curl, info, ptr) \
@@ -76,22 +58,90 @@ static void updateTransactionInfo(HttpTransaction* t) {
   t->response_->setStatus(status);
 }
 
+static bool containsIgnoreCase(const utils::StringPiece& str,
+                               const utils::StringPiece& word) {
+  for (size_t i = 0; i + word.size() <= str.size(); i++) {
+    if (HeaderStore::equalsIgnoreCase(str.substr(i, word.size()), word)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// leading decimal digits, 0 if none.
+static size_t parseLength(const utils::StringPiece& str) {
+  size_t length = 0;
+  for (size_t i = 0; i < str.size() && str[i] >= '0' && str[i] <= '9'; i++) {
+    length = length * 10 + (str[i] - '0');
+  }
+  return length;
+}
+
 static size_t ResponseHeaderHandler(char *ptr, size_t size, size_t nmemb,
                                     void *userdata) {
   HttpTransaction* t = reinterpret_cast<HttpTransaction*>(userdata);
   size_t length = size * nmemb;
 
   t->state_ = HttpTransaction::HEADER;
-  char* colon = ::strstr(ptr, ": ");
+  if (length > 5 && ::strncmp(ptr, "HTTP/", 5) == 0) {
+    // status line of a new response (after 100 Continue, redirects).
+    t->response_->clearHeaders();
+    delete t->inflater_;
+    t->inflater_ = NULL;
+    t->contentLength_ = 0;
+    if (t->sink_ != NULL) {
+      try {
+        t->sink_->onBegin();
+      } catch (...) {
+        t->sinkError_ = std::current_exception();
+        t->state_ = HttpTransaction::ABORT;
+        return 0;  // abort transfer
+      }
+    }
+  }
+
+  // "name: value\r\n", ptr is not NUL-terminated.
+  const char* colon = static_cast<const char*>(::memchr(ptr, ':', length));
   if (colon != NULL) {
-    std::string name(ptr, colon);
-    char* crlf = ::strstr(ptr, "\r\n");
-    std::string value(colon + 2, crlf ? crlf : ptr + length);
-    t->response_->putHeaderParameter(name, value);
+    const char* value = colon + 1;
+    const char* end = ptr + length;
+    while (value < end && (*value == ' ' || *value == '\t')) {
+      value++;
+    }
+    while (end > value && (end[-1] == '\r' || end[-1] == '\n'
+                           || end[-1] == ' ' || end[-1] == '\t')) {
+      end--;
+    }
+    utils::StringPiece valuePiece(value, end - value);
+    HeaderStore::HotHeader hot = t->response_->headerStore().add(
+        utils::StringPiece(ptr, colon - ptr), valuePiece);
+
+    if (hot == HeaderStore::CONTENT_ENCODING && NULL == t->inflater_
+        && utils::GzipInflater::isSupported()
+        && (containsIgnoreCase(valuePiece, "gzip")
+            || containsIgnoreCase(valuePiece, "deflate"))) {
+      t->inflater_ = new utils::GzipInflater();
+    } else if (hot == HeaderStore::CONTENT_LENGTH) {
+      t->contentLength_ = parseLength(valuePiece);
+    }
   }
   return length;
 }
 
+// Content-Length of an uncompressed body is trusted up to this size.
+static const size_t MAX_BODY_RESERVE = 64 * 1024 * 1024;
+
+// sizes the body buffer once instead of growing it piece by piece.
+static void reserveBody(HttpTransaction* t) {
+  size_t size = t->contentLength_;
+  if (size > MAX_BODY_RESERVE) {
+    size = MAX_BODY_RESERVE;
+  }
+  if (size > t->body_->capacity()) {
+    t->body_->reserve(size);
+  }
+}
+
 static size_t ResponseBodyHandler(char *ptr, size_t size, size_t nmemb,
                                   void *userdata) {
   HttpTransaction* t = reinterpret_cast<HttpTransaction*>(userdata);
@@ -99,7 +149,34 @@ static size_t ResponseBodyHandler(char *ptr, size_t size, size_t nmemb,
 
   // DONE: handle http bodys.
   t->state_ = HttpTransaction::BODY_IN;
-  t->response_->content().append(ptr, ptr + length);
+  if (t->sink_ != NULL) {
+    try {
+      if (t->inflater_) {
+        t->inflated_.clear();
+        t->inflater_->inflate(ptr, length, &t->inflated_);
+        t->sink_->onData(t->inflated_.data(), t->inflated_.size());
+      } else {
+        t->sink_->onData(ptr, length);
+      }
+    } catch (...) {
+      t->sinkError_ = std::current_exception();
+      t->state_ = HttpTransaction::ABORT;
+      return 0;  // abort transfer
+    }
+  } else if (t->inflater_) {
+    try {
+      t->inflater_->inflate(ptr, length, t->body_);
+    } catch (utils::GzipException& e) {
+      t->error_ = e.what();
+      t->state_ = HttpTransaction::ABORT;
+      return 0;  // abort transfer
+    }
+  } else {
+    if (t->bodyReceives_ == 0) {
+      reserveBody(t);
+    }
+    t->body_->append(ptr, ptr + length);
+  }
   t->bodyReceives_ += length;
   return length;
 }
@@ -108,67 +185,122 @@ static size_t RequestBodyHandler(char *ptr, size_t size, size_t nmemb,
                                  void *userdata) {
   HttpTransaction* t = reinterpret_cast<HttpTransaction*>(userdata);
   size_t buffLen = size * nmemb;  // internal body buffer length.
-  size_t contLen = t->request_->getContent().length();
+  const std::string& content = t->request_->getContent();
+  size_t contLen = content.length();
   size_t bodyLeft = contLen - t->bodySends_;
 
   t->state_ = HttpTransaction::BODY_OUT;
   if (bodyLeft > 0) {
     size_t sendLen = bodyLeft < buffLen ? bodyLeft : buffLen;
-    char* sendPtr = &(t->request_->getContent()[t->bodySends_]);
-    ::memcpy(ptr, sendPtr, sendLen);
+    ::memcpy(ptr, content.data() + t->bodySends_, sendLen);
     t->bodySends_ += sendLen;
     return sendLen;
   }
   return 0;
 }
 
-HttpResponse HttpResponse::getResponse(HttpRequest request) {
-  CURLcode rc;
-  HttpResponse response;
+HttpResponse HttpResponse::getResponse(const HttpRequest& request) {
+  return getResponse(request, NULL);
+}
 
-  CurlHandle curl;
-  request.prepareCurlHandle(&curl);
-  HttpTransaction trans(curl, &request, &response);
+HttpTransaction::HttpTransaction(CURL* curl, const HttpRequest* req,
+                                 HttpResponse* resp)
+    : curl_(curl),
+      request_(req),
+      response_(resp),
+      bodySends_(0),
+      bodyReceives_(0),
+      inflater_(NULL),
+      body_(req->getBodyBuffer()),
+      contentLength_(0),
+      sink_(req->getBodySink()),
+      state_(INIT) {
+  if (NULL == body_) {
+    body_ = &resp->content();
+  }
+  body_->clear();
+}
+
+HttpTransaction::~HttpTransaction() {
+  delete inflater_;
+}
+
+void HttpTransaction::setup() {
+  CURLcode rc;
 
 #define curl_easy_setopt_throw(opt, val)       \
-  rc = curl_easy_setopt(curl, opt, (val));     \
+  rc = curl_easy_setopt(curl_, opt, (val));    \
   if (rc != CURLE_OK) throw CurlException(rc);
 
   // set up callbacks
-  if (request.getMethod() == MethodType::PUT
-      || request.getMethod() == MethodType::POST) {
-    curl_easy_setopt_throw(CURLOPT_READDATA, &trans);
+  if (request_->getMethod() == MethodType::PUT
+      || request_->getMethod() == MethodType::POST) {
+    curl_easy_setopt_throw(CURLOPT_READDATA, this);
     curl_easy_setopt_throw(CURLOPT_READFUNCTION, RequestBodyHandler);
     curl_easy_setopt_throw(CURLOPT_INFILESIZE_LARGE,
-                           request.getContent().size());
+                           request_->getContent().size());
   }
 
-  curl_easy_setopt_throw(CURLOPT_HEADERDATA, &trans);
+  curl_easy_setopt_throw(CURLOPT_HEADERDATA, this);
   curl_easy_setopt_throw(CURLOPT_HEADERFUNCTION, ResponseHeaderHandler);
 
-  curl_easy_setopt_throw(CURLOPT_WRITEDATA, &trans);
+  curl_easy_setopt_throw(CURLOPT_WRITEDATA, this);
   curl_easy_setopt_throw(CURLOPT_WRITEFUNCTION, ResponseBodyHandler);
 
   curl_easy_setopt_throw(CURLOPT_FILETIME, 1);
   curl_easy_setopt_throw(CURLOPT_NOSIGNAL, 1);
   curl_easy_setopt_throw(CURLOPT_TCP_NODELAY, 1);  // disable Nagle
+  curl_easy_setopt_throw(CURLOPT_TCP_KEEPALIVE, 1);  // for pooled handles
   curl_easy_setopt_throw(CURLOPT_NETRC, CURL_NETRC_IGNORED);
 
 #ifdef ALIYUN_TRACE
-  curl_easy_setopt_throw(curl, CURLOPT_VERBOSE, 1);
+  curl_easy_setopt_throw(CURLOPT_VERBOSE, 1);
 #endif
-  rc = curl_easy_perform(curl);
-  if (rc != 0)
-    throw CurlException(rc);
-  updateTransactionInfo(&trans);
+#undef curl_easy_setopt_throw
+}
 
-  parseParameters(&response);
+void HttpTransaction::finish() {
+  if (inflater_ && bodyReceives_ > 0 && !inflater_->finished()) {
+    throw CurlException("unexpected end of compressed body");
+  }
+  if (sink_ != NULL) {
+    sink_->onEnd();
+  }
+  updateTransactionInfo(this);
+  HttpResponse::parseParameters(response_);
+  state_ = DONE;
+}
+
+void HttpTransaction::fail(CURLcode rc) {
+  if (sinkError_) {
+    std::rethrow_exception(sinkError_);
+  }
+  if (rc == CURLE_WRITE_ERROR && error_.length() != 0) {
+    throw CurlException(error_);
+  }
+  throw CurlException(rc);
+}
+
+HttpResponse HttpResponse::getResponse(const HttpRequest& request,
+                                       CurlHandlePool* pool) {
+  HttpResponse response;
+
+  CurlHandle curl(pool);
+  request.prepareCurlHandle(&curl);
+  HttpTransaction trans(curl, &request, &response);
+  trans.setup();
+
+  CURLcode rc = curl_easy_perform(curl);
+  if (rc != 0)
+    trans.fail(rc);
+  trans.finish();
   return response;
 }
 
 void HttpResponse::parseParameters(HttpResponse* response) {
   using aliyun::utils::StringUtils::ToUpperCase;
-  string type = response->getHeaderValue("Content-Type");
+  string type = response->getHeaderStore().get(
+      HeaderStore::CONTENT_TYPE).toString();
   if (type.length() > 0) {
     response->setEncoding("UTF-8");
 
@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/http/loopback_transport.h"
+
+#include "aliyun/http/body_sink.h"
+#include "aliyun/utils/string_utils.h"
+
+namespace aliyun {
+namespace http {
+
+const size_t LoopbackTransport::DEFAULT_CHUNK_SIZE;
+
+LoopbackTransport::LoopbackTransport()
+    : default_(makeCanned("", 404, "")),
+      chunkSize_(DEFAULT_CHUNK_SIZE),
+      requests_(0) {
+}
+
+void LoopbackTransport::addResponse(const std::string& path,
+                                    const std::string& content, int status,
+                                    const std::string& contentType) {
+  responses_[path] = makeCanned(content, status, contentType);
+}
+
+void LoopbackTransport::setDefaultResponse(const std::string& content,
+                                           int status,
+                                           const std::string& contentType) {
+  default_ = makeCanned(content, status, contentType);
+}
+
+HttpResponse LoopbackTransport::send(const HttpRequest& request) {
+  requests_++;
+  const Canned& canned = find(getPath(request.getUrl()));
+
+  HttpResponse response;
+  response.setStatus(canned.status);
+  if (canned.contentType.length() != 0) {
+    response.headerStore().add("Content-Type", canned.contentType);
+  }
+  response.headerStore().add("Content-Length", canned.contentLength);
+
+  // the body goes where HttpTransaction would put it.
+  BodySink* sink = request.getBodySink();
+  if (sink != NULL) {
+    sink->onBegin();
+    const std::string& content = canned.content;
+    for (size_t pos = 0; pos < content.size(); pos += chunkSize_) {
+      size_t size = content.size() - pos;
+      sink->onData(content.data() + pos, size < chunkSize_ ? size : chunkSize_);
+    }
+    sink->onEnd();
+  } else if (request.getBodyBuffer() != NULL) {
+    request.getBodyBuffer()->assign(canned.content);
+  } else {
+    response.content() = canned.content;
+  }
+  HttpResponse::parseParameters(&response);
+  return response;
+}
+
+std::string LoopbackTransport::getPath(const std::string& url) {
+  std::string::size_type start = url.find("://");
+  start = start == std::string::npos ? 0 : url.find('/', start + 3);
+  if (start == std::string::npos) {
+    return "/";
+  }
+  std::string::size_type end = url.find_first_of("?#", start);
+  return url.substr(start, end == std::string::npos ? end : end - start);
+}
+
+const LoopbackTransport::Canned& LoopbackTransport::find(
+    const std::string& path) const {
+  const Canned* canned = &default_;
+  size_t matched = 0;
+  for (std::map<std::string, Canned>::const_iterator it = responses_.begin();
+       it != responses_.end(); ++it) {
+    const std::string& suffix = it->first;
+    if (suffix.size() > matched && suffix.size() <= path.size()
+        && path.compare(path.size() - suffix.size(), suffix.size(),
+                        suffix) == 0) {
+      canned = &it->second;
+      matched = suffix.size();
+    }
+  }
+  return *canned;
+}
+
+LoopbackTransport::Canned LoopbackTransport::makeCanned(
+    const std::string& content, int status, const std::string& contentType) {
+  Canned canned;
+  canned.status = status;
+  canned.content = content;
+  canned.contentType = contentType;
+  canned.contentLength = utils::StringUtils::ToString(content.size());
+  return canned;
+}
+
+}  // namespace http
+}  // namespace aliyun
@@ -36,7 +36,7 @@ MethodType::MethodType(Value v)
     : value_(v) {
 }
 
-MethodType::MethodType(std::string method) {
+MethodType::MethodType(const std::string& method) {
   for (int i = GET; i <= OPTIONS; i++) {
     if (::strncasecmp(method.c_str(), valueNames()[i], method.length()) == 0) {
       value_ = Value(i);
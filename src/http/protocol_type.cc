@@ -24,7 +24,7 @@ namespace aliyun {
 
 namespace http {
 
-ProtocolType::ProtocolType(std::string protocol) {
+ProtocolType::ProtocolType(const std::string& protocol) {
   if (strncasecmp(protocol.c_str(), "http", sizeof("http")) == 0) {
     value_ = HTTP;
   } else if (strncasecmp(protocol.c_str(), "https", sizeof("https")) == 0) {
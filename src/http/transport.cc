@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/http/transport.h"
+
+#include "aliyun/http/http_multi_engine.h"
+
+namespace aliyun {
+namespace http {
+
+void Transport::submit(const HttpRequest& request, Callback callback) {
+  HttpResponse response;
+  try {
+    response = send(request);
+  } catch (...) {
+    callback(response, std::current_exception());
+    return;
+  }
+  callback(response, std::exception_ptr());
+}
+
+CurlTransport::CurlTransport(CurlHandlePool* pool)
+    : pool_(pool),
+      engine_(NULL) {
+}
+
+CurlTransport::~CurlTransport() {
+  // engine gives curl handles back to pool_, which outlives this.
+  delete engine_;
+}
+
+HttpResponse CurlTransport::send(const HttpRequest& request) {
+  return HttpResponse::getResponse(request, pool_);
+}
+
+void CurlTransport::submit(const HttpRequest& request, Callback callback) {
+  getEngine()->submit(request, callback);
+}
+
+HttpMultiEngine* CurlTransport::getEngine() {
+  std::lock_guard<std::mutex> guard(engineMutex_);
+  if (NULL == engine_) {
+    engine_ = new HttpMultiEngine(pool_);
+  }
+  return engine_;
+}
+
+}  // namespace http
+}  // namespace aliyun
@@ -19,6 +19,13 @@
 
 #include "aliyun/opensearch/cloudsearch_client.h"
 
+#include <stdlib.h>
+
+#include <memory>
+#include <utility>
+
+#include "aliyun/utils/gzip_helper.h"
+
 namespace aliyun {
 namespace opensearch {
 
@@ -27,24 +34,85 @@ using std::string;
 const std::string CloudsearchClient::DEFAULT_METHOD = "GET";
 const std::string CloudsearchClient::METHOD_GET = "GET";
 const std::string CloudsearchClient::METHOD_POST = "POST";
+const int CloudsearchClient::DEFAULT_TIMEOUT;
+const int CloudsearchClient::DEFAULT_CONNECT_TIMEOUT;
+
+// the caller's params overlaid by the ones added for signing, visited in key
+// order without copying or changing either map. added ones win on equal keys.
+class CloudsearchClient::SignedParams {
+ public:
+  typedef std::map<string, string> Map;
+
+  explicit SignedParams(const Map& params)
+      : params_(params) {
+  }
+
+  void add(const string& key, const string& value) {
+    added_[key] = value;
+  }
+
+  // NULL if not found.
+  const string* find(const string& key) const {
+    Map::const_iterator it = added_.find(key);
+    if (it != added_.end()) {
+      return &it->second;
+    }
+    it = params_.find(key);
+    return it != params_.end() ? &it->second : NULL;
+  }
+
+  // visit(key, value) for all params but `skipKey`, in key order.
+  template <typename Visitor>
+  void visit(const char* skipKey, Visitor visit) const {
+    Map::const_iterator p = params_.begin();
+    Map::const_iterator a = added_.begin();
+    while (p != params_.end() || a != added_.end()) {
+      Map::const_iterator it;
+      if (a == added_.end() || (p != params_.end() && p->first < a->first)) {
+        it = p++;
+      } else {
+        if (p != params_.end() && p->first == a->first) {
+          ++p;  // overridden
+        }
+        it = a++;
+      }
+      if (NULL == skipKey || it->first != skipKey) {
+        visit(it->first, it->second);
+      }
+    }
+  }
+
+ private:
+  const Map& params_;
+  Map added_;
+};
 
 CloudsearchClient::CloudsearchClient(string accesskey, string secret,
                                      string host,
                                      const std::map<string, string>& opts,
-                                     KeyTypeEnum keyType) {
+                                     KeyTypeEnum keyType)
+    : curlTransport_(&pool_),
+      transport_(&curlTransport_) {
   this->initialize("", "", host, opts);
   this->version_ = "v2";
   this->keyType_ = keyType;
-  this->accesskey_ = accesskey;
-  this->secret_ = secret;
+  this->aliyunKey_ = auth::HmacSha1Key(secret + "&");
+  this->accesskey_ = std::move(accesskey);
+  this->secret_ = std::move(secret);
 }
 
 CloudsearchClient::CloudsearchClient(string clientId, string clientSecret,
                                      string host,
-                                     const std::map<string, string>& opts) {
+                                     const std::map<string, string>& opts)
+    : curlTransport_(&pool_),
+      transport_(&curlTransport_) {
   this->initialize(clientId, clientSecret, host, opts);
 }
 
+CloudsearchClient::~CloudsearchClient() {
+  // curlTransport_ goes before pool_, its engine gives handles back to pool_.
+}
+
 void CloudsearchClient::initialize(const string& clientId,
                                    const string& clientSecret,
                                    const string& host,
@@ -54,6 +122,10 @@ void CloudsearchClient::initialize(const string& clientId,
   clientId_ = clientId;
   clientSecret_ = clientSecret;
   host_ = host;
+  requestGzip_ = false;
+  responseGzip_ = false;
+  timeout_ = DEFAULT_TIMEOUT;
+  connectTimeout_ = DEFAULT_CONNECT_TIMEOUT;
 
   if (host.length() == 0) {
     throw aliyun::Exception("UnknownHostException");
@@ -65,15 +137,22 @@ void CloudsearchClient::initialize(const string& clientId,
     }
 
     if (opts.find("gzip") != opts.end()) {
-      http::HttpRequest::enableGzip(true);
+      string gzip = opts.find("gzip")->second;
+      responseGzip_ = gzip != "false" && gzip != "0"
+          && utils::GzipInflater::isSupported();
+    }
+
+    if (opts.find("gzip_request") != opts.end()) {
+      string gzip = opts.find("gzip_request")->second;
+      setRequestGzip(gzip != "false" && gzip != "0");
     }
 
     if (opts.find("timeout") != opts.end()) {
-      // TODO(xu): set http timeout
+      timeout_ = ::atoi(opts.find("timeout")->second.c_str());
     }
 
     if (opts.find("connect_timeout") != opts.end()) {
-      // TODO(xu): set http connect timeout
+      connectTimeout_ = ::atoi(opts.find("connect_timeout")->second.c_str());
     }
   }
 
@@ -84,42 +163,136 @@ void CloudsearchClient::initialize(const string& clientId,
 
 void CloudsearchClient::setMaxConnections(int maxConns) {
   if (maxConns > 0) {
-    // TODO(xu): set maximum connnections
+    pool_.setMaxIdleHandles(maxConns);
   }
 }
 
-string CloudsearchClient::call(string path,
+void CloudsearchClient::setRequestGzip(bool enable) {
+  requestGzip_ = enable && utils::GzipHelper::isSupported();
+}
+
+string CloudsearchClient::call(const string& path,
                                const std::map<string, string>& params,
-                               string method, bool isPB, string& debugInfo) {
-  string uri;
-  if (this->keyType_ == KeyTypeEnum::OPENSEARCH) {
-    uri = '/' + this->version_ + "/api";
+                               const string& method, bool isPB,
+                               string& debugInfo,
+                               const utils::Deadline& deadline) {
+  http::HttpRequest request = buildRequest(path, params, method, debugInfo,
+                                           deadline);
+  http::HttpResponse response = transport_->send(request);
+  return getResult(&response, isPB);
+}
+
+void CloudsearchClient::call(const string& path,
+                             const std::map<string, string>& params,
+                             const string& method, string& debugInfo,
+                             const utils::Deadline& deadline,
+                             http::BodySink* sink) {
+  http::HttpRequest request = buildRequest(path, params, method, debugInfo,
+                                           deadline);
+  request.setBodySink(sink);
+  transport_->send(request);
+}
+
+std::future<string> CloudsearchClient::callAsync(
+    const string& path, const std::map<string, string>& params,
+    const string& method, bool isPB, string& debugInfo,
+    const utils::Deadline& deadline) {
+  http::HttpRequest request = buildRequest(path, params, method, debugInfo,
+                                           deadline);
+
+  std::shared_ptr<std::promise<string> > promise =
+      std::make_shared<std::promise<string> >();
+  transport_->submit(request, [promise, isPB](http::HttpResponse& response,
+                                               std::exception_ptr error) {
+    if (error) {
+      promise->set_exception(error);
+      return;
+    }
+    try {
+      promise->set_value(getResult(&response, isPB));
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  });
+  return promise->get_future();
+}
+
+http::HttpRequest CloudsearchClient::buildRequest(
+    const string& path, const std::map<string, string>& params,
+    const string& method, string& debugInfo, const utils::Deadline& deadline) {
+  // no time left, fail fast without sending.
+  if (deadline.expired()) {
+    throw http::CurlException(CURLE_OPERATION_TIMEDOUT);
   }
-  string url = this->baseURI_ + uri + path;
 
-  std::map<string, string> parameters(params);
+  SignedParams parameters(params);
   if (this->keyType_ == KeyTypeEnum::OPENSEARCH) {
-    parameters["client_id"] = this->clientId_;
-    parameters["nonce"] = getNonce();
-    parameters["sign"] = doSign(&parameters);
+    parameters.add("client_id", this->clientId_);
+    parameters.add("nonce", getNonce());
+    parameters.add("sign", doSign(parameters));
   } else if (this->keyType_ == KeyTypeEnum::ALIYUN) {
-    parameters["Version"] = "v2";
-    parameters["AccessKeyId"] = this->accesskey_;
-    parameters["Timestamp"] = utils::ParameterHelper::getISO8601Date(
-        utils::Date());
-    parameters["SignatureMethod"] = "HMAC-SHA1";
-    parameters["SignatureVersion"] = "1.0";
-    parameters["SignatureNonce"] = utils::ParameterHelper::getUUID();
-    parameters["Signature"] = getAliyunSign(&parameters, method);
+    parameters.add("Version", "v2");
+    parameters.add("AccessKeyId", this->accesskey_);
+    parameters.add("Timestamp", utils::ParameterHelper::getISO8601Date(
+        utils::Date()));
+    parameters.add("SignatureMethod", "HMAC-SHA1");
+    parameters.add("SignatureVersion", "1.0");
+    parameters.add("SignatureNonce", utils::ParameterHelper::getUUID());
+    parameters.add("Signature", getAliyunSign(parameters, method));
   }
-  if (method.length() == 0) {
-    method = DEFAULT_METHOD;
+  const string& httpMethod = method.length() != 0 ? method : DEFAULT_METHOD;
+
+  // signature is done, items can be sent in compressed body instead.
+  string body;
+  const char* skipKey = NULL;
+  const string* items = parameters.find("items");
+  if (requestGzip_ && httpMethod == METHOD_POST && items != NULL) {
+    body.reserve(6 + auth::UrlEncoder::encodedLength(*items));
+    body += "items=";
+    auth::UrlEncoder::appendPercentEncoded(*items, &body);
+    skipKey = "items";
   }
 
-  debugInfo.resize(0);
-  debugInfo.append(url + buildHttpParameterString(parameters));
+  // the url is built in place and handed over to the request.
+  string url(this->baseURI_);
+  if (this->keyType_ == KeyTypeEnum::OPENSEARCH) {
+    url += '/';
+    url += this->version_;
+    url += "/api";
+  }
+  url += path;
+  buildHttpParameterString(parameters, skipKey, &url);
+  debugInfo.assign(url);
+
+  http::HttpRequest request(std::move(url));
+  request.setMethod(httpMethod);
+
+  long timeout = timeout_;  // long: follow libcurl
+  if (deadline.isSet()) {
+    // whichever comes first, the client timeout or the deadline.
+    utils::Deadline limit = timeout > 0
+        ? utils::Deadline::min(deadline, utils::Deadline::after(timeout))
+        : deadline;
+    timeout = limit.remainingMillis();
+    if (timeout <= 0) {
+      throw http::CurlException(CURLE_OPERATION_TIMEDOUT);
+    }
+  }
+  request.setTimeout(timeout);
+  request.setConnectTimeout(connectTimeout_);
+  if (responseGzip_) {
+    // decompressed while received.
+    request.putHeaderParameter("Accept-Encoding", "gzip, deflate");
+  }
 
-  return this->doRequest(url, parameters, method, isPB);
+  if (body.length() != 0) {
+    request.setContent(utils::GzipHelper::compress(body), "",
+                       http::FormatType::RAW);
+    request.putHeaderParameter("Content-Type",
+                               "application/x-www-form-urlencoded");
+    request.putHeaderParameter("Content-Encoding", "gzip");
+  }
+  return request;
 }
 
 string CloudsearchClient::getNonce() {
@@ -130,85 +303,90 @@ string CloudsearchClient::getNonce() {
   return utils::ParameterHelper::md5hex(encoded) + "." + timeStr;
 }
 
-string CloudsearchClient::buildQuery(const std::map<string, string>& params) {
-  string query;
-  for (std::map<string, string>::const_iterator it = params.begin();
-       it != params.end(); it++) {
-    query += '&' + auth::UrlEncoder::encode(it->first);
-    query += '=' + auth::UrlEncoder::encode(it->second);
-  }
-  return query.substr(1);
-}
-
-string CloudsearchClient::doSign(std::map<string, string>* params) {
-  bool hasSignMode = false;
-  string itemsValue;
-  std::map<string, string>::iterator sign = params->find("sign_mode");
-  std::map<string, string>::iterator items = params->find("items");
-  if (sign != params->end() && sign->second == "1" && items != params->end()) {
-    hasSignMode = true;
-    itemsValue = items->second;
-    params->erase(items);
-  }
+void CloudsearchClient::buildQuery(const SignedParams& params,
+                                   const char* skipKey, string* query) {
+  size_t size = 0;
+  params.visit(skipKey, [&size](const string& key, const string& value) {
+    size += auth::UrlEncoder::encodedLength(key)
+        + auth::UrlEncoder::encodedLength(value) + 2;
+  });
 
-  string query = buildQuery(*params) + this->clientSecret_;
-  string enc = utils::StringUtils::ToEncoding(query, "UTF-8");
-  string md5 = utils::ParameterHelper::md5hex(enc);
-  if (hasSignMode) {
-    (*params)["items"] = itemsValue;
-  }
-  return md5;
+  query->reserve(query->length() + size);
+  bool first = true;
+  params.visit(skipKey, [query, &first](const string& key,
+                                        const string& value) {
+    if (!first) {
+      *query += '&';
+    }
+    first = false;
+    auth::UrlEncoder::appendEncoded(key, query);
+    *query += '=';
+    auth::UrlEncoder::appendEncoded(value, query);
+  });
 }
 
-string CloudsearchClient::buildHttpParameterString(
-    const std::map<string, string>& params) {
-  if (params.size() == 0) {
-    return "";
-  }
-  string str;
-  for (std::map<string, string>::const_iterator it = params.begin();
-       it != params.end(); ++it) {
-    string key = auth::UrlEncoder::percentEncode(it->first);
-    string val = auth::UrlEncoder::percentEncode(it->second);
-    str += "&" + key + "=" + val;
-  }
-  return "?" + str.substr(1);
-}
-
-string CloudsearchClient::getAliyunSign(std::map<string, string>* params,
-                                        string method) {
-  bool hasSignMode = false;
-  string itemsValue;
-  std::map<string, string>::iterator sign = params->find("sign_mode");
-  std::map<string, string>::iterator items = params->find("items");
-  if (sign != params->end() && sign->second == "1" && items != params->end()) {
-    hasSignMode = true;
-    itemsValue = items->second;
-    params->erase(items);
-  }
+// items are left out of the signature if sign_mode is 1.
+static const char* getSignSkipKey(const string* signMode,
+                                  const string* items) {
+  bool skipItems = signMode != NULL && *signMode == "1" && items != NULL;
+  return skipItems ? "items" : NULL;
+}
+
+string CloudsearchClient::doSign(const SignedParams& params) {
+  const char* skipKey = getSignSkipKey(params.find("sign_mode"),
+                                       params.find("items"));
+  // reused by the calls of this thread, keeps its capacity.
+  static thread_local string query;
+  query.clear();
+  buildQuery(params, skipKey, &query);
+  query += this->clientSecret_;
+  return utils::ParameterHelper::md5hex(query);
+}
 
-  string strToSign = buildQuery(*params);
-  strToSign = method + "&%2F&"
-      + auth::UrlEncoder::percentEncode(strToSign);
-  string signature = auth::HmacSha1::getInstance()->signString(
-      strToSign, this->secret_ + "&");
+void CloudsearchClient::buildHttpParameterString(const SignedParams& params,
+                                                 const char* skipKey,
+                                                 string* url) {
+  size_t size = 0;
+  params.visit(skipKey, [&size](const string& key, const string& value) {
+    size += auth::UrlEncoder::encodedLength(key)
+        + auth::UrlEncoder::encodedLength(value) + 2;
+  });
 
-  if (hasSignMode) {
-    (*params)["items"] = itemsValue;
-  }
-  return signature;
+  url->reserve(url->length() + size);
+  char separator = '?';
+  params.visit(skipKey, [url, &separator](const string& key,
+                                          const string& value) {
+    *url += separator;
+    separator = '&';
+    auth::UrlEncoder::appendPercentEncoded(key, url);
+    *url += '=';
+    auth::UrlEncoder::appendPercentEncoded(value, url);
+  });
 }
 
-string CloudsearchClient::doRequest(string url,
-                                    const std::map<string, string>& params,
-                                    string method, bool isPB) {
-  url = url + buildHttpParameterString(params);
-  http::HttpRequest request(url);
-  request.setMethod(method);
+string CloudsearchClient::getAliyunSign(const SignedParams& params,
+                                        const string& method) {
+  const char* skipKey = getSignSkipKey(params.find("sign_mode"),
+                                       params.find("items"));
+  // reused by the calls of this thread, keep their capacity.
+  static thread_local string query;
+  static thread_local string strToSign;
+  query.clear();
+  buildQuery(params, skipKey, &query);
 
-  http::HttpResponse response = http::HttpResponse::getResponse(request);
+  strToSign.clear();
+  strToSign.reserve(method.length() + 5
+                    + auth::UrlEncoder::encodedLength(query));
+  strToSign += method;
+  strToSign += "&%2F&";
+  auth::UrlEncoder::appendPercentEncoded(query, &strToSign);
+  return aliyunKey_.signString(strToSign);
+}
 
-  string result = response.getContent();
+string CloudsearchClient::getResult(http::HttpResponse* response,
+                                    bool isPB) {
+  string result;
+  result.swap(response->content());
   if (isPB) {
     // TODO(xu): handle response content encoding.
   }
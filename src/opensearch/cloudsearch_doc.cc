@@ -17,13 +17,6 @@
  * under the License.
  */
 
-#include <fstream>
-#ifdef _MSC_VER
-#include <windows.h>
-#else  //  _MSC_VER
-#include <unistd.h>
-#endif  //  _MSC_VER
-
 #include "aliyun/utils/string_utils.h"
 #include "aliyun/opensearch/cloudsearch_doc.h"
 #include "aliyun/opensearch/cloudsearch_client.h"
@@ -49,26 +42,20 @@ const string CloudsearchDoc::HA_DOC_MULTI_VALUE_SEPARATOR = "\x1D";
 const string CloudsearchDoc::HA_DOC_SECTION_WEIGHT = "\x1C";
 
 CloudsearchDoc::CloudsearchDoc(string indexName, ClientRef client) {
-  this->indexName_ = indexName;
+  this->indexName_ = std::move(indexName);
   this->client_ = &client;
   this->path_ = "/index/doc/" + this->indexName_;
+  this->rateLimiter_ = NULL;
 }
 
-string CloudsearchDoc::detail(string docId) {
+string CloudsearchDoc::detail(const string& docId) {
   std::map<string, string> params;
   params["id"] = docId;
   return client_->call(this->path_, params, CloudsearchClient::METHOD_POST,
                        this->debugInfo_);
 }
 
-static bool isNotBlank(string str) {
-  if (str.length() != 0 && utils::StringUtils::trim(str).length() != 0) {
-    return true;
-  }
-  return false;
-}
-
-void CloudsearchDoc::operate(string cmd,
+void CloudsearchDoc::operate(const string& cmd,
                              const std::map<string, string>& fields) {
   object::SingleDoc doc(cmd, fields);
   requestArray_.push_back(doc.getJsonString());
@@ -87,9 +74,17 @@ void CloudsearchDoc::remove(const std::map<string, string>& fields) {
 }
 
 static string toJsonArray(const std::vector<string>& vec) {
-  string jsonArray = "[";
+  size_t size = 2;
   for (size_t i = 0; i < vec.size(); i++) {
-    jsonArray += vec[i] + ',';
+    size += vec[i].length() + 1;
+  }
+
+  string jsonArray;
+  jsonArray.reserve(size);
+  jsonArray += '[';
+  for (size_t i = 0; i < vec.size(); i++) {
+    jsonArray += vec[i];
+    jsonArray += ',';
   }
   if (jsonArray.length() > 1) {
     jsonArray.resize(jsonArray.length() - 1);
@@ -98,13 +93,21 @@ static string toJsonArray(const std::vector<string>& vec) {
   return jsonArray;
 }
 
-string CloudsearchDoc::push(string tableName) {
+std::map<string, string> CloudsearchDoc::buildPushParams(
+    string docs, const string& tableName) {
   std::map<string, string> params;
 
   params["action"] = "push";
-  params["items"] = toJsonArray(this->requestArray_);
+  params["items"] = std::move(docs);
   params["table_name"] = tableName;
   params["sign_mode"] = utils::StringUtils::ToString(SIGN_MODE);
+  return params;
+}
+
+string CloudsearchDoc::push(const string& tableName) {
+  std::map<string, string> params = buildPushParams(
+      toJsonArray(this->requestArray_), tableName);
+  throttle(params["items"]);
 
   string result = this->client_->call(this->path_, params,
                                       CloudsearchClient::METHOD_POST,
@@ -114,115 +117,73 @@ string CloudsearchDoc::push(string tableName) {
   return result;
 }
 
-string CloudsearchDoc::push(string docs, string tableName) {
-  std::map<string, string> params;
-
-  params["action"] = "push";
-  params["items"] = docs;
-  params["table_name"] = tableName;
-  params["sign_mode"] = utils::StringUtils::ToString(SIGN_MODE);
+string CloudsearchDoc::push(string docs, const string& tableName) {
+  std::map<string, string> params = buildPushParams(std::move(docs),
+                                                    tableName);
+  throttle(params["items"]);
 
   return this->client_->call(this->path_, params,
                              CloudsearchClient::METHOD_POST, this->debugInfo_);
 }
 
-string CloudsearchDoc::pushHADocFile(string filePath, string tableName) {
+std::future<string> CloudsearchDoc::pushAsync(const string& tableName) {
+  std::map<string, string> params = buildPushParams(
+      toJsonArray(this->requestArray_), tableName);
+  throttle(params["items"]);
+
+  std::future<string> result = this->client_->callAsync(
+      this->path_, params, CloudsearchClient::METHOD_POST, false,
+      this->debugInfo_);
+  this->debugInfo_ += params["items"];
+  this->requestArray_.clear();
+  return result;
+}
+
+std::future<string> CloudsearchDoc::pushAsync(string docs,
+                                              const string& tableName) {
+  std::map<string, string> params = buildPushParams(std::move(docs),
+                                                    tableName);
+  throttle(params["items"]);
+
+  return this->client_->callAsync(this->path_, params,
+                                  CloudsearchClient::METHOD_POST, false,
+                                  this->debugInfo_);
+}
+
+string CloudsearchDoc::pushHADocFile(const string& filePath,
+                                     const string& tableName) {
   return pushHADocFile(filePath, tableName, 0);
 }
 
-string CloudsearchDoc::pushHADocFile(string filePath, string tableName,
-                                     int64_t offset) {
-  object::DocItems docItems;
-  object::SingleDoc singleDoc;
-
-  string lastField;
-  string lastKey;
-  uint64_t totalSize = 0;
-
-  std::queue<time_t> timeLimitQueue;
-  timeLimitQueue.push(::time(NULL));
-
-  string result;
-
-  std::ifstream input(filePath);
-  string line;
-  int64_t lineNumber = 1;  // line number
-  int lastLineNumber = 0;  // last successfully pushed line number
-
-  while (input >> line) {
-    if (lineNumber < offset) {
-      lineNumber++;
-      continue;
-    }
-
-    string separator = line.substr(line.length() - 1);
-
-    if (separator == HA_DOC_ITEM_SEPARATOR) {  // foreach doc
-      lastField = "";
-      string jstr = singleDoc.getJsonString();
-      int currentSize = auth::UrlEncoder::encode(jstr).length();
-      // FIXME(xu): why not += ?
-      totalSize = UrlEncoder::encode(docItems.getJsonString()).length();
-      if (currentSize + totalSize >= PUSH_MAX_SIZE) {
-        timeLimitCheck(&timeLimitQueue);
-        result = this->push(docItems.getJsonString(), tableName);
-        string status = "status";
-        string::size_type pos = result.find(status);
-        if (pos != string::npos
-            && result.substr(pos + status.length() + 1).find("OK") != 0) {
-          return "last push not OK, line "
-              + utils::StringUtils::ToString(lastLineNumber);
-        }
-        lastLineNumber = lineNumber;
-        docItems = object::DocItems();
-      }
-      docItems.addDoc(singleDoc);
-      singleDoc = object::SingleDoc();
-    } else if (separator == HA_DOC_FIELD_SEPARATOR) {  // foreach field
-      string detail = line.substr(0, line.length() - 1);
-      if (isNotBlank(lastField)) {
-        singleDoc.addField(lastKey, lastField + detail);
-      } else {
-        string::size_type middleIndex = detail.find("=");
-        if (middleIndex != string::npos) {
-          string key = detail.substr(0, middleIndex);
-          string val = detail.substr(middleIndex + 1);
-          if (key == "CMD") {
-            singleDoc.setCommand(val);
-          } else {
-            singleDoc.addField(key, val);
-          }
-        }
-      }
-
-      lastField = "";
-    } else {
-      if (isNotBlank(lastField)) {
-        lastField += lastField + line;
-      }
-    }
-
-    lineNumber++;
+string CloudsearchDoc::pushHADocFile(const string& filePath,
+                                     const string& tableName, int64_t offset) {
+  return pushHADocFile(filePath, tableName, offset, HaDocImporter::Options());
+}
+
+string CloudsearchDoc::pushHADocFile(const string& filePath,
+                                     const string& tableName, int64_t offset,
+                                     const HaDocImporter::Options& options) {
+  HaDocImporter::Options importOptions = options;
+  if (importOptions.rateLimiter == NULL) {
+    importOptions.rateLimiter = this->rateLimiter_;
   }
-  result = this->push(docItems.getJsonString(), tableName);
-  return result;
+  HaDocImporter importer(this->indexName_, *this->client_, importOptions);
+  return importer.import(filePath, tableName, offset);
 }
 
-void CloudsearchDoc::timeLimitCheck(std::queue<time_t>* timeLimitQueue) {
-  if (timeLimitQueue->size() < PUSH_FREQUENCE) {
-    timeLimitQueue->push(::time(NULL));
+void CloudsearchDoc::timeLimitCheck(
+    std::queue<time_t>* /* timeLimitQueue */) {
+  static utils::RateLimiter defaultLimiter(PUSH_FREQUENCE);
+  if (this->rateLimiter_ != NULL) {
+    this->rateLimiter_->acquire();
   } else {
-    time_t firstTime = timeLimitQueue->front();
-    timeLimitQueue->pop();
-    time_t currentTime = ::time(NULL);
-    time_t delta = currentTime - firstTime;
-    if (delta < 1000) {  // sleep a duration
-#ifdef _MSC_VER
-      ::Sleep(delta);
-#else  // _MSC_VER
-      ::usleep(delta * 1000);
-#endif  // _MSC_VER
-    }
+    defaultLimiter.acquire();
+  }
+}
+
+void CloudsearchDoc::throttle(const string& docs) {
+  if (this->rateLimiter_ != NULL) {
+    this->rateLimiter_->acquire(UrlEncoder::encodedLength(docs));
   }
 }
 
@@ -27,13 +27,14 @@ using std::string;
 using utils::StringUtils::ToString;
 
 CloudsearchIndex::CloudsearchIndex(std::string indexName, ClientRef client) {
-  this->indexName_ = indexName;
+  this->indexName_ = std::move(indexName);
   this->client_ = &client;
   this->path_ = "/index/" + this->indexName_;
 }
 
 std::string CloudsearchIndex::createByTemplateName(
-    std::string templateName, const std::map<std::string, std::string> &opts) {
+    const std::string& templateName,
+    const std::map<std::string, std::string> &opts) {
   map<string, string> params;
   params["action"] = "create";
   params["template"] = templateName;
@@ -53,13 +54,15 @@ std::string CloudsearchIndex::createByTemplateName(
 }
 
 
-std::string CloudsearchIndex::createByTemplateName(std::string templateName) {
+std::string CloudsearchIndex::createByTemplateName(
+    const std::string& templateName) {
   map<string, string> emptyMap;
   return createByTemplateName(templateName, emptyMap);
 }
 
 std::string CloudsearchIndex::rename(
-    std::string toIndexName, const std::map<std::string, std::string> &opts) {
+    const std::string& toIndexName,
+    const std::map<std::string, std::string> &opts) {
   map<string, string> params;
 
   params["action"] = "update";
@@ -109,8 +112,8 @@ std::string CloudsearchIndex::listIndexes(int page, int pageSize) {
                              CloudsearchClient::METHOD_GET, this->debugInfo_);
 }
 
-std::string CloudsearchIndex::createTask(std::string operate,
-                                         std::string tableName,
+std::string CloudsearchIndex::createTask(const std::string& operate,
+                                         const std::string& tableName,
                                          bool needBuild) {
   std::map<string, string> params;
   params["action"] = "createTask";
@@ -130,7 +133,7 @@ std::string CloudsearchIndex::createBuildTask() {
   return createTask("build", "", false);
 }
 
-std::string CloudsearchIndex::createImportTask(std::string tableName,
+std::string CloudsearchIndex::createImportTask(const std::string& tableName,
                                                bool needBuild) {
   return createTask("import", tableName, needBuild);
 }
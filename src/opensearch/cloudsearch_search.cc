@@ -113,11 +113,80 @@ CloudsearchSearch::CloudsearchSearch(ClientRef client) {
   this->initCustomConfigMap();
 }
 
+namespace {
+
+class SearchResultSink : public http::BodySink {
+ public:
+  explicit SearchResultSink(object::SearchResult::StreamParser* parser)
+      : parser_(parser) {
+  }
+
+  void onBegin() {
+    parser_->begin();
+  }
+
+  void onData(const char* data, size_t size) {
+    parser_->feed(data, size);
+  }
+
+  void onEnd() {
+    parser_->finish();
+  }
+
+ private:
+  object::SearchResult::StreamParser* parser_;
+};
+
+}  // namespace
+
 std::string CloudsearchSearch::search(SummaryMap& opts) {
   this->extract(opts, SearchTypeEnum::SEARCH);
   return this->call(SearchTypeEnum::SEARCH);
 }
 
+std::string CloudsearchSearch::search(SummaryMap& opts,
+                                      const utils::Deadline& deadline) {
+  this->extract(opts, SearchTypeEnum::SEARCH);
+  return this->call(SearchTypeEnum::SEARCH, deadline);
+}
+
+std::string CloudsearchSearch::search(const utils::Deadline& deadline) {
+  SummaryMap emptyMap;
+  return this->search(emptyMap, deadline);
+}
+
+void CloudsearchSearch::search(SummaryMap& opts,
+                               object::SearchResult* result) {
+  this->search(opts, utils::Deadline(), result);
+}
+
+void CloudsearchSearch::search(SummaryMap& opts,
+                               const utils::Deadline& deadline,
+                               object::SearchResult* result) {
+  this->extract(opts, SearchTypeEnum::SEARCH);
+  std::map<std::string, std::string> params =
+      buildParams(SearchTypeEnum::SEARCH);
+  // the typed result is read from json only.
+  params["format"] = "json";
+
+  // the result is parsed while it is received.
+  object::SearchResult::StreamParser parser(result);
+  SearchResultSink sink(&parser);
+  this->client_->call(this->path_, params, CloudsearchClient::METHOD_GET,
+                      this->debugInfo_, deadline, &sink);
+}
+
+void CloudsearchSearch::search(object::SearchResult* result) {
+  SummaryMap emptyMap;
+  this->search(emptyMap, result);
+}
+
+void CloudsearchSearch::search(const utils::Deadline& deadline,
+                               object::SearchResult* result) {
+  SummaryMap emptyMap;
+  this->search(emptyMap, deadline, result);
+}
+
 void CloudsearchSearch::extract(SummaryMap& opts, SearchTypeEnum type) {
   if (opts.size() > 0) {
     SummaryMap::iterator pos = opts.find("config");
@@ -217,10 +286,10 @@ void CloudsearchSearch::extract(SummaryMap& opts, SearchTypeEnum type) {
 }
 
 void CloudsearchSearch::addIndex(std::string indexName) {
-  this->indexes_.push_back(indexName);
+  this->indexes_.push_back(std::move(indexName));
 }
 
-void CloudsearchSearch::removeIndex(std::string indexName) {
+void CloudsearchSearch::removeIndex(const std::string& indexName) {
   std::vector<std::string> buffer;
   for (size_t i = 0; i < this->indexes_.size(); ++i) {
     if (this->indexes_[i] != indexName) {
@@ -230,9 +299,9 @@ void CloudsearchSearch::removeIndex(std::string indexName) {
   this->indexes_.swap(buffer);
 }
 
-bool CloudsearchSearch::addSummary(std::string fieldName, int len,
-                                   std::string element, std::string ellipsis,
-                                   int snippet) {
+bool CloudsearchSearch::addSummary(const std::string& fieldName, int len,
+                                   const std::string& element,
+                                   const std::string& ellipsis, int snippet) {
   if (fieldName.length() == 0) {
     return false;
   }
@@ -255,14 +324,14 @@ bool CloudsearchSearch::addSummary(std::string fieldName, int len,
   return true;
 }
 
-bool CloudsearchSearch::addSummary(std::string fieldName) {
+bool CloudsearchSearch::addSummary(const std::string& fieldName) {
   return this->addSummary(fieldName, 0, "", "", 0);
 }
 
-bool CloudsearchSearch::addSummary(std::string fieldName, int len,
-                                   std::string ellipsis, int snippet,
-                                   std::string elementPrefix,
-                                   std::string elementPostfix) {
+bool CloudsearchSearch::addSummary(const std::string& fieldName, int len,
+                                   const std::string& ellipsis, int snippet,
+                                   const std::string& elementPrefix,
+                                   const std::string& elementPostfix) {
   if (fieldName.length() == 0) {
     return false;
   }
@@ -280,7 +349,7 @@ bool CloudsearchSearch::addSummary(std::string fieldName, int len,
 }
 
 CloudsearchSearch::SummaryMap CloudsearchSearch::getSummary(
-    std::string fieldName) {
+    const std::string& fieldName) {
   StringSummaryMap::iterator pos = this->summary_.find(fieldName);
   if (pos != this->summary_.end()) {
     return pos->second;
@@ -292,11 +361,13 @@ std::string CloudsearchSearch::getSummaryString() {
   return utils::StringUtils::ToString(this->summary_);
 }
 
-bool CloudsearchSearch::addAggregate(std::string groupKey, std::string aggFun,
-                                     std::string range, std::string maxGroup,
-                                     std::string aggFilter,
-                                     std::string aggSamplerThresHold,
-                                     std::string aggSamplerStep) {
+bool CloudsearchSearch::addAggregate(const std::string& groupKey,
+                                     const std::string& aggFun,
+                                     const std::string& range,
+                                     const std::string& maxGroup,
+                                     const std::string& aggFilter,
+                                     const std::string& aggSamplerThresHold,
+                                     const std::string& aggSamplerStep) {
   if (groupKey.length() == 0 || aggFun.length() == 0) {
     return false;
   }
@@ -387,10 +458,11 @@ int CloudsearchSearch::getStartHit() {
   return 0;
 }
 
-bool CloudsearchSearch::addDistinct(std::string key, int distCount,
-                                    int distTimes, std::string reserved,
-                                    std::string distFilter,
-                                    std::string updateTotalHit, double grade) {
+bool CloudsearchSearch::addDistinct(const std::string& key, int distCount,
+                                    int distTimes, const std::string& reserved,
+                                    const std::string& distFilter,
+                                    const std::string& updateTotalHit,
+                                    double grade) {
   if (key.length() == 0) {
     return false;
   }
@@ -458,18 +530,23 @@ std::string CloudsearchSearch::getDisableFunctions() {
   return "";
 }
 
-void CloudsearchSearch::addFilter(std::string filter, std::string op) {
-  if (op.length() == 0) {
-    op = "AND";
-  }
+void CloudsearchSearch::addFilter(const std::string& filter,
+                                  const std::string& op) {
   if (filter_.length() == 0) {
     filter_ = filter;
   } else {
-    filter_ += ' ' + op + ' ' + filter;
+    filter_ += ' ';
+    if (op.length() != 0) {
+      filter_ += op;
+    } else {
+      filter_ += "AND";
+    }
+    filter_ += ' ';
+    filter_ += filter;
   }
 }
 
-static bool isNotBlank(string str) {
+static bool isNotBlank(const string& str) {
   if (str.length() != 0 && utils::StringUtils::trim(str).length() != 0) {
     return true;
   }
@@ -477,6 +554,33 @@ static bool isNotBlank(string str) {
 }
 
 std::string CloudsearchSearch::call(SearchTypeEnum type) {
+  return this->call(type, utils::Deadline());
+}
+
+std::string CloudsearchSearch::call(SearchTypeEnum type,
+                                    const utils::Deadline& deadline) {
+  std::map<std::string, std::string> params = buildParams(type);
+  bool isPB = "protobuf" == getFormat();
+  return this->client_->call(this->path_, params,
+                             CloudsearchClient::METHOD_GET,
+                             isPB, this->debugInfo_, deadline);
+}
+
+std::future<std::string> CloudsearchSearch::callAsync(SearchTypeEnum type) {
+  return this->callAsync(type, utils::Deadline());
+}
+
+std::future<std::string> CloudsearchSearch::callAsync(
+    SearchTypeEnum type, const utils::Deadline& deadline) {
+  std::map<std::string, std::string> params = buildParams(type);
+  bool isPB = "protobuf" == getFormat();
+  return this->client_->callAsync(this->path_, params,
+                                  CloudsearchClient::METHOD_GET,
+                                  isPB, this->debugInfo_, deadline);
+}
+
+std::map<std::string, std::string> CloudsearchSearch::buildParams(
+    SearchTypeEnum type) {
   std::map<std::string, std::string> params;
 
   std::string haQuery = "";
@@ -566,10 +670,7 @@ std::string CloudsearchSearch::call(SearchTypeEnum type) {
       params[it->first] = it->second;
     }
   }
-  bool isPB = "protobuf" == getFormat();
-  return this->client_->call(this->path_, params,
-                             CloudsearchClient::METHOD_GET,
-                             isPB, this->debugInfo_);
+  return params;
 }
 
 std::string CloudsearchSearch::clauseConfig() {
@@ -594,7 +695,8 @@ void CloudsearchSearch::disableQp(
   }
   this->disable_["qp"] = processorConfig.substr(1);
 }
-std::string CloudsearchSearch::getIndexInQp(std::vector<std::string> indexes) {
+std::string CloudsearchSearch::getIndexInQp(
+    const std::vector<std::string>& indexes) {
   std::string indexNames = "";
   for (size_t i = 0; i < indexes.size(); ++i) {
     indexNames += '|' + indexes[i];
@@ -625,7 +727,7 @@ void CloudsearchSearch::clear() {
   initCustomConfigMap();
 }
 
-void CloudsearchSearch::removeDistinct(std::string distinctKey) {
+void CloudsearchSearch::removeDistinct(const std::string& distinctKey) {
   StringSummaryMap &distinct = this->getDistinct();
   if (distinct.find(distinctKey) != distinct.end()) {
     distinct.erase(distinctKey);
@@ -637,6 +739,28 @@ std::string CloudsearchSearch::search() {
   return this->search(emptyMap);
 }
 
+std::future<std::string> CloudsearchSearch::searchAsync(SummaryMap& opts) {
+  this->extract(opts, SearchTypeEnum::SEARCH);
+  return this->callAsync(SearchTypeEnum::SEARCH);
+}
+
+std::future<std::string> CloudsearchSearch::searchAsync() {
+  SummaryMap emptyMap;
+  return this->searchAsync(emptyMap);
+}
+
+std::future<std::string> CloudsearchSearch::searchAsync(
+    SummaryMap& opts, const utils::Deadline& deadline) {
+  this->extract(opts, SearchTypeEnum::SEARCH);
+  return this->callAsync(SearchTypeEnum::SEARCH, deadline);
+}
+
+std::future<std::string> CloudsearchSearch::searchAsync(
+    const utils::Deadline& deadline) {
+  SummaryMap emptyMap;
+  return this->searchAsync(emptyMap, deadline);
+}
+
 std::string CloudsearchSearch::scroll(SummaryMap& opts) {
   this->extract(opts, SearchTypeEnum::SCROLL);
   return this->call(SearchTypeEnum::SCROLL);
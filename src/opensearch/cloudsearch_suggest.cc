@@ -27,21 +27,44 @@ using std::string;
 CloudsearchSuggest::CloudsearchSuggest(string indexName, string suggestName,
                                        ClientRef client) {
   client_ = &client;
-  indexName_ = indexName;
-  suggestName_ = suggestName;
+  indexName_ = std::move(indexName);
+  suggestName_ = std::move(suggestName);
   hit_ = 10;
   path_ = "/suggest";
 }
 
 std::string CloudsearchSuggest::search() {
+  std::map<std::string, std::string> params = buildParams();
+  return this->client_->call(this->path_, params,
+                             CloudsearchClient::METHOD_GET, this->debugInfo_);
+}
+
+std::string CloudsearchSuggest::search(const utils::Deadline& deadline) {
+  std::map<std::string, std::string> params = buildParams();
+  return this->client_->call(this->path_, params,
+                             CloudsearchClient::METHOD_GET, false,
+                             this->debugInfo_, deadline);
+}
+
+std::future<std::string> CloudsearchSuggest::searchAsync() {
+  return this->searchAsync(utils::Deadline());
+}
+
+std::future<std::string> CloudsearchSuggest::searchAsync(
+    const utils::Deadline& deadline) {
+  std::map<std::string, std::string> params = buildParams();
+  return this->client_->callAsync(this->path_, params,
+                                  CloudsearchClient::METHOD_GET, false,
+                                  this->debugInfo_, deadline);
+}
+
+std::map<std::string, std::string> CloudsearchSuggest::buildParams() {
   std::map<std::string, std::string> params;
   params["index_name"] = this->indexName_;
   params["suggest_name"] = this->suggestName_;
   params["hit"] = utils::StringUtils::ToString(this->hit_);
   params["query"] = this->query_;
-
-  return this->client_->call(this->path_, params,
-                             CloudsearchClient::METHOD_GET, this->debugInfo_);
+  return params;
 }
 
 std::string CloudsearchSuggest::getIndexName() {
@@ -64,7 +87,7 @@ int CloudsearchSuggest::getHit() {
 }
 
 void CloudsearchSuggest::setQuery(std::string query) {
-  this->query_ = query;
+  this->query_ = std::move(query);
 }
 
 std::string CloudsearchSuggest::getQuery() {
@@ -0,0 +1,537 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/opensearch/ha_doc_importer.h"
+
+#include <stdio.h>
+#ifdef _MSC_VER
+#include <io.h>
+#include <windows.h>
+#else  // _MSC_VER
+#include <unistd.h>
+#endif  // _MSC_VER
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "aliyun/auth/url_encoder.h"
+#include "aliyun/opensearch/cloudsearch_client.h"
+#include "aliyun/opensearch/cloudsearch_doc.h"
+#include "aliyun/opensearch/object/doc_items.h"
+#include "aliyun/reader/json_reader.h"
+#include "aliyun/utils/mapped_file.h"
+#include "aliyun/utils/parameter_helper.h"
+#include "aliyun/utils/string_utils.h"
+
+namespace aliyun {
+namespace opensearch {
+
+using std::string;
+
+// docs per chunk handed from parser to encoders.
+static const size_t DOCS_PER_CHUNK = 256;
+
+// bytes before the checkpoint hashed into it, a rewritten file is not
+// resumed even if its size and mtime match.
+static const size_t CHECKPOINT_HASH_WINDOW = 4096;
+
+HaDocImporter::Options::Options()
+    : encodeThreads(2),
+      pushThreads(1),
+      maxBatchSize(CloudsearchDoc::PUSH_MAX_SIZE),
+      pushFrequence(CloudsearchDoc::PUSH_FREQUENCE),
+      rateLimiter(NULL),
+      queueCapacity(8),
+      checkpointInterval(1000) {
+}
+
+HaDocImporter::HaDocImporter(string indexName, ClientRef client,
+                             const Options& options)
+    : indexName_(std::move(indexName)),
+      client_(&client),
+      options_(options),
+      file_(NULL),
+      parsed_(options.queueCapacity),
+      batches_(options.queueCapacity),
+      nextEncoded_(0),
+      totalChunks_(-1),
+      nextAck_(0),
+      checkpoint_(0),
+      checkpointOffset_(0),
+      pushedDocs_(0),
+      lastResultSeq_(-1),
+      failed_(false),
+      lastSave_(),
+      savedOffset_(0),
+      ownLimiter_(options.pushFrequence),
+      limiter_(options.rateLimiter ? options.rateLimiter : &ownLimiter_),
+      throttleMillis_(0) {
+  if (options_.encodeThreads < 1) {
+    options_.encodeThreads = 1;
+  }
+  if (options_.pushThreads < 1) {
+    options_.pushThreads = 1;
+  }
+}
+
+string HaDocImporter::import(const string& filePath, const string& tableName,
+                             int64_t offset) {
+  // every import starts over, queues were closed by the previous one.
+  parsed_.reopen();
+  batches_.reopen();
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    encoded_.clear();
+    nextEncoded_ = 0;
+    totalChunks_ = -1;
+    acked_.clear();
+    nextAck_ = 0;
+    checkpoint_ = 0;
+    checkpointOffset_ = 0;
+    pushedDocs_ = 0;
+    lastResultSeq_ = -1;
+    lastResult_.clear();
+    failed_ = false;
+    failResult_.clear();
+    error_ = std::exception_ptr();
+    throttleMillis_ = 0;
+  }
+  lastSave_ = std::chrono::steady_clock::time_point();
+
+  // docs are sliced from the mapping, it must outlive all stages.
+  utils::MappedFile file(filePath);
+  filePath_ = filePath;
+  file_ = &file;
+
+  loadCheckpoint();
+  savedOffset_ = checkpointOffset_;
+  size_t resumeOffset = checkpointOffset_;
+  int64_t resumeLine = checkpoint_;
+  if (offset - 1 > checkpoint_) {
+    checkpoint_ = offset - 1;
+  }
+
+  std::vector<std::thread> workers;
+  workers.push_back(std::thread(&HaDocImporter::parse, this, file.data(),
+                                file.size(), offset, resumeOffset,
+                                resumeLine));
+  for (int i = 0; i < options_.encodeThreads; i++) {
+    workers.push_back(std::thread(&HaDocImporter::encode, this));
+  }
+  for (int i = 0; i < options_.pushThreads; i++) {
+    workers.push_back(std::thread(&HaDocImporter::push, this, tableName));
+  }
+
+  pack();  // keeps file order, so run on one thread
+
+  batches_.close();
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+  saveCheckpoint(true);
+
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  if (failed_) {
+    return "last push not OK, line " + utils::StringUtils::ToString(checkpoint_);
+  }
+  return lastResult_;
+}
+
+int64_t HaDocImporter::getCheckpoint() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return checkpoint_;
+}
+
+size_t HaDocImporter::getCheckpointOffset() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return checkpointOffset_;
+}
+
+long HaDocImporter::getThrottleMillis() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return throttleMillis_;
+}
+
+int64_t HaDocImporter::getPushedDocs() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return pushedDocs_;
+}
+
+string HaDocImporter::getLastResult() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return failed_ ? failResult_ : lastResult_;
+}
+
+void HaDocImporter::parse(const char* data, size_t size, int64_t offset,
+                          size_t resumeOffset, int64_t resumeLine) {
+  int64_t seq = 0;
+  try {
+    HaDocReader reader(data, size);
+    reader.seek(resumeOffset, resumeLine);
+    if (offset - 1 > resumeLine) {
+      reader.seekLine(offset);
+    }
+
+    Chunk chunk;
+    chunk.seq = seq;
+    HaDocReader::Doc doc;
+
+    while (reader.next(&doc)) {
+      chunk.docs.push_back(std::move(doc));
+      if (chunk.docs.size() >= DOCS_PER_CHUNK) {
+        if (!parsed_.push(std::move(chunk))) {
+          return;  // failed elsewhere
+        }
+        chunk = Chunk();
+        chunk.seq = ++seq;
+      }
+    }
+
+    if (chunk.docs.size() != 0) {
+      if (!parsed_.push(std::move(chunk))) {
+        return;
+      }
+      ++seq;
+    }
+  } catch (...) {
+    fail("", std::current_exception());
+  }
+
+  parsed_.close();
+  std::lock_guard<std::mutex> guard(mutex_);
+  totalChunks_ = seq;
+  cond_.notify_all();
+}
+
+void HaDocImporter::encode() {
+  try {
+    Chunk chunk;
+    while (parsed_.pop(&chunk)) {
+      if (failed()) {
+        continue;  // drain
+      }
+      chunk.jsons.resize(chunk.docs.size());
+      chunk.sizes.resize(chunk.docs.size());
+      chunk.lines.resize(chunk.docs.size());
+      chunk.offsets.resize(chunk.docs.size());
+      for (size_t i = 0; i < chunk.docs.size(); i++) {
+        chunk.docs[i].appendJson(&chunk.jsons[i]);
+        chunk.sizes[i] = auth::UrlEncoder::encodedLength(chunk.jsons[i]);
+        chunk.lines[i] = chunk.docs[i].line;
+        chunk.offsets[i] = chunk.docs[i].offset;
+      }
+      chunk.docs.clear();
+      if (!putEncoded(std::move(chunk))) {
+        break;
+      }
+    }
+  } catch (...) {
+    fail("", std::current_exception());
+  }
+}
+
+bool HaDocImporter::putEncoded(Chunk chunk) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // bound memory, but never block the chunk packer waiting for.
+  int64_t window = static_cast<int64_t>(options_.queueCapacity);
+  while (!failed_ && chunk.seq >= nextEncoded_ + window) {
+    cond_.wait(lock);
+  }
+  if (failed_) {
+    return false;
+  }
+  int64_t seq = chunk.seq;
+  encoded_[seq] = std::move(chunk);
+  cond_.notify_all();
+  return true;
+}
+
+bool HaDocImporter::takeEncoded(int64_t seq, Chunk* chunk) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    if (failed_) {
+      return false;
+    }
+    std::map<int64_t, Chunk>::iterator it = encoded_.find(seq);
+    if (it != encoded_.end()) {
+      *chunk = std::move(it->second);
+      encoded_.erase(it);
+      nextEncoded_ = seq + 1;
+      cond_.notify_all();
+      return true;
+    }
+    if (totalChunks_ >= 0 && seq >= totalChunks_) {
+      return false;  // all done
+    }
+    cond_.wait(lock);
+  }
+}
+
+void HaDocImporter::pack() {
+  object::DocItems docItems;
+  int64_t batchSeq = 0;
+  int64_t lastLine = 0;
+  size_t lastOffset = 0;
+
+  Chunk chunk;
+  for (int64_t seq = 0; takeEncoded(seq, &chunk); seq++) {
+    for (size_t i = 0; i < chunk.jsons.size(); i++) {
+      if (!docItems.empty()
+          && docItems.encodedSizeWith(chunk.sizes[i]) >= options_.maxBatchSize) {
+        Batch batch;
+        batch.seq = batchSeq++;
+        batch.items = docItems.getJsonArrayString();
+        batch.lastLine = lastLine;
+        batch.lastOffset = lastOffset;
+        batch.docs = docItems.size();
+        batch.size = docItems.encodedSize();
+        if (!batches_.push(std::move(batch))) {
+          return;
+        }
+        docItems.clear();
+      }
+      // the chunk is refilled by takeEncoded, move the json out of it.
+      docItems.addJson(std::move(chunk.jsons[i]), chunk.sizes[i]);
+      lastLine = chunk.lines[i];
+      lastOffset = chunk.offsets[i];
+    }
+  }
+
+  if (!docItems.empty() && !failed()) {
+    Batch batch;
+    batch.seq = batchSeq;
+    batch.items = docItems.getJsonArrayString();
+    batch.lastLine = lastLine;
+    batch.lastOffset = lastOffset;
+    batch.docs = docItems.size();
+    batch.size = docItems.encodedSize();
+    batches_.push(std::move(batch));
+  }
+}
+
+void HaDocImporter::push(const string& tableName) {
+  string path = "/index/doc/" + indexName_;
+  Batch batch;
+  while (batches_.pop(&batch)) {
+    if (failed()) {
+      continue;  // drain
+    }
+    try {
+      throttle(batch.size);
+      std::map<string, string> params = CloudsearchDoc::buildPushParams(
+          std::move(batch.items), tableName);
+      string debugInfo;
+      string result = client_->call(path, params,
+                                    CloudsearchClient::METHOD_POST,
+                                    false, debugInfo);
+      if (isPushOK(result)) {
+        ack(batch, result);
+        saveCheckpoint(false);
+      } else {
+        fail(result, std::exception_ptr());
+      }
+    } catch (...) {
+      fail("", std::current_exception());
+    }
+  }
+}
+
+void HaDocImporter::ack(const Batch& batch, const string& result) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (batch.seq > lastResultSeq_) {
+    lastResultSeq_ = batch.seq;
+    lastResult_ = result;
+  }
+
+  Batch& acked = acked_[batch.seq];
+  acked.seq = batch.seq;
+  acked.lastLine = batch.lastLine;
+  acked.lastOffset = batch.lastOffset;
+  acked.docs = batch.docs;
+
+  // checkpoint only moves over continuous acked batches.
+  std::map<int64_t, Batch>::iterator it;
+  while ((it = acked_.find(nextAck_)) != acked_.end()) {
+    checkpoint_ = it->second.lastLine;
+    checkpointOffset_ = it->second.lastOffset;
+    pushedDocs_ += it->second.docs;
+    acked_.erase(it);
+    nextAck_++;
+  }
+}
+
+void HaDocImporter::fail(const string& result, std::exception_ptr error) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!failed_) {  // keep the first failure
+      failed_ = true;
+      failResult_ = result;
+      error_ = error;
+    }
+    cond_.notify_all();
+  }
+  parsed_.close();
+  batches_.close();
+}
+
+void HaDocImporter::getFileIdentity(size_t offset,
+                                    std::map<string, string>* identity) const {
+  size_t start = offset > CHECKPOINT_HASH_WINDOW
+      ? offset - CHECKPOINT_HASH_WINDOW : 0;
+  (*identity)["file"] = filePath_;
+  (*identity)["size"] = utils::StringUtils::ToString(file_->size());
+  (*identity)["mtime"] = utils::StringUtils::ToString(file_->mtime());
+  (*identity)["md5"] = utils::ParameterHelper::md5hex(
+      string(file_->data() + start, offset - start));
+}
+
+bool HaDocImporter::loadCheckpoint() {
+  if (options_.checkpointFile.empty()) {
+    return false;
+  }
+  std::ifstream input(options_.checkpointFile.c_str());
+  if (!input.is_open()) {
+    return false;  // first run
+  }
+
+  // one "key=value" per line, the file path may have blanks.
+  std::map<string, string> entries;
+  string entry;
+  while (std::getline(input, entry)) {
+    string::size_type pos = entry.find('=');
+    if (pos != string::npos) {
+      entries[entry.substr(0, pos)] = entry.substr(pos + 1);
+    }
+  }
+  int64_t offset = -1;
+  int64_t line = -1;
+  std::istringstream(entries["offset"]) >> offset;
+  std::istringstream(entries["line"]) >> line;
+
+  // must be the start of a line in this file.
+  const char* data = file_->data();
+  if (offset < 0 || line < 0 || static_cast<size_t>(offset) > file_->size()
+      || (offset > 0 && data[offset - 1] != '\n')) {
+    return false;
+  }
+
+  // and written for this very file, not another or an older version of it.
+  std::map<string, string> identity;
+  getFileIdentity(static_cast<size_t>(offset), &identity);
+  for (std::map<string, string>::const_iterator it = identity.begin();
+       it != identity.end(); ++it) {
+    if (entries[it->first] != it->second) {
+      return false;
+    }
+  }
+  checkpointOffset_ = static_cast<size_t>(offset);
+  checkpoint_ = line;
+  return true;
+}
+
+void HaDocImporter::saveCheckpoint(bool force) {
+  if (options_.checkpointFile.empty()) {
+    return;
+  }
+  typedef std::chrono::steady_clock Clock;
+
+  std::lock_guard<std::mutex> saveGuard(saveMutex_);
+  Clock::time_point now = Clock::now();
+  if (!force && now - lastSave_
+      < std::chrono::milliseconds(options_.checkpointInterval)) {
+    return;
+  }
+
+  size_t offset;
+  int64_t line;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    offset = checkpointOffset_;
+    line = checkpoint_;
+  }
+  if (offset == savedOffset_) {
+    return;  // nothing new acked
+  }
+
+  // write a temp file then rename, never leave a half written checkpoint.
+  string tempFile = options_.checkpointFile + ".tmp";
+  FILE* output = ::fopen(tempFile.c_str(), "wb");
+  if (output == NULL) {
+    throw aliyun::Exception("can not write file: " + tempFile);
+  }
+  string content = "offset=" + utils::StringUtils::ToString(offset)
+      + "\nline=" + utils::StringUtils::ToString(line) + "\n";
+  std::map<string, string> identity;
+  getFileIdentity(offset, &identity);
+  for (std::map<string, string>::const_iterator it = identity.begin();
+       it != identity.end(); ++it) {
+    content += it->first + "=" + it->second + "\n";
+  }
+  bool ok = ::fputs(content.c_str(), output) >= 0 && ::fflush(output) == 0;
+#ifdef _MSC_VER
+  ok = ok && ::_commit(::_fileno(output)) == 0;
+#else  // _MSC_VER
+  ok = ok && ::fsync(::fileno(output)) == 0;
+#endif  // _MSC_VER
+  ok = ::fclose(output) == 0 && ok;
+#ifdef _MSC_VER
+  ok = ok && ::MoveFileExA(tempFile.c_str(), options_.checkpointFile.c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else  // _MSC_VER
+  ok = ok && ::rename(tempFile.c_str(), options_.checkpointFile.c_str()) == 0;
+#endif  // _MSC_VER
+  if (!ok) {
+    throw aliyun::Exception("can not write file: " + options_.checkpointFile);
+  }
+
+  savedOffset_ = offset;
+  lastSave_ = now;
+}
+
+bool HaDocImporter::failed() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return failed_;
+}
+
+void HaDocImporter::throttle(size_t bytes) {
+  long waited = limiter_->acquire(bytes);
+  if (waited > 0) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    throttleMillis_ += waited;
+  }
+}
+
+bool HaDocImporter::isPushOK(const string& result) {
+  try {
+    reader::JsonReader reader;
+    std::map<string, string> response = reader.read(result, "response");
+    std::map<string, string>::iterator it = response.find("response.status");
+    return it != response.end()
+        && it->second == CloudsearchDoc::PUSH_RETURN_STATUS_OK;
+  } catch (aliyun::Exception& e) {
+    return false;
+  }
+}
+
+}  // namespace opensearch
+}  // namespace aliyun
@@ -0,0 +1,291 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/opensearch/ha_doc_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ALIYUN_HA_DOC_READER_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif  // _MSC_VER
+
+namespace aliyun {
+namespace opensearch {
+
+using std::string;
+
+static const char ITEM_SEPARATOR = '\x1E';
+static const char FIELD_SEPARATOR = '\x1F';
+static const char MULTI_VALUE_SEPARATOR = '\x1D';
+
+#ifdef ALIYUN_HA_DOC_READER_SSE2
+
+static inline int lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<int>(index);
+#else  // _MSC_VER
+  return __builtin_ctz(mask);
+#endif  // _MSC_VER
+}
+
+static inline int bitCount(unsigned mask) {
+  mask = mask - ((mask >> 1) & 0x5555);
+  mask = (mask & 0x3333) + ((mask >> 2) & 0x3333);
+  mask = (mask + (mask >> 4)) & 0x0F0F;
+  return static_cast<int>((mask + (mask >> 8)) & 0x1F);
+}
+
+#endif  // ALIYUN_HA_DOC_READER_SSE2
+
+// first item or field separator in [p, end), end if none.
+static const char* findSeparator(const char* p, const char* end) {
+#ifdef ALIYUN_HA_DOC_READER_SSE2
+  // \x1E and \x1F only differ in the lowest bit, one compare for both.
+  const __m128i lowBit = _mm_set1_epi8(1);
+  const __m128i separator = _mm_set1_epi8(FIELD_SEPARATOR);
+  for (; end - p >= 16; p += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i match = _mm_cmpeq_epi8(_mm_or_si128(chunk, lowBit), separator);
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(match));
+    if (mask != 0) {
+      return p + lowestBit(mask);
+    }
+  }
+#endif  // ALIYUN_HA_DOC_READER_SSE2
+  for (; p < end; ++p) {
+    if ((*p | 1) == FIELD_SEPARATOR) {
+      return p;
+    }
+  }
+  return end;
+}
+
+// number of '\n' in [p, end).
+static int64_t countLines(const char* p, const char* end) {
+  int64_t lines = 0;
+#ifdef ALIYUN_HA_DOC_READER_SSE2
+  const __m128i newline = _mm_set1_epi8('\n');
+  for (; end - p >= 16; p += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    unsigned mask = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+    lines += bitCount(mask);
+  }
+#endif  // ALIYUN_HA_DOC_READER_SSE2
+  for (; p < end; ++p) {
+    if (*p == '\n') {
+      lines++;
+    }
+  }
+  return lines;
+}
+
+HaDocReader::Doc::Doc()
+    : line(0),
+      offset(0) {
+}
+
+void HaDocReader::Doc::clear() {
+  command = StringPiece();
+  fields.clear();
+  line = 0;
+  offset = 0;
+}
+
+// order by key, equal keys keep file order.
+static bool keyLess(const HaDocReader::Field* lhs,
+                    const HaDocReader::Field* rhs) {
+  return lhs->key < rhs->key;
+}
+
+static void appendValue(const utils::StringPiece& value, string* json) {
+  size_t pos = value.find(MULTI_VALUE_SEPARATOR);
+  if (pos == utils::StringPiece::npos) {
+    value.appendTo(json);
+    return;
+  }
+
+  // multi value, a\x1Db => [a,b]
+  json->push_back('[');
+  size_t start = 0;
+  while (pos != utils::StringPiece::npos) {
+    json->append(value.data() + start, pos - start);
+    json->push_back(',');
+    start = pos + 1;
+    pos = value.find(MULTI_VALUE_SEPARATOR, start);
+  }
+  json->append(value.data() + start, value.size() - start);
+  json->push_back(']');
+}
+
+void HaDocReader::Doc::appendJson(string* json) const {
+  if (command.empty()) {  // same as SingleDoc
+    return;
+  }
+
+  std::vector<const Field*> sorted(fields.size());
+  size_t size = command.size() + 16;
+  for (size_t i = 0; i < fields.size(); i++) {
+    sorted[i] = &fields[i];
+    size += fields[i].key.size() + fields[i].value.size() + 8;
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), keyLess);
+  json->reserve(json->size() + size);
+
+  json->append("{\"cmd\":\"");
+  command.appendTo(json);
+  json->push_back('"');
+
+  bool first = true;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    // later one wins for duplicated keys.
+    if (i + 1 < sorted.size() && sorted[i + 1]->key == sorted[i]->key) {
+      continue;
+    }
+    json->append(first ? ",\"fields\":{\"" : ",\"");
+    first = false;
+    sorted[i]->key.appendTo(json);
+    json->append("\":\"");
+    appendValue(sorted[i]->value, json);
+    json->push_back('"');
+  }
+  if (!first) {
+    json->push_back('}');
+  }
+  json->push_back('}');
+}
+
+string HaDocReader::Doc::getJsonString() const {
+  string json;
+  appendJson(&json);
+  return json;
+}
+
+HaDocReader::HaDocReader(const char* data, size_t size)
+    : begin_(data),
+      cur_(data),
+      end_(data + size),
+      line_(0) {
+}
+
+void HaDocReader::seekLine(int64_t line) {
+  if (line <= line_) {
+    cur_ = begin_;
+    line_ = 0;
+  }
+  while (line_ + 1 < line && cur_ < end_) {
+    const void* newline = ::memchr(cur_, '\n', end_ - cur_);
+    if (newline == NULL) {
+      cur_ = end_;
+      break;
+    }
+    cur_ = static_cast<const char*>(newline) + 1;
+    line_++;
+  }
+}
+
+void HaDocReader::seek(size_t offset, int64_t line) {
+  cur_ = offset < static_cast<size_t>(end_ - begin_) ? begin_ + offset : end_;
+  line_ = line;
+}
+
+bool HaDocReader::next(Doc* doc) {
+  doc->clear();
+  bool hasDoc = false;
+  const char* p = cur_;
+
+  for (;;) {
+    const char* sep = findSeparator(p, end_);
+    if (sep == end_) {  // incomplete doc at the end
+      advance(end_);
+      return false;
+    }
+    const char* after = lineEnd(sep);
+    if (after == NULL) {  // not at line end, part of the value
+      p = sep + 1;
+      continue;
+    }
+
+    if (*sep == ITEM_SEPARATOR) {
+      advance(sep);
+      doc->line = line_ + 1;
+      advance(after);
+      doc->offset = getOffset();
+      p = cur_;
+      if (hasDoc) {
+        return true;
+      }
+      continue;
+    }
+
+    // field, skip empty lines before it.
+    const char* start = cur_;
+    while (start < sep && (*start == '\n' || *start == '\r')) {
+      start++;
+    }
+    StringPiece detail(start, sep - start);
+    advance(after);
+    p = cur_;
+
+    size_t middleIndex = detail.find('=');
+    if (middleIndex == StringPiece::npos) {
+      continue;
+    }
+    StringPiece key = detail.substr(0, middleIndex);
+    StringPiece value = detail.substr(middleIndex + 1);
+    if (key == "CMD") {
+      doc->command = value;
+    } else {
+      Field field;
+      field.key = key;
+      field.value = value;
+      doc->fields.push_back(field);
+    }
+    hasDoc = true;
+  }
+}
+
+void HaDocReader::advance(const char* pos) {
+  line_ += countLines(cur_, pos);
+  cur_ = pos;
+}
+
+const char* HaDocReader::lineEnd(const char* sep) const {
+  const char* p = sep + 1;
+  if (p < end_ && *p == '\r') {
+    p++;
+  }
+  if (p == end_) {
+    return p;
+  }
+  return *p == '\n' ? p + 1 : NULL;
+}
+
+}  // namespace opensearch
+}  // namespace aliyun
@@ -19,23 +19,96 @@
 
 #include "aliyun/opensearch/object/doc_items.h"
 
+#include <utility>
+
+#include "aliyun/auth/url_encoder.h"
+
 namespace aliyun {
 namespace opensearch {
 namespace object {
 
+// url encoded size of brackets and comma, e.g. "{" => "%7B".
+static const size_t ENCODED_PUNCT_SIZE = 3;
+
+DocItems::DocItems()
+    : jsonBytes_(0),
+      encodedBytes_(0) {
+}
+
+void DocItems::addJson(const std::string& json) {
+  addJson(json, auth::UrlEncoder::encodedLength(json));
+}
+
+void DocItems::addJson(const std::string& json, size_t encodedSize) {
+  jsonList_.push_back(json);
+  jsonBytes_ += json.length();
+  encodedBytes_ += encodedSize;
+}
+
+void DocItems::addJson(std::string&& json) {
+  size_t encodedSize = auth::UrlEncoder::encodedLength(json);
+  addJson(std::move(json), encodedSize);
+}
+
+void DocItems::addJson(std::string&& json, size_t encodedSize) {
+  jsonBytes_ += json.length();
+  encodedBytes_ += encodedSize;
+  jsonList_.push_back(std::move(json));
+}
+
 std::string DocItems::getJsonString() const {
-  std::string json = "{";
-  for (size_t i = 0; i < docList_.size(); ++i) {
-    json += docList_[i].getJsonString() + ',';
+  return join('{', '}');
+}
+
+std::string DocItems::getJsonArrayString() const {
+  return join('[', ']');
+}
+
+std::string DocItems::join(char begin, char end) const {
+  std::string json;
+  if (jsonList_.empty()) {
+    return json;
   }
-  if (json.length() > 1) {
-    json[json.length() - 1] = '}';
-  } else {
-    json.resize(0);
+  json.reserve(jsonSize());
+  json += begin;
+  for (size_t i = 0; i < jsonList_.size(); ++i) {
+    if (i != 0) {
+      json += ',';
+    }
+    json += jsonList_[i];
   }
+  json += end;
   return json;
 }
 
+size_t DocItems::jsonSize() const {
+  if (jsonList_.empty()) {
+    return 0;
+  }
+  // brackets and commas
+  return jsonBytes_ + 2 + (jsonList_.size() - 1);
+}
+
+size_t DocItems::encodedSize() const {
+  if (jsonList_.empty()) {
+    return 0;
+  }
+  return encodedBytes_ + ENCODED_PUNCT_SIZE * (2 + jsonList_.size() - 1);
+}
+
+size_t DocItems::encodedSizeWith(size_t encodedSize) const {
+  if (jsonList_.empty()) {
+    return encodedSize + ENCODED_PUNCT_SIZE * 2;
+  }
+  return this->encodedSize() + ENCODED_PUNCT_SIZE + encodedSize;
+}
+
+void DocItems::clear() {
+  jsonList_.clear();
+  jsonBytes_ = 0;
+  encodedBytes_ = 0;
+}
+
 }  // namespace object
 }  // namespace opensearch
 }  // namespace aliyun
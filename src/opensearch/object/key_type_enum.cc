@@ -30,7 +30,7 @@ KeyTypeEnum::KeyTypeEnum(Value v)
     : value_(v) {
 }
 
-KeyTypeEnum::KeyTypeEnum(std::string str) {
+KeyTypeEnum::KeyTypeEnum(const std::string& str) {
   for (int i = 1; i <= kMaxValue; i++) {
     if (strncasecmp(str.c_str(), valueNames()[i], str.length()) == 0) {
       value_ = Value(i);
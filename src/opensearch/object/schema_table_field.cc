@@ -34,9 +34,9 @@ SchemaTableField::SchemaTableField() {
 }
 
 void SchemaTableField::addIndex(std::string indexStr) {
-  std::string trim = utils::StringUtils::trim(indexStr);
+  std::string trim = utils::StringUtils::trim(std::move(indexStr));
 
-  if (indexStr.length() == 0 || trim.length() == 0) {
+  if (trim.length() == 0) {
     return;
   }
   for (size_t i = 0; i < indexList_.size(); i++) {
@@ -44,7 +44,7 @@ void SchemaTableField::addIndex(std::string indexStr) {
       return;
     }
   }
-  indexList_.push_back(trim);
+  indexList_.push_back(std::move(trim));
 }
 
 }  // namespace object
@@ -28,8 +28,8 @@ SchemaTableFieldType::SchemaTableFieldType(Value v)
     : value_(v) {
 }
 
-SchemaTableFieldType::SchemaTableFieldType(std::string type,
-                                           std::string bigType) {
+SchemaTableFieldType::SchemaTableFieldType(const std::string& type,
+                                           const std::string& bigType) {
   for (int i = 1; i <= kMaxValue; i++) {
     if (strncasecmp(type.c_str(), typeNames()[i], type.length()) == 0
         && strncasecmp(bigType.c_str(), bigTypeNames()[i], bigType.length())
@@ -0,0 +1,416 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/opensearch/object/search_result.h"
+
+#include <stdlib.h>
+
+#include <utility>
+
+#include "aliyun/reader/json_reader.h"
+#include "aliyun/utils/string_utils.h"
+
+namespace aliyun {
+namespace opensearch {
+namespace object {
+
+using std::string;
+using utils::StringPiece;
+using reader::ReaderHandler;
+
+// walks the response once, the context stack follows the known members and
+// everything else is skipped without being decoded.
+class SearchResult::Parser : public ReaderHandler {
+ public:
+  Parser(SearchResult* result, reader::JsonReader* reader)
+      : result_(result),
+        reader_(reader),
+        rawDepth_(0),
+        rawBegin_(0) {
+  }
+
+  Action onObjectBegin() {
+    return begin(true);
+  }
+
+  Action onObjectEnd() {
+    return end();
+  }
+
+  Action onArrayBegin() {
+    return begin(false);
+  }
+
+  Action onArrayEnd() {
+    return end();
+  }
+
+  Action onKey(const StringPiece& key);
+
+  Action onValue(const StringPiece& value, ValueType type);
+
+ private:
+  enum Context {
+    ROOT,
+    RESULT,
+    ITEMS,
+    ITEM,
+    FACETS,
+    FACET,
+    FACET_ITEMS,
+    FACET_ITEM,
+    ERRORS,
+    ERROR
+  };
+
+  Action begin(bool object);
+
+  Action end();
+
+  void push(Context context) {
+    stack_.push_back(context);
+    key_.clear();
+  }
+
+  Field& lastField() {
+    return result_->fields_.back();
+  }
+
+  SearchResult* result_;
+  reader::JsonReader* reader_;
+  std::vector<Context> stack_;
+  string key_;
+  int rawDepth_;  // depth inside a nested field value of an item
+  size_t rawBegin_;
+};
+
+ReaderHandler::Action SearchResult::Parser::begin(bool object) {
+  if (rawDepth_ > 0) {
+    rawDepth_++;
+    return CONTINUE;
+  }
+  if (stack_.empty()) {
+    if (!object) {
+      return SKIP;
+    }
+    push(ROOT);
+    return CONTINUE;
+  }
+
+  switch (stack_.back()) {
+    case ROOT:
+      if (object && key_ == "result") {
+        push(RESULT);
+        return CONTINUE;
+      }
+      if (!object && key_ == "errors") {
+        push(ERRORS);
+        return CONTINUE;
+      }
+      break;
+    case RESULT:
+      if (!object && key_ == "items") {
+        push(ITEMS);
+        return CONTINUE;
+      }
+      if (!object && key_ == "facet") {
+        push(FACETS);
+        return CONTINUE;
+      }
+      break;
+    case ITEMS:
+      if (object) {
+        Hit hit = {result_->fields_.size(), 0};
+        result_->hits_.push_back(hit);
+        push(ITEM);
+        return CONTINUE;
+      }
+      break;
+    case ITEM:
+      // nested values are kept as raw json.
+      rawDepth_ = 1;
+      rawBegin_ = reader_->getOffset() - 1;
+      return CONTINUE;
+    case FACETS:
+      if (object) {
+        result_->facets_.push_back(Facet());
+        push(FACET);
+        return CONTINUE;
+      }
+      break;
+    case FACET:
+      if (!object && key_ == "items") {
+        push(FACET_ITEMS);
+        return CONTINUE;
+      }
+      break;
+    case FACET_ITEMS:
+      if (object) {
+        FacetItem item = {string(), 0};
+        result_->facets_.back().items.push_back(item);
+        push(FACET_ITEM);
+        return CONTINUE;
+      }
+      break;
+    case ERRORS:
+      if (object) {
+        result_->errors_.push_back(Error());
+        push(ERROR);
+        return CONTINUE;
+      }
+      break;
+    default:
+      break;
+  }
+  return SKIP;
+}
+
+ReaderHandler::Action SearchResult::Parser::end() {
+  if (rawDepth_ > 0) {
+    if (--rawDepth_ == 0) {
+      lastField().value = rawBegin_;
+      lastField().valueSize = reader_->getOffset() - rawBegin_;
+    }
+    return CONTINUE;
+  }
+
+  if (stack_.back() == ITEM) {
+    Hit& hit = result_->hits_.back();
+    hit.count = result_->fields_.size() - hit.first;
+  }
+  stack_.pop_back();
+  return CONTINUE;
+}
+
+ReaderHandler::Action SearchResult::Parser::onKey(const StringPiece& key) {
+  if (rawDepth_ > 0) {
+    return CONTINUE;
+  }
+
+  if (stack_.back() != ITEM) {
+    key.toString().swap(key_);
+    return CONTINUE;
+  }
+
+  // the key is in the response unless it had escapes. offsets work for
+  // a response fed in pieces too.
+  StringPiece raw = reader_->getRawValue();
+  Field field = {0, key.size(), 0, 0, false};
+  if (raw.size() == key.size() + 2) {
+    field.name = reader_->getOffset() - key.size() - 1;
+  } else {
+    field.name = result_->names_.size();
+    field.escapedName = true;
+    key.appendTo(&result_->names_);
+  }
+  result_->fields_.push_back(field);
+  return CONTINUE;
+}
+
+ReaderHandler::Action SearchResult::Parser::onValue(const StringPiece& value,
+                                                    ValueType /* type */) {
+  if (rawDepth_ > 0) {
+    return CONTINUE;
+  }
+
+  switch (stack_.back()) {
+    case ROOT:
+      if (key_ == "status") {
+        result_->status_ = value.toString();
+      } else if (key_ == "request_id") {
+        result_->requestId_ = value.toString();
+      }
+      break;
+    case RESULT:
+      if (key_ == "searchtime") {
+        result_->searchTime_ = ::atof(value.toString().c_str());
+      } else if (key_ == "total") {
+        result_->total_ = ::atoi(value.toString().c_str());
+      } else if (key_ == "num") {
+        result_->num_ = ::atoi(value.toString().c_str());
+      } else if (key_ == "viewtotal") {
+        result_->viewTotal_ = ::atoi(value.toString().c_str());
+      }
+      break;
+    case ITEM: {
+      size_t size = reader_->getRawValue().size();
+      lastField().value = reader_->getOffset() - size;
+      lastField().valueSize = size;
+      break;
+    }
+    case FACET:
+      if (key_ == "key") {
+        result_->facets_.back().key = value.toString();
+      }
+      break;
+    case FACET_ITEM:
+      if (key_ == "value") {
+        result_->facets_.back().items.back().value = value.toString();
+      } else if (key_ == "count") {
+        result_->facets_.back().items.back().count =
+            ::atoi(value.toString().c_str());
+      }
+      break;
+    case ERROR:
+      if (key_ == "code") {
+        result_->errors_.back().code = value.toString();
+      } else if (key_ == "message") {
+        result_->errors_.back().message = value.toString();
+      }
+      break;
+    default:
+      break;
+  }
+  return CONTINUE;
+}
+
+StringPiece SearchHit::getFieldName(size_t i) const {
+  const SearchResult::Field& field = result_->fields_[first_ + i];
+  const string& names = field.escapedName ? result_->names_
+                                          : result_->response_;
+  return StringPiece(names.data() + field.name, field.nameSize);
+}
+
+StringPiece SearchHit::getRawValue(size_t i) const {
+  const SearchResult::Field& field = result_->fields_[first_ + i];
+  return StringPiece(result_->response_.data() + field.value,
+                     field.valueSize);
+}
+
+StringPiece SearchHit::getFieldView(size_t i, string* scratch) const {
+  StringPiece raw = getRawValue(i);
+  if (raw == "null") {
+    return StringPiece();
+  }
+  if (raw.empty() || raw[0] != '"') {
+    return raw;
+  }
+
+  StringPiece quoted = raw.substr(1, raw.size() - 2);
+  if (quoted.find('\\') == StringPiece::npos) {
+    return quoted;
+  }
+  reader::JsonReader::unescape(raw, scratch);
+  return *scratch;
+}
+
+StringPiece SearchHit::getFieldView(const StringPiece& name,
+                                    string* scratch) const {
+  size_t i = find(name);
+  if (i == count_) {
+    return StringPiece();
+  }
+  return getFieldView(i, scratch);
+}
+
+string SearchHit::getField(const StringPiece& name) const {
+  string value;
+  size_t i = find(name);
+  if (i == count_) {
+    return value;
+  }
+  StringPiece raw = getRawValue(i);
+  if (raw == "null") {
+    return value;
+  }
+  reader::JsonReader::unescape(raw, &value);
+  return value;
+}
+
+size_t SearchHit::find(const StringPiece& name) const {
+  for (size_t i = 0; i < count_; i++) {
+    if (getFieldName(i) == name) {
+      return i;
+    }
+  }
+  return count_;
+}
+
+SearchResult::SearchResult()
+    : searchTime_(0),
+      total_(0),
+      num_(0),
+      viewTotal_(0) {
+}
+
+SearchResult::SearchResult(string response)
+    : searchTime_(0),
+      total_(0),
+      num_(0),
+      viewTotal_(0) {
+  parse(std::move(response));
+}
+
+void SearchResult::parse(string response) {
+  clear();
+  response_.swap(response);
+
+  reader::JsonReader reader;
+  Parser parser(this, &reader);
+  reader.read(response_, &parser);
+}
+
+SearchResult::StreamParser::StreamParser(SearchResult* result)
+    : result_(result),
+      reader_(new reader::JsonReader()),
+      parser_(NULL) {
+  parser_ = new Parser(result, reader_);
+}
+
+SearchResult::StreamParser::~StreamParser() {
+  delete parser_;
+  delete reader_;
+}
+
+void SearchResult::StreamParser::begin() {
+  result_->clear();
+  delete parser_;
+  parser_ = NULL;
+  parser_ = new Parser(result_, reader_);
+  reader_->begin(parser_);
+}
+
+void SearchResult::StreamParser::feed(const char* data, size_t size) {
+  // offsets reported by the reader are offsets into response_.
+  result_->response_.append(data, size);
+  reader_->feed(data, size);
+}
+
+void SearchResult::StreamParser::finish() {
+  reader_->finish();
+}
+
+void SearchResult::clear() {
+  response_.clear();
+  names_.clear();
+  status_.clear();
+  requestId_.clear();
+  searchTime_ = 0;
+  total_ = 0;
+  num_ = 0;
+  viewTotal_ = 0;
+  errors_.clear();
+  facets_.clear();
+  fields_.clear();
+  hits_.clear();
+}
+
+}  // namespace object
+}  // namespace opensearch
+}  // namespace aliyun
@@ -30,7 +30,7 @@ SearchTypeEnum::SearchTypeEnum(Value v)
     : value_(v) {
 }
 
-SearchTypeEnum::SearchTypeEnum(std::string str) {
+SearchTypeEnum::SearchTypeEnum(const std::string& str) {
   for (int i = 1; i <= kMaxValue; i++) {
     if (strncasecmp(str.c_str(), valueNames()[i], str.length()) == 0) {
       value_ = Value(i);
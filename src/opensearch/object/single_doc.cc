@@ -28,7 +28,7 @@ SingleDoc::SingleDoc() {
 }
 
 SingleDoc::SingleDoc(string cmd, const std::map<string, string> &fields)
-    : command_(cmd),
+    : command_(std::move(cmd)),
       fields_(fields) {
 }
 
@@ -40,15 +40,16 @@ void SingleDoc::addField(string key, string value) {
 
   if (pos != string::npos) {
     while (pos != string::npos) {
-      jsonArray += value.substr(start, pos - start) + ",";
+      jsonArray.append(value, start, pos - start);
+      jsonArray += ',';
       start = pos + 1;
       pos = value.find(CloudsearchDoc::HA_DOC_MULTI_VALUE_SEPARATOR, pos + 1);
     }
-    jsonArray += value.substr(start);  // rest part
+    jsonArray.append(value, start, string::npos);  // rest part
     jsonArray += ']';
-    this->fields_[key] = jsonArray;
+    this->fields_[std::move(key)] = std::move(jsonArray);
   } else {
-    this->fields_[key] = value;
+    this->fields_[std::move(key)] = std::move(value);
   }
 }
 
@@ -0,0 +1,265 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/reader/json_pull_parser.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#include "aliyun/reader/json_reader.h"
+
+namespace aliyun {
+namespace reader {
+
+using std::string;
+using utils::StringPiece;
+
+static bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+JsonPullParser::JsonPullParser()
+    : pos_(0),
+      dropped_(0),
+      scanned_(0),
+      finished_(false),
+      state_(VALUE_STATE),
+      type_(ReaderHandler::STRING_VALUE) {
+}
+
+void JsonPullParser::reset() {
+  buffer_.clear();
+  pos_ = 0;
+  dropped_ = 0;
+  scanned_ = 0;
+  finished_ = false;
+  state_ = VALUE_STATE;
+  stack_.clear();
+  text_ = StringPiece();
+  raw_ = StringPiece();
+}
+
+void JsonPullParser::feed(const char* data, size_t size) {
+  // drop what has been parsed, only an incomplete token is left.
+  if (pos_ > 0) {
+    buffer_.erase(0, pos_);
+    dropped_ += pos_;
+    pos_ = 0;
+  }
+  buffer_.append(data, size);
+}
+
+void JsonPullParser::finish() {
+  finished_ = true;
+}
+
+JsonPullParser::Event JsonPullParser::next() {
+  for (;;) {
+    while (pos_ < buffer_.size() && isSpace(buffer_[pos_])) {
+      pos_++;
+    }
+    if (state_ == DONE_STATE) {
+      pos_ = buffer_.size();
+      return finished_ ? END_DOCUMENT : NEED_MORE;
+    }
+    if (pos_ == buffer_.size()) {
+      if (!finished_) {
+        return NEED_MORE;
+      }
+      if (stack_.empty()) {
+        return END_DOCUMENT;  // empty input
+      }
+      throw JsonException(stack_[stack_.size() - 1] == '{'
+                          ? "object unclosed" : "array unclosed");
+    }
+
+    char c = buffer_[pos_];
+    switch (state_) {
+      case FIRST_KEY_STATE:
+        if (c == '}') {
+          return close(c);
+        }
+        // fall through
+      case KEY_STATE:
+        if (c != '"') {
+          throw JsonException("object key expected");
+        }
+        if (!readString()) {
+          return NEED_MORE;
+        }
+        state_ = COLON_STATE;
+        return KEY;
+
+      case COLON_STATE:
+        if (c != ':') {
+          throw JsonException("colon expected");
+        }
+        pos_++;
+        state_ = VALUE_STATE;
+        break;
+
+      case NEXT_STATE:
+        if (c == ',') {
+          pos_++;
+          state_ = stack_[stack_.size() - 1] == '{' ? KEY_STATE : VALUE_STATE;
+          break;
+        }
+        if ((c == '}' && stack_[stack_.size() - 1] == '{')
+            || (c == ']' && stack_[stack_.size() - 1] == '[')) {
+          return close(c);
+        }
+        throw JsonException("comma expected");
+
+      case FIRST_VALUE_STATE:
+        if (c == ']') {
+          return close(c);
+        }
+        // fall through
+      default:
+        if (c == '{' || c == '[') {
+          pos_++;
+          stack_.push_back(c);
+          state_ = c == '{' ? FIRST_KEY_STATE : FIRST_VALUE_STATE;
+          return c == '{' ? OBJECT_BEGIN : ARRAY_BEGIN;
+        }
+
+        bool complete;
+        if (c == '"') {
+          complete = readString();
+          type_ = ReaderHandler::STRING_VALUE;
+        } else if (c == '-' || ::isdigit(static_cast<unsigned char>(c))) {
+          complete = readNumber();
+          type_ = ReaderHandler::NUMBER_VALUE;
+        } else {
+          complete = readLiteral();
+        }
+        if (!complete) {
+          return NEED_MORE;
+        }
+        state_ = stack_.empty() ? DONE_STATE : NEXT_STATE;
+        return VALUE;
+    }
+  }
+}
+
+bool JsonPullParser::readString() {
+  const char* start = buffer_.data() + pos_;
+  const char* end = buffer_.data() + buffer_.size();
+
+  // resumes after what was searched for the last piece.
+  const char* p = start + (scanned_ > 0 ? scanned_ : 1);
+  while (p < end && *p != '"') {
+    if (*p == '\\') {
+      if (end - p < 2) {
+        break;  // resumes at the escape
+      }
+      p += 2;
+    } else {
+      p++;
+    }
+  }
+  if (p == end || *p != '"') {
+    if (finished_) {
+      throw JsonException("string unclosed");
+    }
+    scanned_ = p - start;
+    return false;
+  }
+
+  raw_ = StringPiece(start, p + 1 - start);
+  if (::memchr(start, '\\', p - start) != NULL) {
+    JsonReader::unescape(raw_, &unescaped_);
+    text_ = unescaped_;
+  } else {
+    text_ = StringPiece(start + 1, p - start - 1);
+  }
+  scanned_ = 0;
+  pos_ = p + 1 - buffer_.data();
+  return true;
+}
+
+// same grammar as JsonReader, the end of the input may be inside a number.
+bool JsonPullParser::readNumber() {
+  const char* start = buffer_.data() + pos_;
+  const char* end = buffer_.data() + buffer_.size();
+  const char* p = start;
+  if (*p == '-') {
+    p++;
+  }
+  while (p < end && ::isdigit(static_cast<unsigned char>(*p))) {
+    p++;
+  }
+  if (p < end && *p == '.') {
+    p++;
+    while (p < end && ::isdigit(static_cast<unsigned char>(*p))) {
+      p++;
+    }
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    p++;
+    if (p < end && (*p == '+' || *p == '-')) {
+      p++;
+    }
+    while (p < end && ::isdigit(static_cast<unsigned char>(*p))) {
+      p++;
+    }
+  }
+  if (p == end && !finished_) {
+    return false;
+  }
+
+  raw_ = StringPiece(start, p - start);
+  text_ = raw_;
+  pos_ = p - buffer_.data();
+  return true;
+}
+
+bool JsonPullParser::readLiteral() {
+  static const char* const LITERALS[] = { "true", "false", "null" };
+
+  const char* start = buffer_.data() + pos_;
+  size_t left = buffer_.size() - pos_;
+  for (size_t i = 0; i < sizeof(LITERALS) / sizeof(LITERALS[0]); i++) {
+    size_t size = ::strlen(LITERALS[i]);
+    if (left < size) {
+      if (!finished_ && ::memcmp(start, LITERALS[i], left) == 0) {
+        return false;
+      }
+      continue;
+    }
+    if (::memcmp(start, LITERALS[i], size) == 0) {
+      raw_ = StringPiece(start, size);
+      text_ = raw_;
+      type_ = i == 2 ? ReaderHandler::NULL_VALUE : ReaderHandler::BOOL_VALUE;
+      pos_ += size;
+      return true;
+    }
+  }
+  throw JsonException("invalid value");
+}
+
+JsonPullParser::Event JsonPullParser::close(char c) {
+  pos_++;
+  stack_.erase(stack_.size() - 1);
+  state_ = stack_.empty() ? DONE_STATE : NEXT_STATE;
+  return c == '}' ? OBJECT_END : ARRAY_END;
+}
+
+}  // namespace reader
+}  // namespace aliyun
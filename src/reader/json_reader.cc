@@ -18,257 +18,718 @@
  */
 
 #include "aliyun/reader/json_reader.h"
-#include "aliyun/utils/string_utils.h"
 
-#ifdef TRACE
-// for debug
+#include <ctype.h>
 #include <stdio.h>
-#include <stdlib.h>
-int gTraceCounter = 0;
-#define trace printf
-#define TRACE_FUNC do { \
-  if (++gTraceCounter > 800) exit(-1); \
-  else::printf("%2d %s\n", gTraceCounter, __FUNCTION__); \
-} while (0)
-#else
-#define TRACE_FUNC
-#define trace(...)
-#endif
+#include <string.h>
 
 namespace aliyun {
-
 namespace reader {
 
-std::map<char, char> escapesMapping() {
-  std::map<char, char> escapes;
-  escapes['\\'] = '\\';
-  escapes['/'] = '/';
-  escapes['"'] = '"';
-  escapes['t'] = '\t';
-  escapes['n'] = '\n';
-  escapes['r'] = '\r';
-  escapes['b'] = '\b';
-  escapes['f'] = '\f';
-  trace("%s\n", __FUNCTION__);
-  return escapes;
-}
-
-std::map<char, char> JsonReader::escapes = escapesMapping();
-
-JsonReader::Token JsonReader::readJson(string baseKey) {
-  TRACE_FUNC;
-  while (s_ && ::isspace(*s_)) {
-    s_++;
-  }
-  char ch = *s_;
-  if (ch == '\0')
-    return END_TOKEN;
-  s_++;
-  switch (ch) {
-    case '{':
-      token_ = OBJECT_BEGIN_TOKEN;
-      processObject(baseKey);
-      break;
-    case '}':
-      token_ = OBJECT_END_TOKEN;
-      break;
-    case '[':
-      token_ = ARRAY_BEGIN_TOKEN;
-      if (*s_ == '"') {  // for string array
-        processList(baseKey);
-      } else {  // for object array
-        processArray(baseKey);
-      }
-      break;
-    case ']':
-      token_ = ARRAY_END_TOKEN;
-      break;
-    case '"':
-      token_ = STRING_TOKEN;
-      processString();
-      break;
-    case ',':
-      token_ = COMMA_TOKEN;
+using std::string;
+
+static void putIntoMap(void* result, const string& key, const string& value) {
+  (*static_cast<std::map<string, string>*>(result))[key] = value;
+}
+
+static void putIntoHashMap(void* result, const string& key,
+                           const string& value) {
+  (*static_cast<JsonReader::HashMap*>(result))[key] = value;
+}
+
+static void putIntoFlatMap(void* result, const string& key,
+                           const string& value) {
+  static_cast<FlatMap*>(result)->append(key, value);
+}
+
+static void appendNumber(string* out, int n) {
+  char buffer[16];
+  int len = ::snprintf(buffer, sizeof(buffer), "%d", n);
+  out->append(buffer, len);
+}
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// \uXXXX after "\u", appended as utf-8, surrogate pairs combined.
+static const char* appendUnicode(const char* p, const char* end,
+                                 string* out) {
+  unsigned code = 0;
+  for (int i = 0; i < 4; i++) {
+    int v = p < end ? hexValue(*p) : -1;
+    if (v < 0) {
+      throw JsonException("invalid unicode escape");
+    }
+    code = (code << 4) | v;
+    p++;
+  }
+
+  if (code >= 0xD800 && code <= 0xDBFF && end - p >= 6
+      && p[0] == '\\' && p[1] == 'u') {
+    unsigned low = 0;
+    bool valid = true;
+    for (int i = 2; i < 6 && valid; i++) {
+      int v = hexValue(p[i]);
+      valid = v >= 0;
+      low = (low << 4) | v;
+    }
+    if (valid && low >= 0xDC00 && low <= 0xDFFF) {
+      code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+      p += 6;
+    }
+  }
+
+  if (code < 0x80) {
+    out->push_back(static_cast<char>(code));
+  } else if (code < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  } else if (code < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  }
+  return p;
+}
+
+// escape sequence after '\\', appended unescaped, returns the end of it.
+static const char* appendEscape(const char* p, const char* end,
+                                string* out) {
+  if (p == end) {
+    throw JsonException("string unclosed");
+  }
+  char c = *p++;
+  switch (c) {
+    case 'b':
+      out->push_back('\b');
       break;
-    case ':':
-      token_ = COLON_TOKEN;
+    case 'f':
+      out->push_back('\f');
       break;
-    case '\t':
-      token_ = TABLE_TOKEN;
-      s_ += 3;
+    case 'n':
+      out->push_back('\n');
       break;
-    case '\n':
-      token_ = NEWLINE_TOKEN;
-      s_ += 3;
+    case 'r':
+      out->push_back('\r');
       break;
-    case '\f':
-      token_ = FEED_TOKEN;
-      s_ += 4;
+    case 't':
+      out->push_back('\t');
       break;
-    default:
-      s_--;
-      if (::isdigit(*s_) || *s_ == '-') {
-        token_ = NUMBER_TOKEN;
-        processNumber();
-      }
+    case 'u':
+      return appendUnicode(p, end, out);
+    default:  // '"', '\\', '/' and unknown ones as is
+      out->push_back(c);
   }
-  return token_;
-}
-
-void JsonReader::processObject(string baseKey) {
-  TRACE_FUNC;
-  readJson(baseKey);
-  string key = baseKey + '.' + stringBuffer_;
-  while (token_ != OBJECT_END_TOKEN && *s_) {
-    readJson(key);  // separator
-    if (token_ != OBJECT_END_TOKEN) {
-      Token t = readJson(key);
-      if (t == STRING_TOKEN || t == NUMBER_TOKEN) {
-        trace("put [%s] [%s]\n", key.c_str(), stringBuffer_.c_str());
-        map_[key] = stringBuffer_;
-      } else if (t == TABLE_TOKEN) {
-        trace("put [%s] [%s]\n", key.c_str(), "true");
-        map_[key] = "true";
-      } else if (t == FEED_TOKEN) {
-        trace("put [%s] [%s]\n", key.c_str(), "false");
-        map_[key] = "false";
-      }
+  return p;
+}
 
-      if (readJson(key) == COMMA_TOKEN) {  // separator ?
-        readJson(key);
-        key = baseKey + '.' + stringBuffer_;
-      }
+JsonReader::JsonReader()
+    : begin_(NULL),
+      p_(NULL),
+      end_(NULL),
+      raw_(NULL),
+      put_(NULL),
+      result_(NULL),
+      streaming_(false),
+      handler_(NULL),
+      skipDepth_(0),
+      skipValue_(false),
+      stopped_(false) {
+}
+
+std::map<string, string> JsonReader::read(const string& response,
+                                          const string& endpoint) {
+  std::map<string, string> result;
+  parse(response.data(), response.size(), endpoint, putIntoMap, &result);
+  return result;
+}
+
+void JsonReader::read(const string& response, const string& endpoint,
+                      FlatMap* result) {
+  read(response.data(), response.size(), endpoint, result);
+}
+
+void JsonReader::read(const string& response, const string& endpoint,
+                      HashMap* result) {
+  result->clear();
+  parse(response.data(), response.size(), endpoint, putIntoHashMap, result);
+}
+
+void JsonReader::read(const char* data, size_t size, const string& endpoint,
+                      FlatMap* result) {
+  result->clear();
+  parse(data, size, endpoint, putIntoFlatMap, result);
+  result->sort();
+}
+
+bool JsonReader::read(const string& response, ReaderHandler* handler) {
+  return read(response.data(), response.size(), handler);
+}
+
+bool JsonReader::read(const char* data, size_t size, ReaderHandler* handler) {
+  streaming_ = false;
+  begin_ = data;
+  p_ = data;
+  end_ = data + size;
+
+  skipSpace();
+  if (p_ == end_) {
+    return true;
+  }
+  return walkValue(handler);
+}
+
+void JsonReader::begin(ReaderHandler* handler) {
+  streaming_ = true;
+  pull_.reset();
+  handler_ = handler;
+  skipDepth_ = 0;
+  skipValue_ = false;
+  stopped_ = false;
+}
+
+void JsonReader::reset() {
+  begin_ = NULL;
+  p_ = NULL;
+  end_ = NULL;
+  raw_ = NULL;
+  path_.clear();
+  value_.clear();
+  key_.clear();
+  put_ = NULL;
+  result_ = NULL;
+  streaming_ = false;
+  pull_.reset();
+  handler_ = NULL;
+  skipDepth_ = 0;
+  skipValue_ = false;
+  stopped_ = false;
+}
+
+bool JsonReader::feed(const char* data, size_t size) {
+  if (stopped_) {
+    return false;
+  }
+  pull_.feed(data, size);
+  return pump();
+}
+
+bool JsonReader::finish() {
+  if (stopped_) {
+    return false;
+  }
+  pull_.finish();
+  return pump();
+}
+
+// reports events of the parsed input, false once the handler stopped.
+bool JsonReader::pump() {
+  typedef ReaderHandler Handler;
+
+  for (;;) {
+    JsonPullParser::Event event = pull_.next();
+    if (event == JsonPullParser::NEED_MORE
+        || event == JsonPullParser::END_DOCUMENT) {
+      return true;
+    }
+
+    bool begin = event == JsonPullParser::OBJECT_BEGIN
+        || event == JsonPullParser::ARRAY_BEGIN;
+    bool end = event == JsonPullParser::OBJECT_END
+        || event == JsonPullParser::ARRAY_END;
+    if (skipValue_) {
+      skipValue_ = false;
+      skipDepth_ = begin ? 1 : 0;
+      continue;
+    }
+    if (skipDepth_ > 0) {
+      skipDepth_ += begin ? 1 : (end ? -1 : 0);
+      continue;
+    }
+
+    Handler::Action action;
+    switch (event) {
+      case JsonPullParser::OBJECT_BEGIN:
+        action = handler_->onObjectBegin();
+        break;
+      case JsonPullParser::OBJECT_END:
+        action = handler_->onObjectEnd();
+        break;
+      case JsonPullParser::ARRAY_BEGIN:
+        action = handler_->onArrayBegin();
+        break;
+      case JsonPullParser::ARRAY_END:
+        action = handler_->onArrayEnd();
+        break;
+      case JsonPullParser::KEY:
+        action = handler_->onKey(pull_.getText());
+        skipValue_ = action == Handler::SKIP;
+        break;
+      default:
+        action = handler_->onValue(pull_.getText(), pull_.getValueType());
+        break;
+    }
+
+    if (action == Handler::STOP) {
+      stopped_ = true;
+      return false;
+    }
+    if (action == Handler::SKIP && begin) {
+      skipDepth_ = 1;
     }
   }
-  if (token_ != OBJECT_END_TOKEN)
-    throw JsonException("object unclosed");
 }
 
-void JsonReader::processList(string baseKey) {
-  TRACE_FUNC;
-  using aliyun::utils::StringUtils::ToString;
-  readJson(baseKey);
-  int index = 0;
-  while (token_ != ARRAY_END_TOKEN && *s_) {
-    string key = trimFromLast(baseKey, ".") + "[" + ToString(index++) + "]";
-    trace("put [%s] [%s]\n", key.c_str(), stringBuffer_.c_str());
-    map_[key] = stringBuffer_;
-    if (readJson(baseKey) == COMMA_TOKEN) {  // separator ?
-      stringBuffer_.clear();
-      readJson(baseKey);
+void JsonReader::unescape(const utils::StringPiece& raw, string* out) {
+  out->clear();
+  const char* p = raw.data();
+  const char* end = p + raw.size();
+  if (raw.size() < 2 || *p != '"' || end[-1] != '"') {
+    out->assign(p, end - p);
+    return;
+  }
+
+  p++;
+  end--;
+  while (p < end) {
+    const char* start = p;
+    while (p < end && *p != '\\') {
+      p++;
+    }
+    out->append(start, p - start);
+    if (p < end) {
+      p = appendEscape(p + 1, end, out);
     }
   }
-  if (token_ != ARRAY_END_TOKEN)
-    throw JsonException("list unclosed");
-  trace("put [%s.Length] [%d]\n", baseKey.c_str(), index);
-  map_[trimFromLast(baseKey, ".") + ".Length"] = ToString(index);
 }
 
-void JsonReader::processArray(string baseKey) {
-  TRACE_FUNC;
-  using aliyun::utils::StringUtils::ToString;
-  int index = 0;
-  string preKey = trimFromLast(baseKey, ".");
-  string key = preKey + "[" + ToString(index) + "]";
+void JsonReader::parse(const char* data, size_t size, const string& endpoint,
+                       PutFunc put, void* result) {
+  streaming_ = false;
+  begin_ = data;
+  p_ = data;
+  end_ = data + size;
+  path_ = endpoint;
+  put_ = put;
+  result_ = result;
 
-  readJson(key);
-  while (token_ != ARRAY_END_TOKEN && *s_) {
-    trace("put [%s.Length] [%d]\n", preKey.c_str(), index);
-    map_[preKey + ".Length"] = ToString(index + 1);
+  skipSpace();
+  if (p_ == end_) {
+    return;
+  }
+  if (*p_ == '{') {
+    p_++;
+    parseObject();
+  } else if (*p_ == '[') {
+    p_++;
+    parseArray(p_ < end_ && *p_ == '"');
+  } else {
+    parseScalar(&value_);  // nothing to put without a key
+  }
+}
 
-    if (token_ == STRING_TOKEN) {
-      trace("put [%s] [%s]\n", key.c_str(), stringBuffer_.c_str());
-      map_[key] = stringBuffer_;
+void JsonReader::parseObject() {
+  skipSpace();
+  if (p_ < end_ && *p_ == '}') {
+    p_++;
+    return;
+  }
+
+  size_t mark = path_.size();
+  for (;;) {
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException("object unclosed");
+    }
+    if (*p_ != '"') {
+      throw JsonException("object key expected");
     }
+    p_++;
+    path_ += '.';
+    parseString(&path_);
 
-    if (readJson(baseKey) == COMMA_TOKEN) {
-      key = preKey + "[" + ToString(++index) + "]";
-      readJson(key);
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException("object unclosed");
+    }
+    if (*p_ != ':') {
+      throw JsonException("colon expected");
+    }
+    p_++;
+
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException("object unclosed");
+    }
+    if (*p_ == '{') {
+      p_++;
+      parseObject();
+    } else if (*p_ == '[') {
+      p_++;
+      parseArray(p_ < end_ && *p_ == '"');
+    } else if (parseScalar(&value_)) {
+      put(value_);
+    }
+    path_.resize(mark);
+
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException("object unclosed");
+    }
+    if (*p_ == ',') {
+      p_++;
+    } else if (*p_ == '}') {
+      p_++;
+      return;
+    } else {
+      throw JsonException("comma expected");
     }
   }
-  if (token_ != ARRAY_END_TOKEN)
-    throw JsonException("array unclosed");
 }
 
-void JsonReader::processNumber() {
-  TRACE_FUNC;
-  stringBuffer_.clear();
-  if ('-' == *s_) {
-    addChar();
+// list: an array starting with a string, all scalar items are put.
+// otherwise only string items are put, objects and arrays are read
+// under the indexed path.
+void JsonReader::parseArray(bool list) {
+  // items are indexed on the parent path, drop the last segment.
+  string::size_type cut = path_.rfind('.');
+  if (cut == string::npos) {
+    cut = path_.size();
   }
-  addDigits();
-  if ('.' == *s_) {
-    addChar();
-    addDigits();
+  string tail(path_, cut);
+  path_.resize(cut);
+  size_t mark = path_.size();
+
+  skipSpace();
+  if (p_ < end_ && *p_ == ']') {
+    p_++;
+    path_ += tail;
+    return;
   }
-  if ('e' == *s_ || 'E' == *s_) {
-    addChar();
-    if ('+' == *s_ || '-' == *s_) {
-      addChar();
+
+  const char* error = list ? "list unclosed" : "array unclosed";
+  int index = 0;
+  for (;;) {
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException(error);
+    }
+    path_ += '[';
+    appendNumber(&path_, index++);
+    path_ += ']';
+
+    if (*p_ == '{') {
+      p_++;
+      parseObject();
+    } else if (*p_ == '[') {
+      p_++;
+      parseArray(p_ < end_ && *p_ == '"');
+    } else {
+      bool isString = *p_ == '"';
+      if (parseScalar(&value_) && (list || isString)) {
+        put(value_);
+      }
+    }
+    path_.resize(mark);
+
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException(error);
+    }
+    if (*p_ == ',') {
+      p_++;
+    } else if (*p_ == ']') {
+      p_++;
+      break;
+    } else {
+      throw JsonException("comma expected");
     }
-    addDigits();
   }
-  trace("took %s\n", stringBuffer_.c_str());
-  // took a number to string buffer.
+
+  path_ += ".Length";
+  value_.clear();
+  appendNumber(&value_, index);
+  put(value_);
+  path_.resize(mark);
+  path_ += tail;
 }
 
-void JsonReader::processString() {
-  TRACE_FUNC;
-  stringBuffer_.clear();
-  while (*s_ != '"' && *s_) {
-    if (*s_ == '\\') {  // escape sequence.
-      s_++;
-      if (escapes.find(*s_) != escapes.end()) {
-        stringBuffer_.push_back(escapes[*s_]);
-        s_++;
+// false for null, there is no value to put.
+bool JsonReader::parseScalar(string* value) {
+  value->clear();
+  char c = *p_;
+  if (c == '"') {
+    p_++;
+    parseString(value);
+    return true;
+  }
+  if (c == '-' || ::isdigit(static_cast<unsigned char>(c))) {
+    parseNumber(value);
+    return true;
+  }
+
+  static const char* const LITERALS[] = { "true", "false", "null" };
+  for (size_t i = 0; i < sizeof(LITERALS) / sizeof(LITERALS[0]); i++) {
+    size_t len = ::strlen(LITERALS[i]);
+    if (static_cast<size_t>(end_ - p_) >= len
+        && ::memcmp(p_, LITERALS[i], len) == 0) {
+      p_ += len;
+      if (i == 2) {
+        return false;
       }
+      value->assign(LITERALS[i], len);
+      return true;
+    }
+  }
+  throw JsonException("invalid value");
+}
+
+// appends the string after the opening quote to `out`, unescaped.
+void JsonReader::parseString(string* out) {
+  for (;;) {
+    // copy the plain run at once.
+    const char* start = p_;
+    while (p_ < end_ && *p_ != '"' && *p_ != '\\') {
+      p_++;
+    }
+    out->append(start, p_ - start);
+
+    if (p_ == end_) {
+      throw JsonException("string unclosed");
+    }
+    if (*p_ == '"') {
+      p_++;
+      return;
+    }
+
+    p_ = appendEscape(p_ + 1, end_, out);
+  }
+}
+
+void JsonReader::parseNumber(string* out) {
+  const char* start = p_;
+  out->append(start, skipNumber() - start);
+}
+
+// moves over a number, returns the end of it.
+const char* JsonReader::skipNumber() {
+  if (p_ < end_ && *p_ == '-') {
+    p_++;
+  }
+  while (p_ < end_ && ::isdigit(static_cast<unsigned char>(*p_))) {
+    p_++;
+  }
+  if (p_ < end_ && *p_ == '.') {
+    p_++;
+    while (p_ < end_ && ::isdigit(static_cast<unsigned char>(*p_))) {
+      p_++;
+    }
+  }
+  if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+    p_++;
+    if (p_ < end_ && (*p_ == '+' || *p_ == '-')) {
+      p_++;
+    }
+    while (p_ < end_ && ::isdigit(static_cast<unsigned char>(*p_))) {
+      p_++;
+    }
+  }
+  return p_;
+}
+
+bool JsonReader::walkValue(ReaderHandler* handler) {
+  typedef ReaderHandler Handler;
+
+  char c = *p_;
+  if (c == '{' || c == '[') {
+    p_++;
+    Handler::Action action = c == '{' ? handler->onObjectBegin()
+                                      : handler->onArrayBegin();
+    if (action == Handler::STOP) {
+      return false;
+    }
+    if (action == Handler::SKIP) {
+      skipNested();
+      return true;
+    }
+    return c == '{' ? walkObject(handler) : walkArray(handler);
+  }
+
+  raw_ = p_;
+  if (c == '"') {
+    p_++;
+    return handler->onValue(walkString(&value_), Handler::STRING_VALUE)
+        != Handler::STOP;
+  }
+  if (c == '-' || ::isdigit(static_cast<unsigned char>(c))) {
+    const char* start = p_;
+    utils::StringPiece number(start, skipNumber() - start);
+    return handler->onValue(number, Handler::NUMBER_VALUE) != Handler::STOP;
+  }
+  if (!parseScalar(&value_)) {
+    return handler->onValue("null", Handler::NULL_VALUE) != Handler::STOP;
+  }
+  return handler->onValue(value_, Handler::BOOL_VALUE) != Handler::STOP;
+}
+
+bool JsonReader::walkObject(ReaderHandler* handler) {
+  typedef ReaderHandler Handler;
+
+  skipSpace();
+  if (p_ < end_ && *p_ == '}') {
+    p_++;
+    return handler->onObjectEnd() != Handler::STOP;
+  }
+
+  for (;;) {
+    skipSpace();
+    expect('"', "object key expected");
+    raw_ = p_ - 1;
+    Handler::Action action = handler->onKey(walkString(&key_));
+    if (action == Handler::STOP) {
+      return false;
+    }
+
+    skipSpace();
+    expect(':', "colon expected");
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException("object unclosed");
+    }
+    if (action == Handler::SKIP) {
+      skipValue();
+    } else if (!walkValue(handler)) {
+      return false;
+    }
+
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException("object unclosed");
+    }
+    if (*p_ == ',') {
+      p_++;
+    } else if (*p_ == '}') {
+      p_++;
+      return handler->onObjectEnd() != Handler::STOP;
     } else {
-      addChar();
+      throw JsonException("comma expected");
     }
   }
-  if (*s_ != '\"')
-    throw JsonException("string unclosed");
-  trace("took %s\n", stringBuffer_.c_str());
-  s_++;  // skip '"'
 }
 
-void JsonReader::addDigits() {
-  while (::isdigit(*s_)) {
-    addChar();
+bool JsonReader::walkArray(ReaderHandler* handler) {
+  typedef ReaderHandler Handler;
+
+  skipSpace();
+  if (p_ < end_ && *p_ == ']') {
+    p_++;
+    return handler->onArrayEnd() != Handler::STOP;
+  }
+
+  for (;;) {
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException("array unclosed");
+    }
+    if (!walkValue(handler)) {
+      return false;
+    }
+
+    skipSpace();
+    if (p_ == end_) {
+      throw JsonException("array unclosed");
+    }
+    if (*p_ == ',') {
+      p_++;
+    } else if (*p_ == ']') {
+      p_++;
+      return handler->onArrayEnd() != Handler::STOP;
+    } else {
+      throw JsonException("comma expected");
+    }
   }
 }
 
-void JsonReader::addChar() {
-  stringBuffer_.push_back(*s_++);
+// string after the opening quote, points into the input unless it has
+// escapes, then it is unescaped into `scratch`.
+utils::StringPiece JsonReader::walkString(string* scratch) {
+  const char* start = p_;
+  while (p_ < end_ && *p_ != '"' && *p_ != '\\') {
+    p_++;
+  }
+  if (p_ < end_ && *p_ == '"') {
+    return utils::StringPiece(start, p_++ - start);
+  }
+  scratch->assign(start, p_ - start);
+  parseString(scratch);
+  return *scratch;
 }
 
-std::string JsonReader::trimFromLast(string str, string stripString) {
-  string::size_type pos = str.find_last_of(stripString);
-  if (pos != string::npos) {
-    return str.substr(0, pos);
+void JsonReader::skipValue() {
+  char c = *p_;
+  if (c == '{' || c == '[') {
+    p_++;
+    skipNested();
   } else {
-    return str;
+    parseScalar(&value_);
+  }
+}
+
+// skips to the end of an object or array, the opening one already read.
+void JsonReader::skipNested() {
+  int depth = 1;
+  while (p_ < end_) {
+    char c = *p_++;
+    if (c == '"') {
+      while (p_ < end_ && *p_ != '"') {
+        if (*p_++ == '\\' && p_ < end_) {
+          p_++;
+        }
+      }
+      if (p_ >= end_) {
+        break;
+      }
+      p_++;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if ((c == '}' || c == ']') && --depth == 0) {
+      return;
+    }
   }
+  p_ = end_;
+  throw JsonException("object unclosed");
 }
 
-std::map<std::string, std::string> JsonReader::read(string response,
-                                                    string endpoint) {
-#ifdef TRACE
-  gTraceCounter = 0;
-#endif
-  this->reset();
-  s_ = response.c_str();
-  readJson(endpoint);
-  return map_;
+void JsonReader::expect(char c, const char* error) {
+  if (p_ == end_) {
+    throw JsonException("object unclosed");
+  }
+  if (*p_ != c) {
+    throw JsonException(error);
+  }
+  p_++;
 }
 
-void JsonReader::reset() {
-  this->s_ = NULL;
-  this->map_.clear();
-  this->stringBuffer_.clear();
-  this->token_ = Token::INIT_TOKEN;
+void JsonReader::skipSpace() {
+  while (p_ < end_ && ::isspace(static_cast<unsigned char>(*p_))) {
+    p_++;
+  }
 }
 
 }  // namespace reader
-
 }  // namespace aliyun
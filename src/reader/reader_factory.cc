@@ -0,0 +1,41 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/reader/reader_factory.h"
+
+namespace aliyun {
+namespace reader {
+
+Reader* ReaderFactory::getThreadInstance(FormatType format) {
+  // made on first use in each thread, destroyed when it exits.
+  if (FormatType::JSON == format) {
+    static thread_local JsonReader jsonReader;
+    jsonReader.reset();
+    return &jsonReader;
+  }
+  if (FormatType::XML == format) {
+    static thread_local XmlReader xmlReader;
+    xmlReader.reset();
+    return &xmlReader;
+  }
+  return NULL;
+}
+
+}  // namespace reader
+}  // namespace aliyun
@@ -0,0 +1,429 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/reader/xml_pull_parser.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aliyun/reader/xml_reader.h"
+
+namespace aliyun {
+namespace reader {
+
+using std::string;
+using utils::StringPiece;
+
+static bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool isNameStart(char c) {
+  return ::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == ':'
+      || (c & 0x80) != 0;
+}
+
+static bool isNameChar(char c) {
+  return !isSpace(c) && c != '>' && c != '/' && c != '<' && c != '=';
+}
+
+// 1 if [p, end) starts with `literal`, 0 if not, -1 if it is too short to
+// tell.
+static int startsWith(const char* p, const char* end, const char* literal) {
+  for (; *literal != '\0'; literal++, p++) {
+    if (p == end) {
+      return -1;
+    }
+    if (*p != *literal) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void appendUtf8(unsigned code, string* out) {
+  if (code < 0x80) {
+    out->push_back(static_cast<char>(code));
+  } else if (code < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  } else if (code < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  }
+}
+
+// the entity between '&' and ';'.
+static void appendEntity(const char* p, const char* end, string* out) {
+  StringPiece name(p, end - p);
+  if (name == "lt") {
+    out->push_back('<');
+  } else if (name == "gt") {
+    out->push_back('>');
+  } else if (name == "amp") {
+    out->push_back('&');
+  } else if (name == "quot") {
+    out->push_back('"');
+  } else if (name == "apos") {
+    out->push_back('\'');
+  } else if (name.size() > 1 && name[0] == '#') {
+    bool hex = name[1] == 'x';
+    string digits(p + (hex ? 2 : 1), end);
+    char* last = NULL;
+    unsigned long code = ::strtoul(digits.c_str(),  // long: follow strtoul
+                                   &last, hex ? 16 : 10);
+    if (digits.empty() || *last != '\0' || code == 0 || code > 0x10FFFF) {
+      throw XmlException("invalid character reference");
+    }
+    appendUtf8(static_cast<unsigned>(code), out);
+  } else {
+    throw XmlException("undefined entity");
+  }
+}
+
+XmlPullParser::XmlPullParser()
+    : pos_(0),
+      scanned_(0),
+      finished_(false),
+      rootSeen_(false),
+      pendingEnd_(false) {
+}
+
+void XmlPullParser::reset() {
+  buffer_.clear();
+  pos_ = 0;
+  scanned_ = 0;
+  finished_ = false;
+  rootSeen_ = false;
+  pendingEnd_ = false;
+  openNames_.clear();
+  openStarts_.clear();
+  name_ = StringPiece();
+  text_ = StringPiece();
+}
+
+void XmlPullParser::feed(const char* data, size_t size) {
+  // drop what has been parsed, only an incomplete token is left.
+  if (pos_ > 0) {
+    buffer_.erase(0, pos_);
+    pos_ = 0;
+  }
+  buffer_.append(data, size);
+}
+
+void XmlPullParser::finish() {
+  finished_ = true;
+}
+
+XmlPullParser::Event XmlPullParser::next() {
+  if (pendingEnd_) {
+    pendingEnd_ = false;
+    openNames_.resize(openStarts_.back());
+    openStarts_.pop_back();
+    return END_ELEMENT;
+  }
+
+  const char* end = buffer_.data() + buffer_.size();
+  while (pos_ < buffer_.size()) {
+    const char* p = buffer_.data() + pos_;
+    Event event;
+    if (*p == '<') {
+      if (readMarkup(p, end, &event)) {
+        return event;
+      }
+    } else if (readText(p, end, &event)) {
+      return event;
+    }
+  }
+
+  if (!finished_) {
+    return NEED_MORE;
+  }
+  if (!openStarts_.empty()) {
+    throw XmlException("element unclosed: "
+                       + openNames_.substr(openStarts_.back()));
+  }
+  if (!rootSeen_) {
+    throw XmlException("no element found");
+  }
+  return END_DOCUMENT;
+}
+
+bool XmlPullParser::readText(const char* p, const char* end, Event* event) {
+  const char* q = static_cast<const char*>(::memchr(p, '<', end - p));
+  if (q == NULL) {
+    q = end;
+  }
+
+  if (openStarts_.empty()) {
+    for (const char* s = p; s < q; s++) {
+      if (!isSpace(*s)) {
+        throw XmlException(rootSeen_ ? "junk after document element"
+                                     : "text outside of root element");
+      }
+    }
+    pos_ = q - buffer_.data();
+    return false;
+  }
+
+  if (q == end && !finished_) {
+    // keep an incomplete entity or "\r" for the next piece.
+    for (const char* s = q; s > p && q - s < 16; s--) {
+      if (s[-1] == ';') {
+        break;
+      }
+      if (s[-1] == '&') {
+        q = s - 1;
+        break;
+      }
+    }
+    if (q > p && q[-1] == '\r') {
+      q--;
+    }
+    if (q == p) {
+      return needMore(event);
+    }
+  }
+
+  decode(p, q);
+  pos_ = q - buffer_.data();
+  *event = TEXT;
+  return true;
+}
+
+bool XmlPullParser::readMarkup(const char* p, const char* end, Event* event) {
+  if (end - p < 2) {
+    return needMore(event);
+  }
+
+  const char* q;
+  if (p[1] == '/') {
+    return readEndTag(p, end, event);
+  }
+  if (p[1] == '?') {
+    if ((q = find(p + 2, end, "?>")) == NULL) {
+      return needMore(event);
+    }
+    pos_ = q + 2 - buffer_.data();
+    return false;
+  }
+  if (p[1] != '!') {
+    return readStartTag(p, end, event);
+  }
+
+  int comment = startsWith(p, end, "<!--");
+  if (comment == 1) {
+    if ((q = find(p + 4, end, "-->")) == NULL) {
+      return needMore(event);
+    }
+    pos_ = q + 3 - buffer_.data();
+    return false;
+  }
+
+  int cdata = startsWith(p, end, "<![CDATA[");
+  if (cdata == 1) {
+    if (openStarts_.empty()) {
+      throw XmlException("text outside of root element");
+    }
+    if ((q = find(p + 9, end, "]]>")) == NULL) {
+      return needMore(event);
+    }
+    text_ = StringPiece(p + 9, q - p - 9);
+    pos_ = q + 3 - buffer_.data();
+    *event = TEXT;
+    return true;
+  }
+
+  int doctype = startsWith(p, end, "<!DOCTYPE");
+  if (doctype == 1) {
+    // skips the internal subset in brackets too.
+    int depth = 0;
+    char quote = 0;
+    for (q = p + 9; q < end; q++) {
+      char c = *q;
+      if (quote != 0) {
+        quote = c == quote ? 0 : quote;
+      } else if (c == '"' || c == '\'') {
+        quote = c;
+      } else if (c == '[') {
+        depth++;
+      } else if (c == ']') {
+        depth--;
+      } else if (c == '>' && depth <= 0) {
+        pos_ = q + 1 - buffer_.data();
+        return false;
+      }
+    }
+    return needMore(event);
+  }
+
+  if (comment < 0 || cdata < 0 || doctype < 0) {
+    return needMore(event);
+  }
+  throw XmlException("not well-formed (invalid token)");
+}
+
+bool XmlPullParser::readStartTag(const char* p, const char* end,
+                                 Event* event) {
+  const char* q = p + 1;
+  if (!isNameStart(*q)) {
+    throw XmlException("not well-formed (invalid token)");
+  }
+  while (q < end && isNameChar(*q)) {
+    q++;
+  }
+  StringPiece name(p + 1, q - p - 1);
+
+  // attributes are skipped.
+  char quote = 0;
+  for (; q < end; q++) {
+    char c = *q;
+    if (quote != 0) {
+      quote = c == quote ? 0 : quote;
+    } else if (c == '"' || c == '\'') {
+      quote = c;
+    } else if (c == '>') {
+      break;
+    } else if (c == '<') {
+      throw XmlException("not well-formed (invalid token)");
+    }
+  }
+  if (q == end) {
+    return needMore(event);
+  }
+
+  if (openStarts_.empty()) {
+    if (rootSeen_) {
+      throw XmlException("junk after document element");
+    }
+    rootSeen_ = true;
+  }
+  openStarts_.push_back(openNames_.size());
+  name.appendTo(&openNames_);
+
+  name_ = name;
+  pendingEnd_ = q[-1] == '/';
+  pos_ = q + 1 - buffer_.data();
+  *event = START_ELEMENT;
+  return true;
+}
+
+bool XmlPullParser::readEndTag(const char* p, const char* end,
+                               Event* event) {
+  const char* q = find(p + 2, end, ">");
+  if (q == NULL) {
+    return needMore(event);
+  }
+  const char* last = q;
+  while (last > p + 2 && isSpace(last[-1])) {
+    last--;
+  }
+
+  StringPiece name(p + 2, last - p - 2);
+  if (openStarts_.empty()
+      || name != StringPiece(openNames_.data() + openStarts_.back(),
+                             openNames_.size() - openStarts_.back())) {
+    throw XmlException("mismatched tag");
+  }
+  openNames_.resize(openStarts_.back());
+  openStarts_.pop_back();
+
+  name_ = name;
+  pos_ = q + 1 - buffer_.data();
+  *event = END_ELEMENT;
+  return true;
+}
+
+// finds `term` after `p`, resuming where the last search for the same token
+// stopped.
+const char* XmlPullParser::find(const char* p, const char* end,
+                                const char* term) {
+  size_t size = ::strlen(term);
+  const char* from = buffer_.data() + pos_ + scanned_;
+  if (from < p) {
+    from = p;
+  }
+  for (const char* q = from; end - q >= static_cast<ptrdiff_t>(size); q++) {
+    q = static_cast<const char*>(::memchr(q, term[0], end - q));
+    if (q == NULL) {
+      break;
+    }
+    if (static_cast<size_t>(end - q) >= size
+        && ::memcmp(q, term, size) == 0) {
+      scanned_ = 0;
+      return q;
+    }
+  }
+
+  size_t searched = end - buffer_.data() - pos_;
+  scanned_ = searched >= size ? searched - size + 1 : 0;
+  return NULL;
+}
+
+bool XmlPullParser::needMore(Event* event) {
+  if (finished_) {
+    throw XmlException("unclosed token");
+  }
+  *event = NEED_MORE;
+  return true;
+}
+
+// text with entities decoded and line ends normalized to '\n'.
+void XmlPullParser::decode(const char* p, const char* end) {
+  const char* s = p;
+  while (s < end && *s != '&' && *s != '\r') {
+    s++;
+  }
+  if (s == end) {
+    text_ = StringPiece(p, end - p);
+    return;
+  }
+
+  decoded_.assign(p, s - p);
+  while (s < end) {
+    char c = *s++;
+    if (c == '\r') {
+      decoded_.push_back('\n');
+      if (s < end && *s == '\n') {
+        s++;
+      }
+    } else if (c == '&') {
+      const char* semicolon = static_cast<const char*>(
+          ::memchr(s, ';', end - s));
+      if (semicolon == NULL) {
+        throw XmlException("undefined entity");
+      }
+      appendEntity(s, semicolon, &decoded_);
+      s = semicolon + 1;
+    } else {
+      decoded_.push_back(c);
+    }
+  }
+  text_ = decoded_;
+}
+
+}  // namespace reader
+}  // namespace aliyun
@@ -18,6 +18,9 @@
  */
 
 #include "aliyun/reader/xml_reader.h"
+
+#include <utility>
+
 #include "aliyun/utils/string_utils.h"
 #include "aliyun/utils/details/global_initializer.h"
 
@@ -25,11 +28,155 @@ namespace aliyun {
 
 namespace reader {
 
+// builds path => value pairs from the events, laid out as before:
+// an element whose children all have one name is a list, path[i] and
+// path.Length, a single child is both path[0] and path.name, otherwise
+// children are path.name with the last one winning.
+//
+// the layout is known at the end of an element, or once a child with
+// another name shows up. till then pairs of its children are kept relative
+// to them.
+class XmlReader::PathBuilder : public ReaderHandler {
+ public:
+  PathBuilder(const string& endpoint, std::map<string, string>* result)
+      : endpoint_(endpoint),
+        result_(result) {
+  }
+
+  Action onObjectBegin() {
+    stack_.push_back(Frame());
+    stack_.back().name = key_;
+    return CONTINUE;
+  }
+
+  Action onObjectEnd();
+
+  Action onKey(const StringPiece& key);
+
+  Action onValue(const StringPiece& value, ValueType /* type */) {
+    Pairs pairs(1);
+    value.appendTo(&pairs[0].value);
+    add(key_, &pairs);
+    return CONTINUE;
+  }
+
+ private:
+  struct Pair {
+    string path;  // relative
+    string value;
+  };
+
+  typedef std::vector<Pair> Pairs;
+
+  struct Frame {
+    Frame()
+        : children(0),
+          mixed(false) {
+    }
+
+    string name;
+    size_t children;
+    string firstName;
+    bool mixed;
+    Pairs pairs;  // of children, once mixed
+    std::vector<Pairs> pending;  // of children, while not mixed
+  };
+
+  static void append(const string& prefix, Pairs* from, Pairs* to) {
+    for (size_t i = 0; i < from->size(); i++) {
+      Pair& pair = (*from)[i];
+      pair.path.insert(0, prefix);
+      to->push_back(Pair());
+      to->back().path.swap(pair.path);
+      to->back().value.swap(pair.value);
+    }
+  }
+
+  void add(const string& name, Pairs* pairs);
+
+  string endpoint_;
+  std::map<string, string>* result_;
+  std::vector<Frame> stack_;
+  string key_;
+};
+
+ReaderHandler::Action XmlReader::PathBuilder::onKey(const StringPiece& key) {
+  key_.assign(key.data(), key.size());
+
+  Frame& frame = stack_.back();
+  if (frame.children++ == 0) {
+    frame.firstName = key_;
+  } else if (!frame.mixed && key_ != frame.firstName) {
+    frame.mixed = true;
+    for (size_t i = 0; i < frame.pending.size(); i++) {
+      append("." + frame.firstName, &frame.pending[i], &frame.pairs);
+    }
+    frame.pending.clear();
+  }
+  return CONTINUE;
+}
+
+ReaderHandler::Action XmlReader::PathBuilder::onObjectEnd() {
+  Frame frame;
+  std::swap(frame, stack_.back());
+  stack_.pop_back();
+
+  Pairs pairs;
+  if (frame.mixed) {
+    pairs.swap(frame.pairs);
+  } else {
+    using aliyun::utils::StringUtils::ToString;
+    pairs.push_back(Pair());
+    pairs.back().path = ".Length";
+    pairs.back().value = ToString(frame.children);
+    if (frame.children == 1) {
+      Pairs copy = frame.pending[0];
+      append("[0]", &copy, &pairs);
+      append("." + frame.firstName, &frame.pending[0], &pairs);
+    } else {
+      for (size_t i = 0; i < frame.pending.size(); i++) {
+        append("[" + ToString(i) + "]", &frame.pending[i], &pairs);
+      }
+    }
+  }
+  add(frame.name, &pairs);
+  return CONTINUE;
+}
+
+// pairs of a finished element named `name`.
+void XmlReader::PathBuilder::add(const string& name, Pairs* pairs) {
+  if (stack_.empty()) {
+    for (size_t i = 0; i < pairs->size(); i++) {
+      (*result_)[endpoint_ + (*pairs)[i].path].swap((*pairs)[i].value);
+    }
+    return;
+  }
+
+  Frame& parent = stack_.back();
+  if (parent.mixed) {
+    append("." + name, pairs, &parent.pairs);
+  } else {
+    parent.pending.push_back(Pairs());
+    parent.pending.back().swap(*pairs);
+  }
+}
+
+static utils::StringPiece localName(const utils::StringPiece& name) {
+  for (size_t i = name.size(); i > 0; i--) {
+    if (name[i - 1] == ':') {
+      return name.substr(i);
+    }
+  }
+  return name;
+}
+
 XmlReader::XmlReader()
     : pool_(NULL),
       pdoc_(NULL),
-      parser_(NULL) {
-  prepareParser();
+      parser_(NULL),
+      handler_(NULL),
+      skipDepth_(0),
+      stopped_(false) {
 }
 
 XmlReader::~XmlReader() {
@@ -38,10 +185,15 @@ XmlReader::~XmlReader() {
   }
 }
 
-apr_xml_doc* XmlReader::getDocument(string xml) {
+apr_xml_doc* XmlReader::getDocument(const string& xml) {
   apr_status_t rc;
   char emsg[256];
 
+  // a parser is good for one document, a fresh one is made in the pool
+  // cleared of the last document.
+  reset();
+  prepareParser();
+
 #define apr_check_throw(rc) \
   do { \
     if (APR_SUCCESS != rc)  \
@@ -66,7 +218,7 @@ std::string XmlReader::getContent(node* n) {
   return text;
 }
 
-const char* XmlReader::getAttribute(node* n, string name) {
+const char* XmlReader::getAttribute(node* n, const string& name) {
   for (apr_xml_attr* a = n->attr; a; a = a->next) {
     if (a->name == name) {
       return a->value;
@@ -75,13 +227,13 @@ const char* XmlReader::getAttribute(node* n, string name) {
   return NULL;
 }
 
-std::vector<XmlReader::node*> XmlReader::getElementsByTagName(document* doc,
-                                                              string tag) {
+std::vector<XmlReader::node*> XmlReader::getElementsByTagName(
+    document* doc, const string& tag) {
   return getChildElements(doc->root, tag);;
 }
 
-std::vector<XmlReader::node*> XmlReader::getElementsByTagName(node* curr,
-                                                              string tag) {
+std::vector<XmlReader::node*> XmlReader::getElementsByTagName(
+    node* curr, const string& tag) {
   std::vector<node*> result;
   for (node* n = curr->first_child; n; n = n->next) {
     if (n->name == tag) {
@@ -94,15 +246,42 @@ std::vector<XmlReader::node*> XmlReader::getElementsByTagName(node* curr,
   return result;
 }
 
-std::map<std::string, std::string> XmlReader::read(string response,
-                                                   string endpoint) {
-  getDocument(response.c_str());
+std::map<std::string, std::string> XmlReader::read(const string& response,
+                                                   const string& endpoint) {
+  std::map<string, string> result;
+  PathBuilder builder(endpoint, &result);
+  read(response, &builder);
+  return result;
+}
 
-  apr_xml_elem* root = pdoc_->root;
+bool XmlReader::read(const string& response, ReaderHandler* handler) {
+  begin(handler);
+  return feed(response.data(), response.size()) && finish();
+}
 
-  read(root, endpoint.c_str(), false);
+void XmlReader::begin(ReaderHandler* handler) {
+  pull_.reset();
+  handler_ = handler;
+  open_.clear();
+  text_.clear();
+  skipDepth_ = 0;
+  stopped_ = false;
+}
 
-  return map_;
+bool XmlReader::feed(const char* data, size_t size) {
+  if (stopped_) {
+    return false;
+  }
+  pull_.feed(data, size);
+  return pump();
+}
+
+bool XmlReader::finish() {
+  if (stopped_) {
+    return false;
+  }
+  pull_.finish();
+  return pump();
 }
 
 void XmlReader::dump() {
@@ -119,8 +298,8 @@ std::vector<apr_xml_elem*> XmlReader::getChildElements(apr_xml_elem* parent) {
   return childs;
 }
 
-std::vector<apr_xml_elem*> XmlReader::getChildElements(apr_xml_elem* parent,
-                                                       string tagName) {
+std::vector<apr_xml_elem*> XmlReader::getChildElements(
+    apr_xml_elem* parent, const string& tagName) {
   std::vector<apr_xml_elem*> childs;
   for (apr_xml_elem* c = parent->first_child; c; c = c->next) {
     if (c->name == tagName) {
@@ -158,11 +337,21 @@ void XmlReader::dumpElements(apr_xml_elem* e, int depth) {
   }
 }
 
+void XmlReader::reset() {
+  if (pool_ != NULL) {
+    apr_pool_clear(pool_);
+  }
+  pdoc_ = NULL;
+  parser_ = NULL;
+  begin(NULL);
+}
+
 void XmlReader::prepareParser() {
-  apr_status_t rc;
+  apr_status_t rc = APR_ENOMEM;
   char emsg[256];
 
-  if ((rc = apr_pool_create(&pool_, NULL)) != APR_SUCCESS) {
+  if (pool_ == NULL
+      && (rc = apr_pool_create(&pool_, NULL)) != APR_SUCCESS) {
     throw XmlException(apr_strerror(rc, emsg, sizeof(emsg)));
   }
 
@@ -172,49 +361,85 @@ void XmlReader::prepareParser() {
   }
 }
 
-void XmlReader::read(apr_xml_elem* element, string path, bool appendPath) {
-  path = buildPath(element, path, appendPath);
-  std::vector<apr_xml_elem*> children = getChildElements(element);
-
-  // leaf node
-  if (children.size() == 0) {
-    map_[path] = getContent(element);
-    return;
+// reports events of the parsed input, false once the handler stopped.
+bool XmlReader::pump() {
+  for (;;) {
+    bool proceed = true;
+    switch (pull_.next()) {
+      case XmlPullParser::START_ELEMENT:
+        proceed = startElement();
+        break;
+      case XmlPullParser::END_ELEMENT:
+        proceed = endElement();
+        break;
+      case XmlPullParser::TEXT:
+        // only text of leaves is reported.
+        if (skipDepth_ == 0 && !open_.empty() && !open_.back()) {
+          pull_.getText().appendTo(&text_);
+        }
+        break;
+      default:
+        return true;
+    }
+    if (!proceed) {
+      stopped_ = true;
+      return false;
+    }
   }
+}
 
-  // otherwise, internal node
+bool XmlReader::startElement() {
+  typedef ReaderHandler Handler;
 
-  // find all children with the same name as children[0]
-  std::vector<apr_xml_elem*> sameName = getChildElements(element,
-                                                         children[0]->name);
+  if (skipDepth_ > 0) {
+    skipDepth_++;
+    return true;
+  }
 
-  if (sameName.size() > 1 && children.size() == sameName.size()) {
-    // more than one child has same name as children[0]
-    // likes, <parent><child>xx</child>...<child>yy</child></parent>
-    elementsAsList(&children, path);
-  } else if (sameName.size() == 1 && children.size() == 1) {
-    // only one child under current element
-    // likes, <parent><child>...</child></parent>
-    elementsAsList(&children, path);
-    read(children[0], path, true);
-  } else {
-    for (size_t i = 0; i < children.size(); i++) {
-      read(children[i], path, true);
+  // an element is an object once its first child shows up.
+  if (!open_.empty()) {
+    if (!open_.back()) {
+      open_.back() = true;
+      Handler::Action action = handler_->onObjectBegin();
+      if (action == Handler::STOP) {
+        return false;
+      }
+      if (action == Handler::SKIP) {
+        open_.pop_back();
+        skipDepth_ = 2;
+        return true;
+      }
+    }
+
+    Handler::Action action = handler_->onKey(localName(pull_.getName()));
+    if (action == Handler::STOP) {
+      return false;
+    }
+    if (action == Handler::SKIP) {
+      skipDepth_ = 1;
+      return true;
     }
   }
-}
 
-std::string XmlReader::buildPath(apr_xml_elem* element, const string& path,
-                                 bool appendPath) {
-  return appendPath ? path + "." + element->name : path;
+  open_.push_back(false);
+  text_.clear();
+  return true;
 }
 
-void XmlReader::elementsAsList(std::vector<apr_xml_elem*>* elems, string path) {
-  using aliyun::utils::StringUtils::ToString;
-  map_[path + ".Length"] = ToString(elems->size());
-  for (size_t i = 0; i < elems->size(); i++) {
-    read((*elems)[i], path + "[" + ToString(i) + "]", false);
+bool XmlReader::endElement() {
+  typedef ReaderHandler Handler;
+
+  if (skipDepth_ > 0) {
+    skipDepth_--;
+    return true;
   }
+
+  bool object = open_.back();
+  open_.pop_back();
+  Handler::Action action = object
+      ? handler_->onObjectEnd()
+      : handler_->onValue(text_, Handler::STRING_VALUE);
+  return action != Handler::STOP;
 }
 
 }  // namespace reader
@@ -71,7 +71,8 @@ std::string Base64Helper::encode(const byte* buffer, int length) {
   return str;
 }
 
-std::string Base64Helper::encode(std::string str, std::string encoding) {
+std::string Base64Helper::encode(const std::string& str,
+                                 const std::string& encoding) {
   if (str.length() == 0 || encoding.length() == 0) {
     return "";
   }
@@ -80,7 +81,8 @@ std::string Base64Helper::encode(std::string str, std::string encoding) {
   return encode(bptr, dstEncStr.size());
 }
 
-std::string Base64Helper::decode(std::string str, std::string encoding) {
+std::string Base64Helper::decode(const std::string& str,
+                                 const std::string& encoding) {
   if (str.length() == 0 || encoding.length() == 0) {
     return "";
   }
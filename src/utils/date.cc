@@ -27,6 +27,23 @@ namespace utils {
 const char* Date::kMonthName[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun",
     "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
 
+// reentrant localtime() and gmtime().
+static void toLocalTime(time_t t, struct tm* tm) {
+#ifdef _WIN32
+  ::localtime_s(tm, &t);
+#else
+  ::localtime_r(&t, tm);
+#endif
+}
+
+static void toUtcTime(time_t t, struct tm* tm) {
+#ifdef _WIN32
+  ::gmtime_s(tm, &t);
+#else
+  ::gmtime_r(&t, tm);
+#endif
+}
+
 Date::Date()
     : time_(0) {
   ::memset(&tm_, 0, sizeof(struct tm));
@@ -34,7 +51,7 @@ Date::Date()
 
 Date::Date(time_t t)
     : time_(t) {
-  ::memcpy(&tm_, ::localtime(&time_), sizeof(struct tm));
+  toLocalTime(time_, &tm_);
 }
 
 Date::Date(struct tm* tm) {
@@ -48,6 +65,10 @@ Date::Date(int year, int mon, int day, int hour, int min, int sec) {
   //    tm_year   The number of years since 1900.
   //    tm_mon    The number of months since January, in the range 0 to 11.
   //    tm_wday   The number of days since Sunday, in the range 0 to 6.
+  //    tm_isdst  Negative to let mktime() find out, other fields are
+  //              cleared, garbage there shifts the time.
+  ::memset(&tm_, 0, sizeof(struct tm));
+  tm_.tm_isdst = -1;
   tm_.tm_year = year - 1900;
   tm_.tm_mon = mon - 1;
   tm_.tm_mday = day;
@@ -60,14 +81,14 @@ Date::Date(int year, int mon, int day, int hour, int min, int sec) {
 Date Date::currentLocalDate() {
   Date d;
   d.time_ = time(NULL);
-  d.tm_ = *::localtime(&d.time_);
+  toLocalTime(d.time_, &d.tm_);
   return d;
 }
 
 Date Date::currentUtcDate() {
   Date d;
   d.time_ = time(NULL);
-  d.tm_ = *::gmtime(&d.time_);
+  toUtcTime(d.time_, &d.tm_);
   return d;
 }
 
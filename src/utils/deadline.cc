@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/utils/deadline.h"
+
+namespace aliyun {
+namespace utils {
+
+Deadline::Deadline()
+    : at_(),
+      set_(false) {
+}
+
+Deadline Deadline::after(long millis) {
+  Deadline deadline;
+  deadline.at_ = Clock::now() + std::chrono::milliseconds(millis);
+  deadline.set_ = true;
+  return deadline;
+}
+
+bool Deadline::expired() const {
+  return set_ && Clock::now() >= at_;
+}
+
+long Deadline::remainingMillis() const {
+  if (!set_) {
+    return -1;
+  }
+  Clock::time_point now = Clock::now();
+  if (now >= at_) {
+    return 0;
+  }
+  // round up, never report 0 before really expired.
+  std::chrono::microseconds left =
+      std::chrono::duration_cast<std::chrono::microseconds>(at_ - now);
+  return static_cast<long>((left.count() + 999) / 1000);
+}
+
+Deadline Deadline::min(const Deadline& lhs, const Deadline& rhs) {
+  if (!lhs.set_) {
+    return rhs;
+  }
+  if (!rhs.set_) {
+    return lhs;
+  }
+  return lhs.at_ < rhs.at_ ? lhs : rhs;
+}
+
+}  // namespace utils
+}  // namespace aliyun
@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif  // USE_ZLIB
+
+#include "aliyun/utils/gzip_helper.h"
+
+namespace aliyun {
+namespace utils {
+
+#ifdef USE_ZLIB
+
+// minimum output buffer grown for each inflate call.
+static const size_t MIN_INFLATE_CHUNK = 16 * 1024;
+
+GzipInflater::GzipInflater()
+    : stream_(NULL),
+      detected_(false),
+      raw_(false),
+      finished_(false) {
+  stream_ = new z_stream;
+  ::memset(stream_, 0, sizeof(z_stream));
+  // 32: detect gzip or zlib header automatically.
+  if (inflateInit2(stream_, 32 + MAX_WBITS) != Z_OK) {
+    delete stream_;
+    throw GzipException("inflate init fail");
+  }
+}
+
+GzipInflater::~GzipInflater() {
+  inflateEnd(stream_);
+  delete stream_;
+}
+
+bool GzipInflater::isSupported() {
+  return true;
+}
+
+void GzipInflater::inflate(const char* data, size_t length, std::string* out) {
+  if (finished_ || length == 0) {
+    return;
+  }
+  if (!detected_) {
+    head_.append(data, length);
+  }
+
+  size_t origin = out->size();
+  int ret = feed(data, length, out);
+  if (ret == Z_DATA_ERROR && !detected_ && !raw_) {
+    // some servers send "deflate" without zlib header, retry as raw deflate.
+    raw_ = true;
+    inflateReset2(stream_, -MAX_WBITS);
+    out->resize(origin);
+    ret = feed(head_.data(), head_.size(), out);
+  }
+  if (ret != Z_OK && ret != Z_STREAM_END) {
+    throw GzipException(stream_->msg ? stream_->msg : "inflate fail");
+  }
+
+  if (!detected_ && (raw_ || out->size() > origin || finished_)) {
+    detected_ = true;
+    std::string().swap(head_);
+  }
+}
+
+int GzipInflater::feed(const char* data, size_t length, std::string* out) {
+  stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream_->avail_in = static_cast<uInt>(length);
+
+  size_t chunk = length * 4;  // guess compress ratio
+  if (chunk < MIN_INFLATE_CHUNK) {
+    chunk = MIN_INFLATE_CHUNK;
+  }
+
+  int ret = Z_OK;
+  while (ret == Z_OK) {
+    size_t used = out->size();
+    out->resize(used + chunk);
+    stream_->next_out = reinterpret_cast<Bytef*>(&(*out)[used]);
+    stream_->avail_out = static_cast<uInt>(chunk);
+
+    ret = ::inflate(stream_, Z_NO_FLUSH);
+    out->resize(used + chunk - stream_->avail_out);
+
+    if (ret == Z_STREAM_END) {
+      if (stream_->avail_in > 0 && !raw_) {
+        inflateReset(stream_);  // concatenated gzip members
+        ret = Z_OK;
+      } else {
+        finished_ = true;
+      }
+    } else if (ret == Z_BUF_ERROR) {
+      ret = Z_OK;  // need more input
+      break;
+    } else if (ret == Z_OK && stream_->avail_in == 0
+        && stream_->avail_out != 0) {
+      break;  // all input consumed
+    }
+  }
+  return ret;
+}
+
+bool GzipHelper::isSupported() {
+  return true;
+}
+
+std::string GzipHelper::compress(const std::string& data, int level) {
+  z_stream stream;
+  ::memset(&stream, 0, sizeof(stream));
+  // 16: write gzip header and trailer instead of zlib ones.
+  if (deflateInit2(&stream, level, Z_DEFLATED, 16 + MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw GzipException("deflate init fail");
+  }
+
+  std::string out;
+  out.resize(deflateBound(&stream, data.size()));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+  stream.avail_out = static_cast<uInt>(out.size());
+
+  int ret = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+  if (ret != Z_STREAM_END) {
+    throw GzipException("deflate fail");
+  }
+  out.resize(stream.total_out);
+  return out;
+}
+
+#else  // USE_ZLIB
+
+GzipInflater::GzipInflater()
+    : stream_(NULL),
+      detected_(false),
+      raw_(false),
+      finished_(false) {
+  throw GzipException("gzip not supported, build with zlib");
+}
+
+GzipInflater::~GzipInflater() {
+}
+
+bool GzipInflater::isSupported() {
+  return false;
+}
+
+void GzipInflater::inflate(const char* data, size_t length, std::string* out) {
+}
+
+int GzipInflater::feed(const char* data, size_t length, std::string* out) {
+  return 0;
+}
+
+bool GzipHelper::isSupported() {
+  return false;
+}
+
+std::string GzipHelper::compress(const std::string& data, int level) {
+  throw GzipException("gzip not supported, build with zlib");
+}
+
+#endif  // USE_ZLIB
+
+std::string GzipHelper::decompress(const std::string& data) {
+  GzipInflater inflater;
+  std::string out;
+  inflater.inflate(data.data(), data.size(), &out);
+  if (!inflater.finished()) {
+    throw GzipException("unexpected end of compressed data");
+  }
+  return out;
+}
+
+}  // namespace utils
+}  // namespace aliyun
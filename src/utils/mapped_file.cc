@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/utils/mapped_file.h"
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else  // _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _MSC_VER
+
+namespace aliyun {
+namespace utils {
+
+#ifdef _MSC_VER
+
+MappedFile::MappedFile(const std::string& path) throw(aliyun::Exception)
+    : data_(NULL),
+      size_(0),
+      mtime_(0) {
+  HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw aliyun::Exception("can not open file: " + path);
+  }
+
+  LARGE_INTEGER size;
+  FILETIME written;
+  if (!::GetFileSizeEx(file, &size)
+      || !::GetFileTime(file, NULL, NULL, &written)) {
+    ::CloseHandle(file);
+    throw aliyun::Exception("can not stat file: " + path);
+  }
+  // 100ns ticks since 1601 to seconds since 1970.
+  int64_t ticks = (static_cast<int64_t>(written.dwHighDateTime) << 32)
+      | written.dwLowDateTime;
+  mtime_ = ticks / 10000000 - INT64_C(11644473600);
+  if (size.QuadPart == 0) {
+    ::CloseHandle(file);
+    return;
+  }
+
+  // the view keeps the mapping alive, handles can be closed right away.
+  HANDLE mapping = ::CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  ::CloseHandle(file);
+  if (mapping == NULL) {
+    throw aliyun::Exception("can not map file: " + path);
+  }
+  void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  ::CloseHandle(mapping);
+  if (view == NULL) {
+    throw aliyun::Exception("can not map file: " + path);
+  }
+  data_ = static_cast<const char*>(view);
+  size_ = static_cast<size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != NULL) {
+    ::UnmapViewOfFile(data_);
+  }
+}
+
+#else  // _MSC_VER
+
+MappedFile::MappedFile(const std::string& path) throw(aliyun::Exception)
+    : data_(NULL),
+      size_(0),
+      mtime_(0) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw aliyun::Exception("can not open file: " + path);
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw aliyun::Exception("can not stat file: " + path);
+  }
+  mtime_ = static_cast<int64_t>(st.st_mtime);
+  if (st.st_size == 0) {  // mmap rejects zero length
+    ::close(fd);
+    return;
+  }
+
+  // the mapping keeps the file referenced, fd can be closed right away.
+  void* addr = ::mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    throw aliyun::Exception("can not map file: " + path);
+  }
+#ifdef MADV_SEQUENTIAL
+  ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif  // MADV_SEQUENTIAL
+  data_ = static_cast<const char*>(addr);
+  size_ = static_cast<size_t>(st.st_size);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != NULL) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+#endif  // _MSC_VER
+
+}  // namespace utils
+}  // namespace aliyun
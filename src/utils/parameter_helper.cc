@@ -22,6 +22,7 @@
 #include <apr_md5.h>
 #include <apr_uuid.h>
 #include <cstring>
+#include <mutex>
 
 #include "aliyun/utils/base64_helper.h"
 
@@ -39,7 +40,7 @@ static const char* FORMAT_ISO8601 = "%Y-%m-%dT%H:%M:%SZ";
 // "Wed, 16 Jan 2013 19:01:18 GMT"
 static const char* FORMAT_RFC2616 = "%a, %d %b %Y %H:%M:%S GMT";
 
-std::string ParameterHelper::md5hex(std::string str) {
+std::string ParameterHelper::md5hex(const std::string& str) {
   byte md[APR_MD5_DIGESTSIZE] = { 0 };
   string result;
 
@@ -56,7 +57,7 @@ std::string ParameterHelper::md5hex(std::string str) {
   return result;
 }
 
-std::string ParameterHelper::md5Sum(std::string str) {
+std::string ParameterHelper::md5Sum(const std::string& str) {
   byte md[APR_MD5_DIGESTSIZE] = { 0 };
   apr_md5(md, reinterpret_cast<const byte*>(str.c_str()),
           static_cast<size_t>(str.length()));
@@ -64,16 +65,25 @@ std::string ParameterHelper::md5Sum(std::string str) {
 }
 
 ParameterHelper::byte *ParameterHelper::md5(const byte* data, size_t len) {
-  static byte md[APR_MD5_DIGESTSIZE] = { 0 };
+  static thread_local byte md[APR_MD5_DIGESTSIZE] = { 0 };
   apr_md5(md, data, len);
   return md;
 }
 
+void ParameterHelper::md5(const byte* data, size_t len, byte digest[16]) {
+  apr_md5(digest, data, len);
+}
+
 std::string ParameterHelper::getUUID() {
   apr_uuid_t uuid;
   char buffer[APR_UUID_FORMATTED_LENGTH + 1];
 
-  apr_uuid_get(&uuid);
+  {
+    // apr_uuid_get keeps its clock sequence in unguarded statics.
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> guard(mutex);
+    apr_uuid_get(&uuid);
+  }
   apr_uuid_format(buffer, &uuid);
   return buffer;
 }
@@ -92,7 +102,7 @@ std::string ParameterHelper::getRFC2616Date(Date date) {
   return date.format(FORMAT_RFC2616);
 }
 
-Date ParameterHelper::parse(string strDate) {
+Date ParameterHelper::parse(const string& strDate) {
   if (strDate.length() == 0) {
     return Date::currentUtcDate();
   }
@@ -103,7 +113,7 @@ Date ParameterHelper::parse(string strDate) {
   }
 }
 
-Date ParameterHelper::parseISO8601(string strDate) {
+Date ParameterHelper::parseISO8601(const string& strDate) {
   if (strDate.length() == 0) {
     return Date::currentUtcDate();
   }
@@ -117,7 +127,7 @@ Date ParameterHelper::parseISO8601(string strDate) {
   return Date(year, mon, day, hour, min, sec);
 }
 
-Date ParameterHelper::parseRFC2616(string strDate) {
+Date ParameterHelper::parseRFC2616(const string& strDate) {
   if (strDate.length() == 0) {
     return Date::currentUtcDate();
   }
@@ -138,14 +148,14 @@ Date ParameterHelper::parseRFC2616(string strDate) {
   // ::printf("%s: %s %s %s\n", __FUNCTION__, wkday, month, tzone); // debug
 
   // check month string
-  int mon = Date::kNumMonth;
+  int mon = 0;
   for (int i = 0; i < Date::kNumMonth; i++) {
     if (::strncmp(month, Date::kMonthName[i], sizeof(month)) == 0) {
       mon = i + 1;
       break;
     }
   }
-  if (mon == Date::kNumMonth) {
+  if (mon == 0) {
     throw ParseDateException("unmatch format RFC2616, bad month");
   }
 
@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "aliyun/utils/rate_limiter.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace aliyun {
+namespace utils {
+
+typedef RateLimiter::Clock Clock;
+
+const double RateLimiter::DEFAULT_BURST_SECONDS = 1.0;
+
+static Clock::duration secondsOf(double seconds) {
+  return std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(seconds));
+}
+
+static long toMillis(Clock::duration duration) {
+  // round up, never report 0 for a real wait.
+  std::chrono::milliseconds millis =
+      std::chrono::duration_cast<std::chrono::milliseconds>(duration);
+  if (millis < duration) {
+    millis += std::chrono::milliseconds(1);
+  }
+  return static_cast<long>(millis.count());
+}
+
+// a bucket holding `burst` can take a request of `cost` once paid down to
+// burst - cost, one larger than the bucket once it is empty.
+static Clock::time_point bucketReadyAt(Clock::time_point paid,
+                                       Clock::duration cost,
+                                       Clock::duration burst) {
+  return paid - (burst - std::min(cost, burst));
+}
+
+static RateLimiter::TimeSource* systemTimeSource() {
+  static RateLimiter::TimeSource timeSource;
+  return &timeSource;
+}
+
+Clock::time_point RateLimiter::TimeSource::now() {
+  return Clock::now();
+}
+
+void RateLimiter::TimeSource::sleepUntil(Clock::time_point at) {
+  std::this_thread::sleep_until(at);
+}
+
+RateLimiter::RateLimiter(double requestsPerSecond, double bytesPerSecond,
+                         double burstSeconds)
+    : requestsPerSecond_(requestsPerSecond),
+      bytesPerSecond_(bytesPerSecond),
+      burst_(secondsOf(burstSeconds > 0 ? burstSeconds : 0)),
+      requestsPaid_(),
+      bytesPaid_(),
+      totalWait_(Clock::duration::zero()),
+      timeSource_(systemTimeSource()) {
+}
+
+long RateLimiter::acquire(size_t bytes) {
+  Clock::time_point now = timeSource_->now();
+  Clock::time_point at;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    at = readyAt(now, bytes);
+    reserve(at, bytes);
+    if (at > now) {
+      totalWait_ += at - now;
+    }
+  }
+  if (at <= now) {
+    return 0;
+  }
+  timeSource_->sleepUntil(at);
+  return toMillis(at - now);
+}
+
+bool RateLimiter::tryAcquire(size_t bytes) {
+  Clock::time_point now = timeSource_->now();
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (readyAt(now, bytes) > now) {
+    return false;
+  }
+  reserve(now, bytes);
+  return true;
+}
+
+long RateLimiter::getWaitMillis() const {
+  Clock::time_point now = timeSource_->now();
+  std::lock_guard<std::mutex> guard(mutex_);
+  Clock::time_point at = readyAt(now, 0);
+  return at > now ? toMillis(at - now) : 0;
+}
+
+long RateLimiter::getTotalWaitMillis() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return toMillis(totalWait_);
+}
+
+void RateLimiter::setRate(double requestsPerSecond, double bytesPerSecond) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  requestsPerSecond_ = requestsPerSecond;
+  bytesPerSecond_ = bytesPerSecond;
+}
+
+double RateLimiter::getRequestsPerSecond() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return requestsPerSecond_;
+}
+
+double RateLimiter::getBytesPerSecond() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return bytesPerSecond_;
+}
+
+void RateLimiter::setBurstSeconds(double burstSeconds) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  burst_ = secondsOf(burstSeconds > 0 ? burstSeconds : 0);
+}
+
+double RateLimiter::getBurstSeconds() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return std::chrono::duration<double>(burst_).count();
+}
+
+void RateLimiter::setTimeSource(TimeSource* timeSource) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  timeSource_ = timeSource != NULL ? timeSource : systemTimeSource();
+}
+
+Clock::time_point RateLimiter::readyAt(Clock::time_point now,
+                                       size_t bytes) const {
+  Clock::time_point at = now;
+  if (requestsPerSecond_ > 0) {
+    at = std::max(at, bucketReadyAt(requestsPaid_,
+                                    secondsOf(1.0 / requestsPerSecond_),
+                                    burst_));
+  }
+  if (bytesPerSecond_ > 0) {
+    at = std::max(at, bucketReadyAt(bytesPaid_,
+                                    secondsOf(bytes / bytesPerSecond_),
+                                    burst_));
+  }
+  return at;
+}
+
+void RateLimiter::reserve(Clock::time_point at, size_t bytes) {
+  // an unused bucket fills up to burst_ only, older credit is lost.
+  if (requestsPerSecond_ > 0) {
+    requestsPaid_ = std::max(requestsPaid_, at)
+        + secondsOf(1.0 / requestsPerSecond_);
+  }
+  if (bytesPerSecond_ > 0) {
+    bytesPaid_ = std::max(bytesPaid_, at) + secondsOf(bytes / bytesPerSecond_);
+  }
+}
+
+}  // namespace utils
+}  // namespace aliyun
@@ -33,30 +33,29 @@ namespace utils {
 namespace StringUtils {
 
 std::string ToLowerCase(std::string str) {
-  std::string lowered(str);
   for (size_t i = 0; i < str.length(); i++) {
-    if (::isalpha(lowered[i]))
-      lowered[i] = ::tolower(str[i]);
+    if (::isalpha(str[i]))
+      str[i] = ::tolower(str[i]);
   }
-  return lowered;
+  return str;
 }
 
 std::string ToUpperCase(std::string str) {
-  std::string lowered(str);
   for (size_t i = 0; i < str.length(); i++) {
-    if (::isalpha(lowered[i]))
-      lowered[i] = ::toupper(str[i]);
+    if (::isalpha(str[i]))
+      str[i] = ::toupper(str[i]);
   }
-  return lowered;
+  return str;
 }
 
 // TODO(xu): string encoding convert
-std::string ToEncoding(std::string src, std::string encoding) {
+std::string ToEncoding(std::string src, const std::string& encoding) {
   return src;
 }
 
-std::string hexString(std::string src, bool caps) {
+std::string hexString(const std::string& src, bool caps) {
   std::string result;
+  result.reserve(src.length() * 2);
   const char* HEX = caps ? "0123456789ABCDEF" : "0123456789abcdef";
   for (size_t i = 0; i < src.length(); i++) {
     result.push_back(HEX[(src[i] >> 4) & 0x0F]);
@@ -78,24 +77,21 @@ std::string hexDump(void* ptr, int len, bool caps) {
 
 
 std::string trim(std::string src) {
-  std::string dst = src;
-  for (size_t i = 0; i < dst.length(); i++) {
-    if (!::isspace(dst[i])) {
-      dst = dst.substr(i);  // trim head spaces.
-      break;
-    }
+  size_t end = src.length();
+  while (end > 0 && ::isspace(src[end - 1])) {
+    end--;
   }
+  src.resize(end);  // trim tail spaces.
 
-  for (int i = dst.length() - 1; i >= 0; i--) {
-    if (!::isspace(dst[i])) {
-      dst.resize(i + 1);  // trim tail spaces.
-      break;
-    }
+  size_t begin = 0;
+  while (begin < end && ::isspace(src[begin])) {
+    begin++;
   }
-  return dst;
+  src.erase(0, begin);  // trim head spaces.
+  return src;
 }
 
-bool RegexMatch(std::string str, std::string pat) {
+bool RegexMatch(const std::string& str, const std::string& pat) {
 #ifdef USE_PCRE
   pcrecpp::RE re(pat);
   return re.FullMatch(str);
@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "aliyun/http/curl_handle_pool.h"
+#include "aliyun/http/http_request.h"
+
+using aliyun::http::CurlHandle;
+using aliyun::http::CurlHandlePool;
+
+TEST(CurlHandlePoolTest, testReuse) {
+  CurlHandlePool pool(2);
+  EXPECT_EQ(2, pool.getMaxIdleHandles());
+  EXPECT_EQ(0, pool.getIdleHandles());
+
+  CURL* first = pool.acquire();
+  EXPECT_TRUE(first != NULL);
+  pool.release(first);
+  EXPECT_EQ(1, pool.getIdleHandles());
+
+  // released handle will be reused.
+  CURL* second = pool.acquire();
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(0, pool.getIdleHandles());
+  pool.release(second);
+}
+
+TEST(CurlHandlePoolTest, testBounded) {
+  CurlHandlePool pool(2);
+  CURL* handles[3];
+  // handles in use are not bounded, only the idle cache is.
+  for (int i = 0; i < 3; i++) {
+    handles[i] = pool.acquire();
+  }
+  for (int i = 0; i < 3; i++) {
+    pool.release(handles[i]);
+  }
+  EXPECT_EQ(2, pool.getIdleHandles());
+
+  pool.setMaxIdleHandles(1);
+  EXPECT_EQ(1, pool.getMaxIdleHandles());
+  EXPECT_EQ(1, pool.getIdleHandles());
+}
+
+TEST(CurlHandlePoolTest, testCurlHandle) {
+  CurlHandlePool pool;
+  CURL* raw = NULL;
+  {
+    CurlHandle curl(&pool);
+    raw = curl;
+    EXPECT_EQ(0, pool.getIdleHandles());
+  }
+  EXPECT_EQ(1, pool.getIdleHandles());
+  {
+    CurlHandle curl(&pool);
+    EXPECT_EQ(raw, static_cast<CURL*>(curl));
+  }
+
+  CurlHandle standalone(NULL);  // not pooled
+  EXPECT_EQ(1, pool.getIdleHandles());
+}
@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "aliyun/utils/deadline.h"
+
+using aliyun::utils::Deadline;
+
+TEST(DeadlineTest, testUnset) {
+  Deadline deadline;
+  EXPECT_FALSE(deadline.isSet());
+  EXPECT_FALSE(deadline.expired());
+  EXPECT_EQ(-1, deadline.remainingMillis());
+}
+
+TEST(DeadlineTest, testAfter) {
+  Deadline deadline = Deadline::after(10000);
+  EXPECT_TRUE(deadline.isSet());
+  EXPECT_FALSE(deadline.expired());
+  EXPECT_GT(deadline.remainingMillis(), 9000);
+  EXPECT_LE(deadline.remainingMillis(), 10000);
+
+  Deadline shortly = Deadline::after(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_TRUE(shortly.expired());
+  EXPECT_EQ(0, shortly.remainingMillis());
+
+  EXPECT_TRUE(Deadline::after(0).expired());
+}
+
+TEST(DeadlineTest, testMin) {
+  Deadline unset;
+  Deadline later = Deadline::after(10000);
+  Deadline sooner = Deadline::after(1000);
+
+  EXPECT_LE(Deadline::min(later, sooner).remainingMillis(), 1000);
+  EXPECT_LE(Deadline::min(sooner, later).remainingMillis(), 1000);
+  EXPECT_GT(Deadline::min(unset, later).remainingMillis(), 1000);
+  EXPECT_FALSE(Deadline::min(unset, unset).isSet());
+}
@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif  // USE_ZLIB
+
+#include <string>
+
+#include "aliyun/utils/gzip_helper.h"
+
+using aliyun::utils::GzipException;
+using aliyun::utils::GzipHelper;
+using aliyun::utils::GzipInflater;
+
+#ifdef USE_ZLIB
+
+static std::string makeContent() {
+  std::string content;
+  for (int i = 0; i < 1000; i++) {
+    content += "<item><id>" + std::to_string(i) + "</id><title>aliyun</title>";
+  }
+  return content;
+}
+
+TEST(GzipHelperTest, testRoundTrip) {
+  EXPECT_TRUE(GzipHelper::isSupported());
+  std::string content = makeContent();
+  std::string compressed = GzipHelper::compress(content);
+  EXPECT_LT(compressed.size(), content.size() / 5);
+  EXPECT_EQ('\x1f', compressed[0]);  // gzip magic
+  EXPECT_EQ('\x8b', compressed[1]);
+  EXPECT_EQ(content, GzipHelper::decompress(compressed));
+
+  EXPECT_EQ("", GzipHelper::decompress(GzipHelper::compress("")));
+}
+
+TEST(GzipHelperTest, testStreaming) {
+  std::string content = makeContent();
+  std::string compressed = GzipHelper::compress(content);
+
+  // feed byte by byte, as small network packets.
+  GzipInflater inflater;
+  std::string out;
+  for (size_t i = 0; i < compressed.size(); i++) {
+    EXPECT_FALSE(inflater.finished());
+    inflater.inflate(&compressed[i], 1, &out);
+  }
+  EXPECT_TRUE(inflater.finished());
+  EXPECT_EQ(content, out);
+}
+
+TEST(GzipHelperTest, testDeflate) {
+  std::string content = makeContent();
+
+  // zlib format, "Content-Encoding: deflate" by RFC.
+  uLongf length = compressBound(content.size());
+  std::string zlib(length, '\0');
+  compress(reinterpret_cast<Bytef*>(&zlib[0]), &length,
+           reinterpret_cast<const Bytef*>(content.data()), content.size());
+  zlib.resize(length);
+  EXPECT_EQ(content, GzipHelper::decompress(zlib));
+
+  // raw deflate, sent by some servers.
+  z_stream stream = z_stream();
+  deflateInit2(&stream, 6, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  std::string raw(deflateBound(&stream, content.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(&content[0]);
+  stream.avail_in = content.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&raw[0]);
+  stream.avail_out = raw.size();
+  deflate(&stream, Z_FINISH);
+  raw.resize(stream.total_out);
+  deflateEnd(&stream);
+  EXPECT_EQ(content, GzipHelper::decompress(raw));
+}
+
+TEST(GzipHelperTest, testCorrupted) {
+  std::string compressed = GzipHelper::compress(makeContent());
+  EXPECT_THROW(GzipHelper::decompress(compressed.substr(0, 100)),
+               GzipException);
+
+  compressed[20] ^= 0x55;
+  EXPECT_THROW(GzipHelper::decompress(compressed), GzipException);
+}
+
+#else  // USE_ZLIB
+
+TEST(GzipHelperTest, testUnsupported) {
+  EXPECT_FALSE(GzipInflater::isSupported());
+  EXPECT_FALSE(GzipHelper::isSupported());
+  EXPECT_THROW(GzipHelper::compress("aliyun"), GzipException);
+}
+
+#endif  // USE_ZLIB
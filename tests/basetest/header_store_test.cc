@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string>
+
+#include "aliyun/http/header_store.h"
+
+using aliyun::http::HeaderStore;
+
+TEST(HeaderStoreTest, caseInsensitive) {
+  HeaderStore store;
+  EXPECT_EQ(HeaderStore::CONTENT_TYPE,
+            store.add("content-type", "text/xml;charset=UTF-8"));
+  EXPECT_EQ(HeaderStore::OTHER_HEADER, store.add("Server", "Tengine"));
+
+  EXPECT_EQ("text/xml;charset=UTF-8", store.get("Content-Type"));
+  EXPECT_EQ("text/xml;charset=UTF-8", store.get(HeaderStore::CONTENT_TYPE));
+  EXPECT_EQ("Tengine", store.get("SERVER"));
+  EXPECT_TRUE(store.has("server"));
+  EXPECT_FALSE(store.has("Serve"));
+  EXPECT_EQ("", store.get("Date"));
+  EXPECT_EQ("", store.get(HeaderStore::CONTENT_LENGTH));
+
+  ASSERT_EQ(2u, store.size());
+  EXPECT_EQ("content-type", store.getName(0));
+  EXPECT_EQ("Server", store.getName(1));
+}
+
+TEST(HeaderStoreTest, replace) {
+  HeaderStore store;
+  store.add("Connection", "keep-alive");
+  EXPECT_EQ(HeaderStore::CONNECTION, store.add("CONNECTION", "close"));
+  EXPECT_EQ(1u, store.size());
+  EXPECT_EQ("close", store.get("connection"));
+  EXPECT_EQ("close", store.get(HeaderStore::CONNECTION));
+}
+
+TEST(HeaderStoreTest, grow) {
+  HeaderStore store;
+  char name[16];
+  for (int i = 0; i < 100; i++) {
+    ::snprintf(name, sizeof(name), "X-Header-%d", i);
+    store.add(name, name + 2);
+  }
+  store.add("Content-Length", "12");
+  EXPECT_EQ(101u, store.size());
+  for (int i = 0; i < 100; i++) {
+    ::snprintf(name, sizeof(name), "x-header-%d", i);
+    EXPECT_EQ(std::string("Header-") + (name + 9), store.get(name));
+  }
+  EXPECT_EQ("12", store.get(HeaderStore::CONTENT_LENGTH));
+
+  // copies keep working, the store keeps offsets.
+  HeaderStore copy = store;
+  store.clear();
+  EXPECT_TRUE(store.empty());
+  EXPECT_EQ("", store.get(HeaderStore::CONTENT_LENGTH));
+  EXPECT_EQ("Header-42", copy.get("X-HEADER-42"));
+}
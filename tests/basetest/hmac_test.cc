@@ -26,6 +26,7 @@
 using std::string;
 using aliyun::auth::ISigner;
 using aliyun::auth::HmacSha1;
+using aliyun::auth::HmacSha1Key;
 using aliyun::auth::HmacSha256;
 using aliyun::utils::StringUtils::hexDump;
 
@@ -57,6 +58,25 @@ TEST(HmacTest, testHmacSha1) {
       "testsecret&"));
 }
 
+TEST(HmacTest, testHmacSha1Key) {
+  HmacSha1Key key("AccessSecret");
+  unsigned char hmac[HmacSha1::DIGEST_LENTH];
+  string msg = "this is a HmacSha1 test.";
+  key.sign(msg.data(), msg.size(), hmac);
+  EXPECT_EQ("47ff824f95bba3569f6bc8a91023b74b26230fad",
+            hexDump(hmac, sizeof hmac, false));
+
+  // the key state is reused, not consumed.
+  EXPECT_EQ("R/+CT5W7o1afa8ipECO3SyYjD60=", key.signString(msg));
+  EXPECT_EQ("R/+CT5W7o1afa8ipECO3SyYjD60=", key.signString(msg));
+
+  string longKey(100, 'k');
+  EXPECT_EQ(HmacSha1::getInstance()->signString(msg, longKey),
+            HmacSha1Key(longKey).signString(msg));
+  EXPECT_EQ(HmacSha1::getInstance()->signString("", ""),
+            HmacSha1Key().signString(""));
+}
+
 TEST(HmacTest, testHmacSha256) {
   HmacSha256* signer = HmacSha256::getInstance();
 
@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <thread>
+
+#include "aliyun/http/curl_handle_pool.h"
+#include "aliyun/http/http_multi_engine.h"
+
+using aliyun::http::CurlException;
+using aliyun::http::CurlHandlePool;
+using aliyun::http::HttpMultiEngine;
+using aliyun::http::HttpRequest;
+using aliyun::http::HttpResponse;
+
+// nothing listens on port 1, connection refused immediately.
+static const char* REFUSED_URL = "http://127.0.0.1:1/";
+
+TEST(HttpMultiEngineTest, testFutureError) {
+  HttpMultiEngine engine;
+  std::future<HttpResponse> future = engine.submit(HttpRequest(REFUSED_URL));
+  EXPECT_THROW(future.get(), CurlException);
+}
+
+TEST(HttpMultiEngineTest, testCallback) {
+  CurlHandlePool pool(4);
+  HttpMultiEngine engine(&pool);
+
+  const int count = 8;
+  std::promise<void> done[count];
+  int errors[count] = { 0 };
+  for (int i = 0; i < count; i++) {
+    engine.submit(HttpRequest(REFUSED_URL),
+                  [&done, &errors, i](HttpResponse& /* response */,
+                                      std::exception_ptr error) {
+      errors[i] = error ? 1 : 0;
+      done[i].set_value();
+    });
+  }
+  for (int i = 0; i < count; i++) {
+    done[i].get_future().wait();
+    EXPECT_EQ(1, errors[i]);
+  }
+
+  // curl handles are given back to the pool once all transfers finished.
+  while (engine.getPendingCount() > 0) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(4, pool.getIdleHandles());
+}
+
+TEST(HttpMultiEngineTest, testDestroy) {
+  std::future<HttpResponse> future;
+  {
+    HttpMultiEngine engine;
+    future = engine.submit(HttpRequest(REFUSED_URL));
+  }
+  // completed or aborted, never left hanging.
+  EXPECT_THROW(future.get(), CurlException);
+}
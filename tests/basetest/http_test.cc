@@ -21,14 +21,17 @@
 
 #include "aliyun/http/http_request.h"
 #include "aliyun/http/http_response.h"
+#include "aliyun/http/loopback_transport.h"
 #include "aliyun/http/x509_trust_all.h"
 
 using aliyun::Exception;
 using aliyun::http::CurlException;
+using aliyun::http::CurlHandle;
 using aliyun::http::MethodType;
 using aliyun::http::FormatType;
 using aliyun::http::HttpRequest;
 using aliyun::http::HttpResponse;
+using aliyun::http::LoopbackTransport;
 using aliyun::http::X509TrustAll;
 
 void printHttpResponse(HttpResponse response) {
@@ -152,7 +155,6 @@ TEST(HttpTest, testCurlException) {
 }
 
 TEST(CurlHandleTest, testCtor) {
-  using aliyun::http::CurlHandle;
   CurlHandle curl;
 }
 
@@ -175,6 +177,47 @@ TEST(HttpRequestTest, testCtor) {
   EXPECT_EQ(2, request3.getHeaders().size());
 }
 
+TEST(HttpRequestTest, testMoveUrl) {
+  std::string url = "http://127.0.0.1/index?query=" + std::string(64, 'q');
+  const char* data = url.data();
+  HttpRequest request(std::move(url));
+  EXPECT_EQ(data, request.getUrl().data());  // taken over, not copied
+
+  std::string other = "http://127.0.0.1/other?query=" + std::string(64, 'o');
+  data = other.data();
+  request.setUrl(std::move(other));
+  EXPECT_EQ(data, request.getUrl().data());
+}
+
+TEST(HttpRequestTest, testPrepareConst) {
+  HttpRequest request("http://127.0.0.1/index?a=1&b=2");
+  request.setMethod(MethodType::POST);
+  const HttpRequest& prepared = request;
+  CurlHandle curl;
+  prepared.prepareCurlHandle(&curl);
+  EXPECT_EQ("http://127.0.0.1/index?a=1&b=2", request.getUrl());
+  EXPECT_EQ(0, request.getHeaders().size());
+}
+
+TEST(HttpRequestTest, testBodyBuffer) {
+  HttpRequest request;
+  EXPECT_TRUE(request.getBodyBuffer() == NULL);
+
+  std::string buffer = "stale";
+  request.setBodyBuffer(&buffer);
+  HttpRequest copy = request;
+  EXPECT_EQ(&buffer, copy.getBodyBuffer());
+
+  // the body replaces the buffer and is not kept in the response.
+  LoopbackTransport transport;
+  transport.setDefaultResponse("bad request", 400);
+  copy.setUrl("http://127.0.0.1/");
+  HttpResponse response = transport.send(copy);
+  EXPECT_EQ(400, response.getStatus());
+  EXPECT_EQ("bad request", buffer);
+  EXPECT_EQ(0, response.getContent().length());
+}
+
 TEST(HttpRequestTest, testHeaderParameter) {
   HttpRequest request;
   request.putHeaderParameter("key1", "value1");
@@ -192,3 +235,18 @@ TEST(HttpRequestTest, testSetContent) {
   request.setContent(test_content, "", FormatType::XML);
   EXPECT_EQ(test_content, request.getContent());
 }
+
+TEST(HttpResponseTest, testHeaders) {
+  HttpResponse response;
+  response.headerStore().add("Content-Length", "10");
+  response.headerStore().add("Server", "a");
+  EXPECT_EQ("a", response.getHeaders().find("Server")->second);
+
+  // same count, different headers.
+  response.headerStore().clear();
+  response.headerStore().add("Content-Length", "20");
+  response.headerStore().add("Server", "b");
+  EXPECT_EQ(2, response.getHeaders().size());
+  EXPECT_EQ("b", response.getHeaders().find("Server")->second);
+  EXPECT_EQ("20", response.getHeaders().find("Content-Length")->second);
+}
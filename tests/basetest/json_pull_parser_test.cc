@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
+#include "aliyun/reader/json_pull_parser.h"
+#include "aliyun/reader/json_reader.h"
+
+using aliyun::reader::JsonException;
+using aliyun::reader::JsonPullParser;
+
+// events as a string like EventRecorder in json_reader_test, pieces fed
+// `step` bytes a time.
+static std::string pullAll(const std::string& json, size_t step) {
+  JsonPullParser parser;
+  std::string events;
+  size_t pos = 0;
+  for (;;) {
+    JsonPullParser::Event event = parser.next();
+    switch (event) {
+      case JsonPullParser::END_DOCUMENT:
+        return events;
+      case JsonPullParser::NEED_MORE:
+        if (pos == json.size()) {
+          parser.finish();
+        } else {
+          size_t size = std::min(step, json.size() - pos);
+          parser.feed(json.data() + pos, size);
+          pos += size;
+        }
+        break;
+      case JsonPullParser::OBJECT_BEGIN:
+        events += "{";
+        break;
+      case JsonPullParser::OBJECT_END:
+        events += "}";
+        break;
+      case JsonPullParser::ARRAY_BEGIN:
+        events += "[";
+        break;
+      case JsonPullParser::ARRAY_END:
+        events += "]";
+        break;
+      case JsonPullParser::KEY:
+        events += parser.getText().toString() + ":";
+        break;
+      case JsonPullParser::VALUE:
+        events += parser.getText().toString() + "/"
+            + "snbz"[parser.getValueType()] + ",";
+        break;
+    }
+  }
+}
+
+TEST(JsonPullParserTest, events) {
+  std::string json = " {\"a\":\"x\\ty\",\"b\":[1,true,null,[]],"
+      "\"c\":{\"d\":[{\"e\":\"}]\\u4e2d\"}]},\"f\":-2.5e3,\"g\":{}} ";
+  std::string expected = "{a:x\ty/s,b:[1/n,true/b,null/z,[]]"
+      "c:{d:[{e:}]\xE4\xB8\xAD/s,}]}f:-2.5e3/n,g:{}}";
+  EXPECT_EQ(expected, pullAll(json, json.size()));
+
+  // pieces of any size give the same events.
+  for (size_t step = 1; step < json.size(); step++) {
+    EXPECT_EQ(expected, pullAll(json, step)) << "step " << step;
+  }
+
+  EXPECT_EQ("42/n,", pullAll("42", 1));
+  EXPECT_EQ("s/s,", pullAll("\"s\"", 1));
+
+  // like JsonReader, nothing is read after the first value.
+  EXPECT_EQ("", pullAll("", 1));
+  EXPECT_EQ("[1/n,]", pullAll("[1]]", 1));
+}
+
+TEST(JsonPullParserTest, raw) {
+  JsonPullParser parser;
+  std::string json = "{\"k\\n\":\"v\\\"\"}";
+  parser.feed(json.data(), json.size());
+  parser.finish();
+  EXPECT_EQ(JsonPullParser::OBJECT_BEGIN, parser.next());
+  EXPECT_EQ(JsonPullParser::KEY, parser.next());
+  EXPECT_EQ("k\n", parser.getText());
+  EXPECT_EQ("\"k\\n\"", parser.getRaw());
+  EXPECT_EQ(JsonPullParser::VALUE, parser.next());
+  EXPECT_EQ("v\"", parser.getText());
+  EXPECT_EQ("\"v\\\"\"", parser.getRaw());
+  EXPECT_EQ(json.size() - 1, parser.getOffset());
+  EXPECT_EQ(1u, parser.getDepth());
+  EXPECT_EQ(JsonPullParser::OBJECT_END, parser.next());
+  EXPECT_EQ(0u, parser.getDepth());
+  EXPECT_EQ(JsonPullParser::END_DOCUMENT, parser.next());
+}
+
+TEST(JsonPullParserTest, errors) {
+  EXPECT_THROW(pullAll("{", 1), JsonException);
+  EXPECT_THROW(pullAll("{\"name\": \"value}", 1), JsonException);
+  EXPECT_THROW(pullAll("{\"a\":[1,2", 1), JsonException);
+  EXPECT_THROW(pullAll("{\"name\"::\"value\"}", 1), JsonException);
+  EXPECT_THROW(pullAll("{\"a\":tru}", 1), JsonException);
+  EXPECT_THROW(pullAll("[\"a\\", 1), JsonException);
+  EXPECT_THROW(pullAll("{\"a\":1]", 2), JsonException);
+}
+
+TEST(JsonPullParserTest, reset) {
+  JsonPullParser parser;
+  parser.feed("[1,", 3);
+  EXPECT_EQ(JsonPullParser::ARRAY_BEGIN, parser.next());
+  EXPECT_EQ(JsonPullParser::VALUE, parser.next());
+  EXPECT_EQ(JsonPullParser::NEED_MORE, parser.next());
+
+  parser.reset();
+  parser.feed("{}", 2);
+  parser.finish();
+  EXPECT_EQ(JsonPullParser::OBJECT_BEGIN, parser.next());
+  EXPECT_EQ(JsonPullParser::OBJECT_END, parser.next());
+  EXPECT_EQ(2u, parser.getOffset());
+  EXPECT_EQ(JsonPullParser::END_DOCUMENT, parser.next());
+}
@@ -20,6 +20,9 @@
 #include <stdlib.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "aliyun/reader/json_reader.h"
 
 using aliyun::Exception;
@@ -153,3 +156,244 @@ TEST_F(JsonReaderTest, testBroken) {
   safeParse("{,,}", "more-comma");
   safeParse("{\"name\"::\"value\"}", "more-colon");
 }
+
+TEST_F(JsonReaderTest, testLiterals) {
+  aliyun::reader::JsonReader reader;
+  std::map<std::string, std::string> result = reader.read(
+      "{\"a\":true,\"b\":false,\"c\":null,\"d\":[true,1,null],"
+      "\"e\":{\"f\":[\"x\",2,false]}}", "p");
+
+  EXPECT_EQ("true", result["p.a"]);
+  EXPECT_EQ("false", result["p.b"]);
+  EXPECT_EQ(result.end(), result.find("p.c"));
+  EXPECT_EQ("3", result["p.Length"]);  // only strings put for array
+  EXPECT_EQ(result.end(), result.find("p[0]"));
+  EXPECT_EQ("x", result["p.e[0]"]);  // all scalars put for list
+  EXPECT_EQ("2", result["p.e[1]"]);
+  EXPECT_EQ("false", result["p.e[2]"]);
+  EXPECT_EQ("3", result["p.e.Length"]);
+}
+
+TEST_F(JsonReaderTest, testUnicode) {
+  aliyun::reader::JsonReader reader;
+  std::map<std::string, std::string> result = reader.read(
+      "{\"cn\":\"\\u4e00\\u6dd8\",\"emoji\":\"\\ud83d\\ude00\","
+      "\"raw\":\"\xe4\xb8\x80\"}", "p");
+
+  EXPECT_EQ("\xe4\xb8\x80\xe6\xb7\x98", result["p.cn"]);
+  EXPECT_EQ("\xf0\x9f\x98\x80", result["p.emoji"]);
+  EXPECT_EQ("\xe4\xb8\x80", result["p.raw"]);
+}
+
+TEST_F(JsonReaderTest, testFlatAndHashMap) {
+  aliyun::reader::JsonReader reader;
+  aliyun::reader::FlatMap flat;
+  aliyun::reader::JsonReader::HashMap hash;
+  reader.read(json_, "DescribeInstancesResponse", &flat);
+  reader.read(json_, "DescribeInstancesResponse", &hash);
+
+  ASSERT_EQ(map_.size(), flat.size());
+  ASSERT_EQ(map_.size(), hash.size());
+  std::map<std::string, std::string>::iterator expected = map_.begin();
+  for (aliyun::reader::FlatMap::const_iterator it = flat.begin();
+       it != flat.end(); ++it, ++expected) {
+    EXPECT_EQ(expected->first, it->first);
+    EXPECT_EQ(expected->second, it->second);
+    EXPECT_EQ(expected->second, hash[expected->first]);
+  }
+
+  EXPECT_EQ("2", flat.get("DescribeInstancesResponse.Instances.Length", ""));
+  EXPECT_FALSE(flat.contains("DescribeInstancesResponse.Instances"));
+}
+
+TEST_F(JsonReaderTest, testBorrowedBuffer) {
+  // not NUL terminated, parsing stops at size.
+  const char data[] = { '{', '"', 'a', '"', ':', '1', '}', 'x' };
+  aliyun::reader::JsonReader reader;
+  aliyun::reader::FlatMap result;
+  reader.read(data, 7, "p", &result);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("1", result.get("p.a", ""));
+
+  EXPECT_THROW(reader.read(data, 6, "p", &result), JsonException);
+}
+
+TEST_F(JsonReaderTest, testErrors) {
+  aliyun::reader::JsonReader reader;
+  EXPECT_THROW(reader.read("{", "p"), JsonException);
+  EXPECT_THROW(reader.read("{\"name\": \"value}", "p"), JsonException);
+  EXPECT_THROW(reader.read("{\"a\":[1,2", "p"), JsonException);
+  EXPECT_THROW(reader.read("{\"name\"::\"value\"}", "p"), JsonException);
+  EXPECT_THROW(reader.read("{\"a\":tru}", "p"), JsonException);
+  EXPECT_NO_THROW(reader.read("", "p"));
+}
+
+// records events as a string, stops at key `stopKey`.
+class EventRecorder : public aliyun::reader::ReaderHandler {
+ public:
+  std::string events;
+  std::string skipKey;
+  std::string stopKey;
+
+  Action onObjectBegin() {
+    events += "{";
+    return CONTINUE;
+  }
+
+  Action onObjectEnd() {
+    events += "}";
+    return CONTINUE;
+  }
+
+  Action onArrayBegin() {
+    events += "[";
+    return CONTINUE;
+  }
+
+  Action onArrayEnd() {
+    events += "]";
+    return CONTINUE;
+  }
+
+  Action onKey(const StringPiece& key) {
+    events += key.toString() + ":";
+    if (key == stopKey) {
+      return STOP;
+    }
+    return key == skipKey ? SKIP : CONTINUE;
+  }
+
+  Action onValue(const StringPiece& value, ValueType type) {
+    const char* types = "snbz";
+    events += value.toString() + "/" + types[type] + ",";
+    return CONTINUE;
+  }
+};
+
+TEST_F(JsonReaderTest, testHandlerEvents) {
+  aliyun::reader::JsonReader reader;
+  std::string json = "{\"a\":\"x\\ty\",\"b\":[1,true,null],"
+      "\"c\":{\"d\":[{\"e\":\"}]\"}]},\"f\":-2.5}";
+
+  EventRecorder all;
+  EXPECT_TRUE(reader.read(json, &all));
+  EXPECT_EQ("{a:x\ty/s,b:[1/n,true/b,null/z,]c:{d:[{e:}]/s,}]}f:-2.5/n,}",
+            all.events);
+
+  EventRecorder skip;
+  skip.skipKey = "c";
+  EXPECT_TRUE(reader.read(json, &skip));
+  EXPECT_EQ("{a:x\ty/s,b:[1/n,true/b,null/z,]c:f:-2.5/n,}", skip.events);
+
+  EventRecorder stop;
+  stop.stopKey = "b";
+  EXPECT_FALSE(reader.read(json, &stop));
+  EXPECT_EQ("{a:x\ty/s,b:", stop.events);
+
+  EventRecorder broken;
+  EXPECT_THROW(reader.read("{\"a\":[1,", &broken), JsonException);
+}
+
+// pulls id and score of each item, nothing else is looked at.
+class ItemCollector : public aliyun::reader::ReaderHandler {
+ public:
+  std::vector<std::string> ids;
+  std::vector<std::string> scores;
+  size_t maxItems;
+
+  ItemCollector()
+      : maxItems(100),
+        depth_(0),
+        wanted_(NULL) {
+  }
+
+  Action onObjectBegin() {
+    depth_++;
+    return CONTINUE;
+  }
+
+  Action onObjectEnd() {
+    depth_--;
+    return depth_ == 2 && ids.size() >= maxItems ? STOP : CONTINUE;
+  }
+
+  Action onKey(const StringPiece& key) {
+    wanted_ = NULL;
+    if (depth_ == 1) {  // top level, only result
+      return key == "result" ? CONTINUE : SKIP;
+    }
+    if (depth_ == 2) {
+      return key == "items" ? CONTINUE : SKIP;
+    }
+    if (key == "id") {
+      wanted_ = &ids;
+    } else if (key == "score") {
+      wanted_ = &scores;
+    } else {
+      return SKIP;
+    }
+    return CONTINUE;
+  }
+
+  Action onValue(const StringPiece& value, ValueType /* type */) {
+    if (wanted_ != NULL) {
+      wanted_->push_back(value.toString());
+    }
+    return CONTINUE;
+  }
+
+ private:
+  int depth_;
+  std::vector<std::string>* wanted_;
+};
+
+TEST_F(JsonReaderTest, testHandlerItems) {
+  std::string json = "{\"status\":\"OK\",\"result\":{\"total\":3,\"items\":["
+      "{\"id\":\"1\",\"title\":\"a\",\"score\":1.5,\"tags\":[\"x\"]},"
+      "{\"id\":\"2\",\"title\":\"b\",\"score\":0.5,\"tags\":[]},"
+      "{\"id\":\"3\",\"title\":\"c\",\"score\":0.1}]},\"errors\":[]}";
+  aliyun::reader::JsonReader reader;
+
+  ItemCollector collector;
+  EXPECT_TRUE(reader.read(json, &collector));
+  ASSERT_EQ(3, collector.ids.size());
+  EXPECT_EQ("3", collector.ids[2]);
+  EXPECT_EQ("0.5", collector.scores[1]);
+
+  ItemCollector firstTwo;
+  firstTwo.maxItems = 2;
+  EXPECT_FALSE(reader.read(json, &firstTwo));
+  EXPECT_EQ(2, firstTwo.ids.size());
+  EXPECT_EQ(2, firstTwo.scores.size());
+}
+
+TEST_F(JsonReaderTest, testFeed) {
+  std::string json = "{\"a\":\"x\\ty\",\"b\":[1,true,null],"
+      "\"c\":{\"d\":[{\"e\":\"}]\"}]},\"f\":-2.5}";
+  aliyun::reader::JsonReader reader;
+
+  for (size_t step = 1; step <= json.size(); step++) {
+    EventRecorder pieces;
+    pieces.skipKey = "c";
+    reader.begin(&pieces);
+    for (size_t pos = 0; pos < json.size(); pos += step) {
+      EXPECT_TRUE(reader.feed(json.data() + pos,
+                              std::min(step, json.size() - pos)));
+    }
+    EXPECT_TRUE(reader.finish());
+    EXPECT_EQ("{a:x\ty/s,b:[1/n,true/b,null/z,]c:f:-2.5/n,}", pieces.events)
+        << "step " << step;
+  }
+
+  EventRecorder stop;
+  stop.stopKey = "b";
+  reader.begin(&stop);
+  EXPECT_FALSE(reader.feed(json.data(), json.size()));
+  EXPECT_FALSE(reader.finish());
+  EXPECT_EQ("{a:x\ty/s,b:", stop.events);
+
+  EventRecorder broken;
+  reader.begin(&broken);
+  reader.feed("{\"a\":[1,", 8);
+  EXPECT_THROW(reader.finish(), JsonException);
+}
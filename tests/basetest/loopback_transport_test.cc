@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "aliyun/http/body_sink.h"
+#include "aliyun/http/loopback_transport.h"
+
+using aliyun::http::BodySink;
+using aliyun::http::FormatType;
+using aliyun::http::HeaderStore;
+using aliyun::http::HttpRequest;
+using aliyun::http::HttpResponse;
+using aliyun::http::LoopbackTransport;
+
+class PieceCollector : public BodySink {
+ public:
+  std::string pieces;
+
+  void onBegin() {
+    pieces += "<";
+  }
+
+  void onData(const char* data, size_t size) {
+    pieces += "|" + std::string(data, size);
+  }
+
+  void onEnd() {
+    pieces += ">";
+  }
+};
+
+TEST(LoopbackTransportTest, testGetPath) {
+  EXPECT_EQ("/v2/api/search",
+            LoopbackTransport::getPath("http://h:80/v2/api/search?a=/b#c"));
+  EXPECT_EQ("/", LoopbackTransport::getPath("http://host"));
+  EXPECT_EQ("/x", LoopbackTransport::getPath("/x?y"));
+}
+
+TEST(LoopbackTransportTest, testSend) {
+  LoopbackTransport transport;
+  transport.addResponse("/search", "{\"status\":\"OK\"}");
+  transport.addResponse("/api/search", "<r/>", 200, "text/xml");
+
+  HttpResponse response =
+      transport.send(HttpRequest("http://host/v2/api/search?q=1"));
+  EXPECT_EQ(200, response.getStatus());
+  EXPECT_EQ("<r/>", response.getContent());
+  EXPECT_EQ(FormatType::XML, response.getContentType());
+  EXPECT_EQ("4", response.getHeaderStore().get(HeaderStore::CONTENT_LENGTH));
+
+  response = transport.send(HttpRequest("http://host/search"));
+  EXPECT_EQ("{\"status\":\"OK\"}", response.getContent());
+  EXPECT_EQ(FormatType::JSON, response.getContentType());
+
+  response = transport.send(HttpRequest("http://host/xsearch"));
+  EXPECT_EQ(404, response.getStatus());
+  transport.setDefaultResponse("none", 500);
+  response = transport.send(HttpRequest("http://host/"));
+  EXPECT_EQ(500, response.getStatus());
+  EXPECT_EQ("none", response.getContent());
+  EXPECT_EQ(4u, transport.getRequestCount());
+}
+
+TEST(LoopbackTransportTest, testBodySinkAndBuffer) {
+  LoopbackTransport transport;
+  transport.addResponse("/a", "abcdefg");
+  transport.setChunkSize(3);
+
+  HttpRequest request("http://host/a");
+  PieceCollector collector;
+  request.setBodySink(&collector);
+  HttpResponse response = transport.send(request);
+  EXPECT_EQ("<|abc|def|g>", collector.pieces);
+  EXPECT_EQ("", response.getContent());
+
+  std::string buffer = "stale";
+  request.setBodySink(NULL);
+  request.setBodyBuffer(&buffer);
+  response = transport.send(request);
+  EXPECT_EQ("abcdefg", buffer);
+  EXPECT_EQ("", response.getContent());
+}
+
+TEST(LoopbackTransportTest, testSubmit) {
+  LoopbackTransport transport;
+  transport.addResponse("/a", "x");
+
+  std::string content;
+  transport.submit(HttpRequest("http://host/a"),
+                   [&content](HttpResponse& response,
+                              std::exception_ptr error) {
+    content = error ? "error" : response.getContent();
+  });
+  EXPECT_EQ("x", content);
+}
@@ -0,0 +1,209 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "aliyun/utils/rate_limiter.h"
+
+using aliyun::utils::RateLimiter;
+
+typedef RateLimiter::Clock Clock;
+
+// time only moves when a caller sleeps or the test advances it.
+class ManualTime : public RateLimiter::TimeSource {
+ public:
+  ManualTime()
+      : start_(Clock::time_point() + std::chrono::hours(1)),
+        now_(start_) {
+  }
+
+  Clock::time_point now() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return now_;
+  }
+
+  void sleepUntil(Clock::time_point at) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (at > now_) {
+      now_ = at;
+    }
+  }
+
+  void advance(long millis) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    now_ += std::chrono::milliseconds(millis);
+  }
+
+  long elapsedMillis() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return static_cast<long>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            now_ - start_).count());
+  }
+
+ private:
+  std::mutex mutex_;
+  Clock::time_point start_;
+  Clock::time_point now_;
+};
+
+TEST(RateLimiterTest, testUnlimited) {
+  ManualTime time;
+  RateLimiter limiter(0);
+  limiter.setTimeSource(&time);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(0, limiter.acquire(1024));
+  }
+  EXPECT_EQ(0, time.elapsedMillis());
+  EXPECT_EQ(0, limiter.getWaitMillis());
+  EXPECT_EQ(0, limiter.getTotalWaitMillis());
+}
+
+TEST(RateLimiterTest, testRequestsPerSecond) {
+  ManualTime time;
+  RateLimiter limiter(20, 0, 0);  // one per 50ms, no burst
+  limiter.setTimeSource(&time);
+  EXPECT_TRUE(limiter.tryAcquire());
+  EXPECT_FALSE(limiter.tryAcquire());
+  EXPECT_EQ(50, limiter.getWaitMillis());
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(50, limiter.acquire());
+  }
+  EXPECT_EQ(200, time.elapsedMillis());
+  EXPECT_EQ(200, limiter.getTotalWaitMillis());
+}
+
+TEST(RateLimiterTest, testBurst) {
+  ManualTime time;
+  RateLimiter limiter(10);  // one per 100ms, one second saved
+  limiter.setTimeSource(&time);
+  EXPECT_DOUBLE_EQ(RateLimiter::DEFAULT_BURST_SECONDS,
+                   limiter.getBurstSeconds());
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(limiter.tryAcquire());
+  }
+  EXPECT_FALSE(limiter.tryAcquire());
+  EXPECT_EQ(100, limiter.getWaitMillis());
+
+  // a long pause saves one second only.
+  time.advance(5000);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(0, limiter.acquire());
+  }
+  EXPECT_EQ(100, limiter.acquire());
+}
+
+TEST(RateLimiterTest, testLateCallerKeepsRate) {
+  ManualTime time;
+  RateLimiter limiter(10);
+  limiter.setTimeSource(&time);
+  for (int i = 0; i < 10; i++) {
+    limiter.acquire();
+  }
+
+  // 30 more at the rate, the last one 3 seconds after the start. a caller
+  // 150ms late is made up for by the saved credit instead of lost.
+  for (int i = 0; i < 30; i++) {
+    if (i == 10) {
+      time.advance(250);
+    }
+    limiter.acquire();
+  }
+  EXPECT_EQ(3000, time.elapsedMillis());
+
+  // without burst, the hiccup is lost.
+  ManualTime pacedTime;
+  RateLimiter paced(10, 0, 0);
+  paced.setTimeSource(&pacedTime);
+  for (int i = 0; i < 30; i++) {
+    if (i == 10) {
+      pacedTime.advance(250);
+    }
+    paced.acquire();
+  }
+  EXPECT_EQ(3050, pacedTime.elapsedMillis());
+}
+
+TEST(RateLimiterTest, testBytesPerSecond) {
+  ManualTime time;
+  RateLimiter limiter(0, 10000, 0);
+  limiter.setTimeSource(&time);
+  EXPECT_EQ(0, limiter.acquire(1000));  // the next one pays for it
+  EXPECT_EQ(100, limiter.acquire(3000));
+  EXPECT_EQ(300, limiter.acquire(0));
+  EXPECT_EQ(400, time.elapsedMillis());
+
+  // larger than the bucket, allowed once full and paid back after.
+  limiter.setBurstSeconds(1);
+  time.advance(2000);
+  EXPECT_EQ(0, limiter.acquire(10000));
+  EXPECT_EQ(1000, limiter.acquire(50000));
+  EXPECT_EQ(4000, limiter.acquire(0));
+}
+
+TEST(RateLimiterTest, testSharedByThreads) {
+  ManualTime time;
+  RateLimiter limiter(100, 0, 0);  // one per 10ms
+  limiter.setTimeSource(&time);
+  std::atomic<int> count(0);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.push_back(std::thread([&limiter, &count]() {
+      for (int j = 0; j < 10; j++) {
+        limiter.acquire();
+        count++;
+      }
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  // 40 requests in consecutive slots, the first one goes at once.
+  EXPECT_EQ(40, count.load());
+  EXPECT_EQ(390, time.elapsedMillis());
+}
+
+TEST(RateLimiterTest, testSetRate) {
+  ManualTime time;
+  RateLimiter limiter(1, 0, 0);
+  limiter.setTimeSource(&time);
+  limiter.acquire();
+  EXPECT_EQ(1000, limiter.getWaitMillis());
+
+  limiter.setRate(0, 0);
+  EXPECT_DOUBLE_EQ(0, limiter.getRequestsPerSecond());
+  EXPECT_EQ(0, limiter.getWaitMillis());
+  EXPECT_EQ(0, limiter.acquire());
+}
+
+TEST(RateLimiterTest, testSystemTime) {
+  RateLimiter limiter(0.01, 0, 0);  // one per 100 seconds
+  EXPECT_TRUE(limiter.tryAcquire());
+  EXPECT_FALSE(limiter.tryAcquire());
+  EXPECT_GT(limiter.getWaitMillis(), 0);
+}
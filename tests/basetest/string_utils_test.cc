@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+#include "aliyun/utils/string_utils.h"
+
+using std::string;
+namespace StringUtils = aliyun::utils::StringUtils;
+
+TEST(StringUtilsTest, testCase) {
+  EXPECT_EQ("abc-1", StringUtils::ToLowerCase("AbC-1"));
+  EXPECT_EQ("ABC-1", StringUtils::ToUpperCase("aBc-1"));
+
+  string str = "MIXED Case";
+  EXPECT_EQ("mixed case", StringUtils::ToLowerCase(str));
+  EXPECT_EQ("MIXED Case", str);  // lvalue is copied, not changed
+}
+
+TEST(StringUtilsTest, testTrim) {
+  EXPECT_EQ("a b", StringUtils::trim(" \t a b\n "));
+  EXPECT_EQ("a b", StringUtils::trim("a b"));
+  EXPECT_EQ("", StringUtils::trim(""));
+  EXPECT_EQ("", StringUtils::trim(" \t\n"));
+
+  string str = "  value  ";
+  EXPECT_EQ("value", StringUtils::trim(std::move(str)));
+}
+
+TEST(StringUtilsTest, testHexString) {
+  EXPECT_EQ("0AFF", StringUtils::hexString(string("\x0a\xff", 2)));
+  EXPECT_EQ("0aff", StringUtils::hexString(string("\x0a\xff", 2), false));
+}
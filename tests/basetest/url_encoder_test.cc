@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <curl/curl.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aliyun/auth/url_encoder.h"
+
+using aliyun::auth::UrlEncoder;
+
+static std::string curlEscape(const std::string& in) {
+  char* escaped = curl_easy_escape(NULL, in.data(), in.size());
+  std::string out(escaped);
+  curl_free(escaped);
+  return out;
+}
+
+TEST(UrlEncoderTest, testEncode) {
+  std::string all;
+  for (int c = 0; c < 256; c++) {
+    all.push_back(static_cast<char>(c));
+  }
+  EXPECT_EQ(curlEscape(all), UrlEncoder::encode(all));
+  EXPECT_EQ(curlEscape(all).size(), UrlEncoder::encodedLength(all));
+
+  EXPECT_EQ("", UrlEncoder::encode(""));
+  EXPECT_EQ("a-b.c_d~e", UrlEncoder::encode("a-b.c_d~e"));
+  EXPECT_EQ("%7B%22k%22%3A%22%E4%B8%AD%22%7D",
+            UrlEncoder::encode("{\"k\":\"\xE4\xB8\xAD\"}"));
+  EXPECT_EQ("%7B%22k%22%3A%22%E4%B8%AD%22%7D",
+            UrlEncoder::getInstance()->encodeString(
+                "{\"k\":\"\xE4\xB8\xAD\"}"));
+}
+
+TEST(UrlEncoderTest, testPercentEncode) {
+  EXPECT_EQ("a%20b%2Ac~d%2Be%20f%2A",
+            UrlEncoder::percentEncode("a b*c~d+e f*"));
+}
+
+TEST(UrlEncoderTest, testAppend) {
+  std::string out = "items=";
+  UrlEncoder::appendEncoded("a b", &out);
+  out += '&';
+  UrlEncoder::appendPercentEncoded("[1]", &out);
+  EXPECT_EQ("items=a%20b&%5B1%5D", out);
+}
+
+TEST(UrlEncoderTest, testThreads) {
+  std::string doc;
+  for (int i = 0; i < 10000; i++) {
+    doc += "{\"id\":\"" + std::to_string(i) + "\",\"title\":\"a b\"},";
+  }
+  std::string expected = curlEscape(doc);
+
+  std::vector<std::thread> threads;
+  std::vector<int> mismatches(8, 0);
+  for (size_t t = 0; t < mismatches.size(); t++) {
+    threads.push_back(std::thread([&doc, &expected, &mismatches, t]() {
+      for (int i = 0; i < 20; i++) {
+        mismatches[t] += UrlEncoder::encode(doc) != expected;
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); t++) {
+    threads[t].join();
+    EXPECT_EQ(0, mismatches[t]);
+  }
+}
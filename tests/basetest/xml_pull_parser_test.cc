@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
+#include "aliyun/reader/xml_pull_parser.h"
+#include "aliyun/reader/xml_reader.h"
+
+using aliyun::reader::XmlException;
+using aliyun::reader::XmlPullParser;
+
+// events as "<name", ">name" and "|text", pieces fed `step` bytes a time.
+static std::string pullAll(const std::string& xml, size_t step) {
+  XmlPullParser parser;
+  std::string events;
+  size_t pos = 0;
+  for (;;) {
+    XmlPullParser::Event event = parser.next();
+    if (event == XmlPullParser::END_DOCUMENT) {
+      return events;
+    }
+    if (event == XmlPullParser::NEED_MORE) {
+      if (pos == xml.size()) {
+        parser.finish();
+      } else {
+        size_t size = std::min(step, xml.size() - pos);
+        parser.feed(xml.data() + pos, size);
+        pos += size;
+      }
+    } else if (event == XmlPullParser::START_ELEMENT) {
+      events += "<" + parser.getName().toString();
+    } else if (event == XmlPullParser::END_ELEMENT) {
+      events += ">" + parser.getName().toString();
+    } else {
+      events += "|" + parser.getText().toString();
+    }
+  }
+}
+
+TEST(XmlPullParserTest, events) {
+  std::string xml = "<?xml version=\"1.0\"?>\n<!DOCTYPE r [<!ENTITY x \"y\">]>"
+      "<r a=\"1>\"><!-- <no/> --><b>x</b><c/><d k='v'/></r>\n";
+  EXPECT_EQ("<r<b|x>b<c>c<d>d>r", pullAll(xml, xml.size()));
+}
+
+TEST(XmlPullParserTest, text) {
+  std::string xml = "<r>a&lt;&gt;&amp;&quot;&apos;&#65;&#x4e2d;\r\nb"
+      "<![CDATA[<&>]]></r>";
+  std::string expected = "a<>&\"'A\xE4\xB8\xAD\nb<&>";
+
+  // CDATA comes as a text event of its own.
+  std::string events = pullAll(xml, xml.size());
+  EXPECT_EQ("<r|a<>&\"'A\xE4\xB8\xAD\nb|<&>>r", events);
+
+  // pieces of any size give the same text, maybe in more events.
+  for (size_t step = 1; step < 8; step++) {
+    std::string text;
+    std::string pieces = pullAll(xml, step);
+    for (size_t i = 0; i < pieces.size(); i++) {
+      if (pieces[i] != '|') {
+        text += pieces[i];
+      }
+    }
+    EXPECT_EQ("<r" + expected + ">r", text) << "step " << step;
+  }
+}
+
+TEST(XmlPullParserTest, errors) {
+  EXPECT_THROW(pullAll("", 1), XmlException);
+  EXPECT_THROW(pullAll("<a>", 1), XmlException);
+  EXPECT_THROW(pullAll("<a></b>", 1), XmlException);
+  EXPECT_THROW(pullAll("<<a/>", 1), XmlException);
+  EXPECT_THROW(pullAll("<a/><b/>", 1), XmlException);
+  EXPECT_THROW(pullAll("x<a/>", 1), XmlException);
+  EXPECT_THROW(pullAll("<a>&bad;</a>", 1), XmlException);
+  EXPECT_THROW(pullAll("<a><!-- x</a>", 3), XmlException);
+}
+
+TEST(XmlPullParserTest, reset) {
+  XmlPullParser parser;
+  parser.feed("<a>", 3);
+  EXPECT_EQ(XmlPullParser::START_ELEMENT, parser.next());
+  EXPECT_EQ(1u, parser.getDepth());
+  EXPECT_EQ(XmlPullParser::NEED_MORE, parser.next());
+
+  parser.reset();
+  parser.feed("<b/>", 4);
+  parser.finish();
+  EXPECT_EQ(XmlPullParser::START_ELEMENT, parser.next());
+  EXPECT_EQ("b", parser.getName());
+  EXPECT_EQ(XmlPullParser::END_ELEMENT, parser.next());
+  EXPECT_EQ(0u, parser.getDepth());
+  EXPECT_EQ(XmlPullParser::END_DOCUMENT, parser.next());
+}
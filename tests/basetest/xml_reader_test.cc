@@ -19,6 +19,11 @@
 
 #include <stdlib.h>
 #include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "aliyun/reader/reader_factory.h"
 #include "aliyun/reader/xml_reader.h"
 
 using aliyun::Exception;
@@ -172,3 +177,136 @@ TEST_F(XmlReaderTest, sideCases) {
 TEST_F(XmlReaderTest, testXmlException) {
   safeParse("<<<<xml", "prefix");
 }
+
+class XmlEventRecorder : public aliyun::reader::ReaderHandler {
+ public:
+  std::string events;
+  std::string skipKey;
+  std::string stopKey;
+
+  Action onObjectBegin() {
+    events += "{";
+    return CONTINUE;
+  }
+
+  Action onObjectEnd() {
+    events += "}";
+    return CONTINUE;
+  }
+
+  Action onKey(const StringPiece& key) {
+    events += key.toString() + ":";
+    if (key == stopKey) {
+      return STOP;
+    }
+    return key == skipKey ? SKIP : CONTINUE;
+  }
+
+  Action onValue(const StringPiece& value, ValueType /* type */) {
+    events += value.toString() + ",";
+    return CONTINUE;
+  }
+};
+
+TEST_F(XmlReaderTest, testHandlerEvents) {
+  std::string xml = "<root><a>x&amp;y</a><b><c>1</c><c>2</c></b>"
+      "<d></d><e>3</e></root>";
+
+  XmlEventRecorder all;
+  XmlReader reader;
+  EXPECT_TRUE(reader.read(xml, &all));
+  EXPECT_EQ("{a:x&y,b:{c:1,c:2,}d:,e:3,}", all.events);
+
+  XmlEventRecorder skip;
+  skip.skipKey = "b";
+  XmlReader skipReader;
+  EXPECT_TRUE(skipReader.read(xml, &skip));
+  EXPECT_EQ("{a:x&y,b:d:,e:3,}", skip.events);
+
+  XmlEventRecorder stop;
+  stop.stopKey = "c";
+  XmlReader stopReader;
+  EXPECT_FALSE(stopReader.read(xml, &stop));
+  EXPECT_EQ("{a:x&y,b:{c:", stop.events);
+}
+
+TEST_F(XmlReaderTest, testFeed) {
+  std::string xml = "<root><a>x&amp;y</a><b><c>1</c><c>2</c></b>"
+      "<d></d><e>3</e></root>";
+
+  // fed a few bytes a time, the same events as from one piece.
+  XmlEventRecorder recorder;
+  XmlReader reader;
+  reader.begin(&recorder);
+  for (size_t i = 0; i < xml.size(); i += 3) {
+    size_t size = std::min<size_t>(3, xml.size() - i);
+    EXPECT_TRUE(reader.feed(xml.data() + i, size));
+  }
+  EXPECT_TRUE(reader.finish());
+  EXPECT_EQ("{a:x&y,b:{c:1,c:2,}d:,e:3,}", recorder.events);
+
+  // reusable for another response, stops early on STOP.
+  XmlEventRecorder stop;
+  stop.stopKey = "b";
+  reader.begin(&stop);
+  EXPECT_FALSE(reader.feed(xml.data(), 23));
+  EXPECT_FALSE(reader.feed(xml.data() + 23, xml.size() - 23));
+  EXPECT_FALSE(reader.finish());
+  EXPECT_EQ("{a:x&y,b:", stop.events);
+
+  std::map<std::string, std::string> result = reader.read(xml, "p");
+  EXPECT_EQ("x&y", result["p.a"]);
+  EXPECT_EQ("2", result["p.b.Length"]);
+  EXPECT_EQ("2", result["p.b[1]"]);
+}
+
+TEST_F(XmlReaderTest, testReset) {
+  XmlReader reader;
+  apr_xml_doc* doc = reader.getDocument("<a><b>1</b></a>");
+  ASSERT_TRUE(doc != NULL);
+  EXPECT_STREQ("a", doc->root->name);
+
+  // one reader, many documents.
+  for (int i = 0; i < 3; i++) {
+    doc = reader.getDocument("<c><d>2</d><d>3</d></c>");
+    ASSERT_TRUE(doc != NULL);
+    EXPECT_EQ(2u, XmlReader::getElementsByTagName(doc, "d").size());
+  }
+
+  reader.reset();
+  EXPECT_EQ("1", reader.read("<a><b>1</b></a>", "p")["p.b"]);
+  EXPECT_THROW(reader.getDocument("<a>"), XmlException);
+  EXPECT_TRUE(reader.getDocument("<e/>") != NULL);
+}
+
+TEST_F(XmlReaderTest, testThreadInstance) {
+  using aliyun::http::FormatType;
+  using aliyun::reader::Reader;
+  using aliyun::reader::ReaderFactory;
+
+  Reader* reader = ReaderFactory::getThreadInstance(FormatType::XML);
+  ASSERT_TRUE(reader != NULL);
+  EXPECT_EQ(reader, ReaderFactory::getThreadInstance(FormatType::XML));
+  EXPECT_TRUE(reader != ReaderFactory::getThreadInstance(FormatType::JSON));
+  EXPECT_TRUE(ReaderFactory::getThreadInstance(FormatType::RAW) == NULL);
+  EXPECT_EQ("1", reader->read("<a><b>1</b></a>", "p")["p.b"]);
+
+  // the json reader is reset too, even after an unfinished feed.
+  aliyun::reader::JsonReader* json = static_cast<aliyun::reader::JsonReader*>(
+      ReaderFactory::getThreadInstance(FormatType::JSON));
+  aliyun::reader::ReaderHandler ignore;
+  json->begin(&ignore);
+  json->feed("{\"a\":", 5);
+  EXPECT_EQ(json, ReaderFactory::getThreadInstance(FormatType::JSON));
+  EXPECT_EQ(0u, json->getOffset());
+  EXPECT_EQ("2", json->read("{\"b\":2}", "p")["p.b"]);
+
+  Reader* other = NULL;
+  std::thread thread([&other]() {
+    other = ReaderFactory::getThreadInstance(FormatType::XML);
+    other->read("<a/>", "p");
+  });
+  thread.join();
+  EXPECT_TRUE(other != NULL);
+  EXPECT_TRUE(reader != other);
+}
@@ -17,7 +17,15 @@
  * under the License.
  */
 
+#include <curl/curl.h>
 #include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aliyun/http/loopback_transport.h"
 #include "aliyun/opensearch.h"
 
 using aliyun::opensearch::object::KeyTypeEnum;
@@ -37,3 +45,203 @@ TEST(CloudsearchClient, ctor) {
     EXPECT_EQ("UnknownHostException", std::string(e.what()));
   }
 }
+
+TEST(CloudsearchClient, setMaxConnections) {
+  std::map<std::string, std::string> opts;
+  CloudsearchClient client("key", "secret", "host", opts, KeyTypeEnum::ALIYUN);
+
+  client.setMaxConnections(4);
+  EXPECT_EQ(4, client.getMaxConnections());
+
+  client.setMaxConnections(0);  // ignored
+  EXPECT_EQ(4, client.getMaxConnections());
+}
+
+// keeps the headers of the last request sent.
+class HeaderRecorder : public aliyun::http::Transport {
+ public:
+  aliyun::http::HttpResponse send(const aliyun::http::HttpRequest& request) {
+    headers = request.getHeaders();
+    aliyun::http::HttpResponse response;
+    response.setStatus(200);
+    return response;
+  }
+
+  std::map<std::string, std::string> headers;
+};
+
+TEST(CloudsearchClient, responseGzip) {
+  std::map<std::string, std::string> opts;
+  CloudsearchClient plain("key", "secret", "http://host", opts,
+                          KeyTypeEnum::ALIYUN);
+  EXPECT_FALSE(plain.isResponseGzip());
+
+  // per client, a later client does not change an earlier one.
+  opts["gzip"] = "true";
+  CloudsearchClient gzip("key", "secret", "http://host", opts,
+                         KeyTypeEnum::ALIYUN);
+  opts["gzip"] = "false";
+  CloudsearchClient other("key", "secret", "http://host", opts,
+                          KeyTypeEnum::ALIYUN);
+  EXPECT_FALSE(other.isResponseGzip());
+
+  HeaderRecorder transport;
+  std::map<std::string, std::string> params;
+  std::string debugInfo;
+  plain.setTransport(&transport);
+  plain.call("/search", params, CloudsearchClient::METHOD_GET, false,
+             debugInfo);
+  EXPECT_EQ(0u, transport.headers.count("Accept-Encoding"));
+
+#ifdef USE_ZLIB
+  EXPECT_TRUE(gzip.isResponseGzip());
+  gzip.setTransport(&transport);
+  gzip.call("/search", params, CloudsearchClient::METHOD_GET, false,
+            debugInfo);
+  EXPECT_EQ("gzip, deflate", transport.headers["Accept-Encoding"]);
+#endif  // USE_ZLIB
+}
+
+TEST(CloudsearchClient, setRequestGzip) {
+  std::map<std::string, std::string> opts;
+  CloudsearchClient client("key", "secret", "host", opts, KeyTypeEnum::ALIYUN);
+  EXPECT_FALSE(client.isRequestGzip());
+
+  opts["gzip_request"] = "false";
+  CloudsearchClient client1("key", "secret", "host", opts, KeyTypeEnum::ALIYUN);
+  EXPECT_FALSE(client1.isRequestGzip());
+
+#ifdef USE_ZLIB
+  opts["gzip_request"] = "true";
+  CloudsearchClient client2("key", "secret", "host", opts, KeyTypeEnum::ALIYUN);
+  EXPECT_TRUE(client2.isRequestGzip());
+
+  client2.setRequestGzip(false);
+  EXPECT_FALSE(client2.isRequestGzip());
+#endif  // USE_ZLIB
+}
+
+TEST(CloudsearchClient, timeout) {
+  std::map<std::string, std::string> opts;
+  CloudsearchClient client("key", "secret", "host", opts, KeyTypeEnum::ALIYUN);
+  EXPECT_EQ(CloudsearchClient::DEFAULT_TIMEOUT, client.getTimeout());
+  EXPECT_EQ(CloudsearchClient::DEFAULT_CONNECT_TIMEOUT,
+            client.getConnectTimeout());
+
+  opts["timeout"] = "3000";
+  opts["connect_timeout"] = "1000";
+  CloudsearchClient client1("key", "secret", "host", opts, KeyTypeEnum::ALIYUN);
+  EXPECT_EQ(3000, client1.getTimeout());
+  EXPECT_EQ(1000, client1.getConnectTimeout());
+}
+
+TEST(CloudsearchClient, deadline) {
+  std::map<std::string, std::string> opts;
+  CloudsearchClient client("key", "secret", "http://127.0.0.1:1", opts,
+                           KeyTypeEnum::ALIYUN);
+  std::map<std::string, std::string> params;
+  std::string debugInfo;
+
+  // expired deadline fails fast, request never sent.
+  aliyun::utils::Deadline deadline = aliyun::utils::Deadline::after(0);
+  EXPECT_THROW(client.call("/search", params, CloudsearchClient::METHOD_GET,
+                           false, debugInfo, deadline),
+               aliyun::http::CurlException);
+  EXPECT_EQ("", debugInfo);
+}
+
+TEST(CloudsearchClient, debugInfo) {
+  std::map<std::string, std::string> opts;
+  CloudsearchClient client("id", "secret", "http://host/", opts);
+  aliyun::http::LoopbackTransport transport;
+  transport.addResponse("/search", "{\"status\":\"OK\"}");
+  client.setTransport(&transport);
+
+  std::map<std::string, std::string> params;
+  params["query"] = "a b";
+  std::string debugInfo = "stale";
+  EXPECT_EQ("{\"status\":\"OK\"}",
+            client.call("/search", params, CloudsearchClient::METHOD_GET,
+                        false, debugInfo));
+  EXPECT_EQ(0u, debugInfo.find("http://host/v2/api/search?client_id=id&"));
+  EXPECT_NE(std::string::npos, debugInfo.find("&query=a%20b&sign="));
+}
+
+static std::map<std::string, std::string> parseQuery(const std::string& url) {
+  std::map<std::string, std::string> params;
+  std::string query = url.substr(url.find('?') + 1);
+  size_t pos = 0;
+  while (pos < query.size()) {
+    size_t end = query.find('&', pos);
+    if (end == std::string::npos) {
+      end = query.size();
+    }
+    std::string pair = query.substr(pos, end - pos);
+    size_t eq = pair.find('=');
+    int size = 0;
+    char* value = curl_easy_unescape(NULL, pair.c_str() + eq + 1,
+                                     pair.size() - eq - 1, &size);
+    params[pair.substr(0, eq)] = std::string(value, size);
+    curl_free(value);
+    pos = end + 1;
+  }
+  return params;
+}
+
+// one client shared by many threads, every request signed correctly.
+TEST(CloudsearchClient, threads) {
+  std::map<std::string, std::string> opts;
+  CloudsearchClient client("key", "secret", "http://host", opts,
+                           KeyTypeEnum::ALIYUN);
+  aliyun::http::LoopbackTransport transport;
+  transport.setDefaultResponse("{\"status\":\"OK\"}");
+  client.setTransport(&transport);
+
+  const int kThreads = 16;
+  const int kCalls = 200;
+  std::vector<std::thread> threads;
+  std::vector<int> failures(kThreads, 0);
+  std::vector<std::set<std::string> > nonces(kThreads);
+  for (int t = 0; t < kThreads; t++) {
+    threads.push_back(std::thread([&client, &failures, &nonces, t]() {
+      for (int i = 0; i < kCalls; i++) {
+        std::map<std::string, std::string> params;
+        params["query"] = "thread " + std::to_string(t) + " call "
+            + std::to_string(i);
+        std::string debugInfo;
+        if (client.call("/search", params, CloudsearchClient::METHOD_GET,
+                        false, debugInfo) != "{\"status\":\"OK\"}") {
+          failures[t]++;
+          continue;
+        }
+
+        std::map<std::string, std::string> sent = parseQuery(debugInfo);
+        std::string signature = sent["Signature"];
+        sent.erase("Signature");
+        std::string query;
+        for (std::map<std::string, std::string>::const_iterator it =
+             sent.begin(); it != sent.end(); ++it) {
+          query += '&' + aliyun::auth::UrlEncoder::encode(it->first) + '='
+              + aliyun::auth::UrlEncoder::encode(it->second);
+        }
+        std::string expected = aliyun::auth::HmacSha1::getInstance()
+            ->signString("GET&%2F&" + aliyun::auth::UrlEncoder::percentEncode(
+                query.substr(1)), "secret&");
+        if (sent["query"] != params["query"] || signature != expected) {
+          failures[t]++;
+        }
+        nonces[t].insert(sent["SignatureNonce"]);
+      }
+    }));
+  }
+
+  std::set<std::string> allNonces;
+  for (int t = 0; t < kThreads; t++) {
+    threads[t].join();
+    EXPECT_EQ(0, failures[t]);
+    allNonces.insert(nonces[t].begin(), nonces[t].end());
+  }
+  EXPECT_EQ(static_cast<size_t>(kThreads * kCalls), allNonces.size());
+  EXPECT_EQ(static_cast<size_t>(kThreads * kCalls),
+            transport.getRequestCount());
+}
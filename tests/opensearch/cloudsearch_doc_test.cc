@@ -18,6 +18,10 @@
  */
 
 #include <gtest/gtest.h>
+
+#include <utility>
+
+#include "aliyun/http/loopback_transport.h"
 #include "aliyun/utils/date.h"
 #include "aliyun/reader/json_reader.h"
 #include "aliyun/opensearch.h"
@@ -42,6 +46,44 @@ TEST(CloudsearchDoc, ctor) {
   doc.getDebugInfo();
 }
 
+TEST(CloudsearchDoc, rateLimiter) {
+  std::map<string, string> opts;
+  CloudsearchClient client("key", "secret", "host", opts, KeyTypeEnum::ALIYUN);
+
+  CloudsearchDoc doc("index", client);
+  EXPECT_TRUE(doc.getRateLimiter() == NULL);
+
+  aliyun::utils::RateLimiter limiter(20, 0, 0);  // no burst
+  doc.setRateLimiter(&limiter);
+  EXPECT_EQ(&limiter, doc.getRateLimiter());
+
+  // paced by the shared limiter.
+  std::queue<time_t> timeLimitQueue;
+  doc.timeLimitCheck(&timeLimitQueue);
+  doc.timeLimitCheck(&timeLimitQueue);
+  EXPECT_GT(limiter.getTotalWaitMillis(), 0);
+}
+
+// pushed docs go to the request as given, moved in without a copy.
+TEST(CloudsearchDoc, pushDocs) {
+  std::map<string, string> opts;
+  CloudsearchClient client("key", "secret", "http://host", opts,
+                           KeyTypeEnum::ALIYUN);
+  aliyun::http::LoopbackTransport transport;
+  transport.addResponse("/index/doc/index", "{\"status\":\"OK\"}");
+  client.setTransport(&transport);
+
+  CloudsearchDoc doc("index", client);
+  string docs = "[{\"cmd\":\"add\",\"fields\":{\"id\":\"1\"}}]";
+  EXPECT_EQ("{\"status\":\"OK\"}", doc.push(std::move(docs), "main"));
+  EXPECT_NE(string::npos, doc.getDebugInfo().find(
+      "&items=%5B%7B%22cmd%22%3A%22add%22%2C"));
+  EXPECT_NE(string::npos, doc.getDebugInfo().find("&table_name=main"));
+
+  EXPECT_EQ("{\"status\":\"OK\"}",
+            doc.pushAsync("[]", "main").get());
+  EXPECT_EQ(2u, transport.getRequestCount());
+}
 
 TEST(CloudsearchDoc, add) {
   std::map<string, string> opts;
@@ -18,6 +18,7 @@
  */
 
 #include <gtest/gtest.h>
+#include "aliyun/http/loopback_transport.h"
 #include "aliyun/opensearch.h"
 
 using aliyun::opensearch::object::KeyTypeEnum;
@@ -125,3 +126,53 @@ TEST_F(CloudsearchSearchTest, testGettersAndSetters) {
   search_.addCustomParam("param-key", "param-value");
   EXPECT_EQ("param-value", search_.getCustomParam().find("param-key")->second);
 }
+
+TEST(CloudsearchSearchLoopbackTest, testSearch) {
+  std::map<std::string, std::string> opts;
+  CloudsearchClient client("id", "secret", "http://localhost", opts);
+  aliyun::http::LoopbackTransport transport;
+  transport.addResponse("/search",
+      "{\"status\":\"OK\",\"request_id\":\"7\",\"result\":{\"searchtime\":0.1,"
+      "\"total\":1,\"num\":1,\"viewtotal\":1,\"items\":[{\"id\":\"42\"}],"
+      "\"facet\":[]},\"errors\":[]}");
+  client.setTransport(&transport);
+
+  CloudsearchSearch search(client);
+  search.addIndex("app");
+  search.setQueryString("default:'x'");
+  std::string result = search.search();
+  EXPECT_NE(std::string::npos, result.find("\"42\""));
+  EXPECT_NE(std::string::npos, search.getDebugInfo().find("/v2/api/search?"));
+
+  aliyun::opensearch::object::SearchResult parsed;
+  search.search(&parsed);
+  EXPECT_EQ("7", parsed.getRequestId());
+  ASSERT_EQ(1u, parsed.size());
+  EXPECT_EQ("42", parsed.getHit(0).getField("id"));
+
+  EXPECT_EQ(result, search.searchAsync().get());
+  EXPECT_EQ(3u, transport.getRequestCount());
+
+  // deadlines reach every overload, expired ones send nothing.
+  aliyun::utils::Deadline expired = aliyun::utils::Deadline::after(0);
+  EXPECT_THROW(search.search(expired, &parsed), aliyun::http::CurlException);
+  EXPECT_THROW(search.searchAsync(expired).get(),
+               aliyun::http::CurlException);
+  EXPECT_EQ(3u, transport.getRequestCount());
+  search.search(aliyun::utils::Deadline::after(60000), &parsed);
+  EXPECT_EQ("42", parsed.getHit(0).getField("id"));
+  EXPECT_EQ(result,
+            search.searchAsync(aliyun::utils::Deadline::after(60000)).get());
+  EXPECT_EQ(5u, transport.getRequestCount());
+
+  // the typed result is always requested as json.
+  search.setFormat("protobuf");
+  search.search(&parsed);
+  EXPECT_EQ("42", parsed.getHit(0).getField("id"));
+  EXPECT_EQ("protobuf", search.getFormat());
+  EXPECT_NE(std::string::npos, search.getDebugInfo().find("format=json"));
+  EXPECT_EQ(6u, transport.getRequestCount());
+
+  client.setTransport(NULL);
+  EXPECT_NE(&transport, client.getTransport());
+}
@@ -0,0 +1,228 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include <fstream>
+
+#include "aliyun/http/loopback_transport.h"
+#include "aliyun/opensearch.h"
+#include "aliyun/utils/mapped_file.h"
+#include "aliyun/utils/parameter_helper.h"
+#include "aliyun/utils/string_utils.h"
+
+using std::string;
+using aliyun::opensearch::CloudsearchClient;
+using aliyun::opensearch::HaDocImporter;
+using aliyun::opensearch::object::KeyTypeEnum;
+
+static string writeHaDocFile(int docs,
+                             const string& path = "ha_doc_importer_test.txt") {
+  std::ofstream output(path.c_str(), std::ios::out | std::ios::binary);
+  for (int i = 0; i < docs; i++) {
+    output << "CMD=add\x1F\n";
+    output << "id=" << i << "\x1F\n";
+    output << "title=hello world\x1F\n";
+    output << "body=line one\nline two\x1F\n";
+    output << "tags=a\x1D" "b\x1D" "c\x1F\n";
+    output << "\x1E\n";
+  }
+  return path;
+}
+
+// as the importer writes it, the files here are shorter than the hashed
+// window so the whole part before `offset` is hashed.
+static string checkpointFor(const string& path, size_t offset, int64_t line) {
+  aliyun::utils::MappedFile file(path);
+  return "offset=" + aliyun::utils::StringUtils::ToString(offset)
+      + "\nline=" + aliyun::utils::StringUtils::ToString(line)
+      + "\nfile=" + path
+      + "\nmd5=" + aliyun::utils::ParameterHelper::md5hex(
+          string(file.data(), offset))
+      + "\nmtime=" + aliyun::utils::StringUtils::ToString(file.mtime())
+      + "\nsize=" + aliyun::utils::StringUtils::ToString(file.size())
+      + "\n";
+}
+
+static void writeCheckpoint(const string& path, const string& content) {
+  std::ofstream output(path.c_str(), std::ios::out | std::ios::binary);
+  output << content;
+}
+
+TEST(HaDocImporterTest, testOptions) {
+  HaDocImporter::Options options;
+  EXPECT_EQ(1, options.pushThreads);
+  EXPECT_GE(options.encodeThreads, 1);
+  EXPECT_EQ(2 * 1024 * 1024, options.maxBatchSize);
+}
+
+TEST(HaDocImporterTest, testFileNotFound) {
+  std::map<string, string> opts;
+  CloudsearchClient client("key", "secret", "http://127.0.0.1:1", opts,
+                           KeyTypeEnum::ALIYUN);
+  HaDocImporter importer("index", client);
+  EXPECT_THROW(importer.import("not_exists.txt", "main", 0),
+               aliyun::Exception);
+}
+
+TEST(HaDocImporterTest, testPushFail) {
+  string path = writeHaDocFile(100);
+
+  std::map<string, string> opts;
+  CloudsearchClient client("key", "secret", "http://127.0.0.1:1", opts,
+                           KeyTypeEnum::ALIYUN);
+  HaDocImporter::Options options;
+  options.pushThreads = 4;
+  options.maxBatchSize = 1024;
+  options.pushFrequence = 0;
+  HaDocImporter importer("index", client, options);
+
+  // connection refused, nothing acked.
+  EXPECT_THROW(importer.import(path, "main", 0), aliyun::Exception);
+  EXPECT_EQ(0, importer.getCheckpoint());
+  EXPECT_EQ(0, importer.getPushedDocs());
+
+  ::remove(path.c_str());
+}
+
+TEST(HaDocImporterTest, testImportAgain) {
+  string path = writeHaDocFile(10);
+
+  std::map<string, string> opts;
+  CloudsearchClient client("key", "secret", "http://localhost", opts,
+                           KeyTypeEnum::ALIYUN);
+  aliyun::http::LoopbackTransport transport;
+  client.setTransport(&transport);
+  HaDocImporter::Options options;
+  options.pushFrequence = 0;
+  HaDocImporter importer("index", client, options);
+
+  const string fail = "{\"status\":\"FAIL\",\"errors\":[]}";
+  const string ok = "{\"status\":\"OK\",\"request_id\":\"1\"}";
+  transport.setDefaultResponse(fail);
+  EXPECT_EQ("last push not OK, line 0", importer.import(path, "main", 0));
+  EXPECT_EQ(fail, importer.getLastResult());
+  EXPECT_EQ(0, importer.getPushedDocs());
+
+  // a failed import does not stick to the next one.
+  transport.setDefaultResponse(ok);
+  EXPECT_EQ(ok, importer.import(path, "main", 0));
+  EXPECT_EQ(70, importer.getCheckpoint());
+  EXPECT_EQ(10, importer.getPushedDocs());
+
+  // counted per import.
+  EXPECT_EQ(ok, importer.import(path, "main", 36));
+  EXPECT_EQ(70, importer.getCheckpoint());
+  EXPECT_EQ(5, importer.getPushedDocs());
+  EXPECT_EQ(3u, transport.getRequestCount());
+
+  ::remove(path.c_str());
+}
+
+TEST(HaDocImporterTest, testResumeFromCheckpointFile) {
+  string path = writeHaDocFile(10);  // 7 lines, 72 bytes per doc
+  string checkpointFile = "ha_doc_importer_test.ckpt";
+
+  std::map<string, string> opts;
+  CloudsearchClient client("key", "secret", "http://127.0.0.1:1", opts,
+                           KeyTypeEnum::ALIYUN);
+  HaDocImporter::Options options;
+  options.pushFrequence = 0;
+  options.checkpointFile = checkpointFile;
+
+  // all pushed, nothing left to connect for.
+  writeCheckpoint(checkpointFile, checkpointFor(path, 720, 70));
+  HaDocImporter done("index", client, options);
+  EXPECT_EQ("", done.import(path, "main", 0));
+  EXPECT_EQ(70, done.getCheckpoint());
+  EXPECT_EQ(720, done.getCheckpointOffset());
+  EXPECT_EQ(0, done.getPushedDocs());
+
+  // resume at the last doc, push fails and checkpoint file is kept.
+  writeCheckpoint(checkpointFile, checkpointFor(path, 648, 63));
+  HaDocImporter resumed("index", client, options);
+  EXPECT_THROW(resumed.import(path, "main", 0), aliyun::Exception);
+  EXPECT_EQ(63, resumed.getCheckpoint());
+  EXPECT_EQ(648, resumed.getCheckpointOffset());
+  {
+    std::ifstream input(checkpointFile.c_str());
+    string content((std::istreambuf_iterator<char>(input)),
+                   std::istreambuf_iterator<char>());
+    EXPECT_EQ(checkpointFor(path, 648, 63), content);
+  }
+
+  // not at a line start, ignored.
+  writeCheckpoint(checkpointFile, checkpointFor(path, 100, 8));
+  HaDocImporter ignored("index", client, options);
+  EXPECT_THROW(ignored.import(path, "main", 0), aliyun::Exception);
+  EXPECT_EQ(0, ignored.getCheckpoint());
+  EXPECT_EQ(0, ignored.getCheckpointOffset());
+
+  ::remove(checkpointFile.c_str());
+  ::remove(path.c_str());
+}
+
+TEST(HaDocImporterTest, testStaleCheckpoint) {
+  string path = writeHaDocFile(10);
+  string otherPath = writeHaDocFile(12, "ha_doc_importer_test2.txt");
+  string checkpointFile = "ha_doc_importer_test.ckpt";
+  string finished = checkpointFor(path, 720, 70);
+
+  std::map<string, string> opts;
+  CloudsearchClient client("key", "secret", "http://localhost", opts,
+                           KeyTypeEnum::ALIYUN);
+  aliyun::http::LoopbackTransport transport;
+  transport.setDefaultResponse("{\"status\":\"OK\"}");
+  client.setTransport(&transport);
+  HaDocImporter::Options options;
+  options.pushFrequence = 0;
+  options.checkpointFile = checkpointFile;
+  HaDocImporter importer("index", client, options);
+
+  // written for another file, everything is pushed.
+  writeCheckpoint(checkpointFile, finished);
+  importer.import(otherPath, "main", 0);
+  EXPECT_EQ(12, importer.getPushedDocs());
+  EXPECT_EQ(84, importer.getCheckpoint());
+
+  // the file grew since, offset 720 is still a line start.
+  writeHaDocFile(12);
+  writeCheckpoint(checkpointFile, finished);
+  importer.import(path, "main", 0);
+  EXPECT_EQ(12, importer.getPushedDocs());
+
+  // same size and mtime, other content before the offset.
+  string rewritten = checkpointFor(path, 720, 70);
+  string::size_type md5 = rewritten.find("md5=") + 4;
+  rewritten.replace(md5, 32, string(32, '0'));
+  writeCheckpoint(checkpointFile, rewritten);
+  importer.import(path, "main", 0);
+  EXPECT_EQ(12, importer.getPushedDocs());
+
+  // matching one is resumed.
+  writeCheckpoint(checkpointFile, checkpointFor(path, 720, 70));
+  importer.import(path, "main", 0);
+  EXPECT_EQ(2, importer.getPushedDocs());
+  EXPECT_EQ(84, importer.getCheckpoint());
+
+  ::remove(checkpointFile.c_str());
+  ::remove(otherPath.c_str());
+  ::remove(path.c_str());
+}
@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include <fstream>
+
+#include "aliyun/opensearch.h"
+#include "aliyun/opensearch/object/single_doc.h"
+#include "aliyun/utils/mapped_file.h"
+
+using std::string;
+using aliyun::opensearch::HaDocReader;
+using aliyun::opensearch::object::SingleDoc;
+using aliyun::utils::MappedFile;
+
+TEST(HaDocReaderTest, testNext) {
+  string data = "CMD=add\x1F\n"
+      "id=1\x1F\n"
+      "title=hello\x1F\n"
+      "\x1E\n"
+      "CMD=delete\x1F\n"
+      "id=2\x1F\n"
+      "\x1E\n";
+  HaDocReader reader(data.data(), data.size());
+  HaDocReader::Doc doc;
+
+  ASSERT_TRUE(reader.next(&doc));
+  EXPECT_EQ("add", doc.command.toString());
+  ASSERT_EQ(2, doc.fields.size());
+  EXPECT_EQ("id", doc.fields[0].key.toString());
+  EXPECT_EQ("1", doc.fields[0].value.toString());
+  EXPECT_EQ("title", doc.fields[1].key.toString());
+  EXPECT_EQ("hello", doc.fields[1].value.toString());
+  EXPECT_EQ(4, doc.line);
+  // slices point into the data.
+  EXPECT_EQ(data.data() + 4, doc.command.data());
+
+  ASSERT_TRUE(reader.next(&doc));
+  EXPECT_EQ("delete", doc.command.toString());
+  EXPECT_EQ(1, doc.fields.size());
+  EXPECT_EQ(7, doc.line);
+
+  EXPECT_FALSE(reader.next(&doc));
+  EXPECT_EQ(7, reader.getLineNumber());
+  EXPECT_EQ(data.size(), reader.getOffset());
+}
+
+TEST(HaDocReaderTest, testJsonSameAsSingleDoc) {
+  string longValue(100, 'x');  // crosses several 16 bytes blocks
+  string data = "CMD=add\x1F\n"
+      "title=b\x1F\n"
+      "id=1\x1F\n"
+      "title=a\x1F\n"
+      "body=line one\nline two\x1F\n"
+      "tags=a\x1D" "b\x1D" "c\x1F\n"
+      "long=" + longValue + "\x1F\n"
+      "\x1E\n";
+  HaDocReader reader(data.data(), data.size());
+  HaDocReader::Doc doc;
+  ASSERT_TRUE(reader.next(&doc));
+
+  SingleDoc singleDoc;
+  singleDoc.setCommand("add");
+  singleDoc.addField("title", "b");
+  singleDoc.addField("id", "1");
+  singleDoc.addField("title", "a");
+  singleDoc.addField("body", "line one\nline two");
+  singleDoc.addField("tags", "a\x1D" "b\x1D" "c");
+  singleDoc.addField("long", longValue);
+  EXPECT_EQ(singleDoc.getJsonString(), doc.getJsonString());
+  EXPECT_EQ(9, doc.line);  // body takes two lines
+
+  HaDocReader::Doc empty;
+  EXPECT_EQ(SingleDoc().getJsonString(), empty.getJsonString());
+}
+
+TEST(HaDocReaderTest, testSkipAndIgnore) {
+  string data = "\x1E\n"  // doc without field
+      "\n"
+      "CMD=add\x1F\r\n"
+      "noequal\x1F\n"
+      "id=a\x1F" "b\x1E" "c\x1F\n"  // separators inside value
+      "\x1E\r\n"
+      "CMD=add\x1F\n"
+      "id=3\x1F\n";  // incomplete
+  HaDocReader reader(data.data(), data.size());
+  HaDocReader::Doc doc;
+
+  ASSERT_TRUE(reader.next(&doc));
+  EXPECT_EQ("add", doc.command.toString());
+  ASSERT_EQ(1, doc.fields.size());
+  EXPECT_EQ("a\x1F" "b\x1E" "c", doc.fields[0].value.toString());
+  EXPECT_EQ(6, doc.line);
+
+  EXPECT_FALSE(reader.next(&doc));
+}
+
+TEST(HaDocReaderTest, testSeekLine) {
+  string data = "CMD=add\x1F\n"
+      "id=1\x1F\n"
+      "\x1E\n"
+      "CMD=add\x1F\n"
+      "id=2\x1F\n"
+      "\x1E\n";
+  HaDocReader reader(data.data(), data.size());
+  HaDocReader::Doc doc;
+
+  reader.seekLine(4);
+  EXPECT_EQ(3, reader.getLineNumber());
+  ASSERT_TRUE(reader.next(&doc));
+  EXPECT_EQ("2", doc.fields[0].value.toString());
+  EXPECT_EQ(6, doc.line);
+  EXPECT_EQ(data.size(), doc.offset);
+  EXPECT_FALSE(reader.next(&doc));
+
+  // by byte offset, no scan.
+  reader.seek(17, 3);
+  ASSERT_TRUE(reader.next(&doc));
+  EXPECT_EQ("2", doc.fields[0].value.toString());
+  EXPECT_EQ(6, doc.line);
+
+  reader.seekLine(100);
+  EXPECT_FALSE(reader.next(&doc));
+
+  reader.seekLine(0);
+  ASSERT_TRUE(reader.next(&doc));
+  EXPECT_EQ("1", doc.fields[0].value.toString());
+}
+
+TEST(HaDocReaderTest, testMappedFile) {
+  string path = "ha_doc_reader_test.txt";
+  {
+    std::ofstream output(path.c_str(), std::ios::out | std::ios::binary);
+    output << "CMD=add\x1F\nid=1\x1F\n\x1E\n";
+  }
+  {
+    MappedFile file(path);
+    EXPECT_EQ(17, file.size());
+    HaDocReader reader(file.data(), file.size());
+    HaDocReader::Doc doc;
+    ASSERT_TRUE(reader.next(&doc));
+    EXPECT_EQ("{\"cmd\":\"add\",\"fields\":{\"id\":\"1\"}}", doc.getJsonString());
+  }
+
+  {
+    std::ofstream output(path.c_str(), std::ios::out | std::ios::binary);
+  }
+  {
+    MappedFile file(path);
+    EXPECT_EQ(0, file.size());
+    HaDocReader reader(file.data(), file.size());
+    HaDocReader::Doc doc;
+    EXPECT_FALSE(reader.next(&doc));
+  }
+  ::remove(path.c_str());
+
+  EXPECT_THROW(MappedFile("not_exists.txt"), aliyun::Exception);
+}
@@ -18,6 +18,7 @@
  */
 
 #include <gtest/gtest.h>
+#include "aliyun/auth/url_encoder.h"
 #include "aliyun/opensearch/object/doc_items.h"
 
 using aliyun::opensearch::object::DocItems;
@@ -39,3 +40,56 @@ TEST(DocItemsTest, add_json) {
       "{{\"cmd\":\"doc1\",\"fields\":{\"foo\":\"bar\"}},{\"cmd\":\"doc2\",\"fields\":{\"foo\":\"bar\",\"have\":\"fun\"}}}",
       docItems.getJsonString());
 }
+
+TEST(DocItemsTest, sizes) {
+  DocItems docItems;
+  EXPECT_TRUE(docItems.empty());
+  EXPECT_EQ(0, docItems.jsonSize());
+  EXPECT_EQ(0, docItems.encodedSize());
+
+  std::map<std::string, std::string> fields;
+  fields["title"] = "hello world";
+  fields["body"] = "中文 & symbols: ~-._!*'()";
+  for (int i = 0; i < 10; i++) {
+    SingleDoc doc("add", fields);
+    size_t expected = docItems.encodedSizeWith(
+        aliyun::auth::UrlEncoder::encode(doc.getJsonString()).length());
+    docItems.addDoc(doc);
+    EXPECT_EQ(expected, docItems.encodedSize());
+
+    std::string json = docItems.getJsonString();
+    EXPECT_EQ(json.length(), docItems.jsonSize());
+    EXPECT_EQ(aliyun::auth::UrlEncoder::encode(json).length(),
+              docItems.encodedSize());
+    EXPECT_EQ(aliyun::auth::UrlEncoder::encode(
+                  docItems.getJsonArrayString()).length(),
+              docItems.encodedSize());
+  }
+  EXPECT_EQ(10, docItems.size());
+  EXPECT_EQ('[', docItems.getJsonArrayString()[0]);
+
+  docItems.clear();
+  EXPECT_TRUE(docItems.empty());
+  EXPECT_EQ("", docItems.getJsonString());
+  EXPECT_EQ(0, docItems.encodedSize());
+}
+
+TEST(DocItemsTest, move_json) {
+  std::string json = "{\"cmd\":\"add\",\"fields\":{\"a\":\"b c\"}}";
+  size_t encoded = aliyun::auth::UrlEncoder::encode(json).length();
+
+  DocItems copied;
+  copied.addJson(json);
+  DocItems moved;
+  std::string source = json;
+  moved.addJson(std::move(source));
+  EXPECT_EQ(copied.getJsonString(), moved.getJsonString());
+  EXPECT_EQ(copied.jsonSize(), moved.jsonSize());
+  EXPECT_EQ(copied.encodedSize(), moved.encodedSize());
+
+  source = json;
+  moved.addJson(std::move(source), encoded);
+  copied.addJson(json, encoded);
+  EXPECT_EQ(copied.getJsonString(), moved.getJsonString());
+  EXPECT_EQ(copied.encodedSize(), moved.encodedSize());
+}
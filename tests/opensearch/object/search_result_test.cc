@@ -0,0 +1,173 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
+#include "aliyun/opensearch/object/search_result.h"
+#include "aliyun/reader/json_reader.h"
+
+using aliyun::opensearch::object::SearchHit;
+using aliyun::opensearch::object::SearchResult;
+using aliyun::reader::JsonException;
+using aliyun::utils::StringPiece;
+
+static const char* RESPONSE =
+    "{\"status\":\"OK\",\"request_id\":\"1234\","
+    "\"result\":{\"searchtime\":0.25,\"total\":12,\"num\":2,\"viewtotal\":10,"
+    "\"items\":["
+    "{\"id\":\"1\",\"title\":\"a \\\"b\\\"\",\"price\":3.5,"
+    "\"tags\":[\"x\",{\"y\":1}],\"t\\u0069p\":true},"
+    "{\"id\":\"2\",\"title\":\"\\u4e2d\",\"price\":null}],"
+    "\"facet\":[{\"key\":\"cat\",\"items\":[{\"value\":\"book\",\"count\":3},"
+    "{\"value\":\"pen\",\"count\":1}]}]},"
+    "\"errors\":[],\"tracer\":\"\"}";
+
+TEST(SearchResultTest, summary) {
+  SearchResult result(RESPONSE);
+  EXPECT_TRUE(result.isOk());
+  EXPECT_EQ("OK", result.getStatus());
+  EXPECT_EQ("1234", result.getRequestId());
+  EXPECT_DOUBLE_EQ(0.25, result.getSearchTime());
+  EXPECT_EQ(12, result.getTotal());
+  EXPECT_EQ(2, result.getNum());
+  EXPECT_EQ(10, result.getViewTotal());
+  EXPECT_TRUE(result.getErrors().empty());
+
+  ASSERT_EQ(1u, result.getFacets().size());
+  const SearchResult::Facet& facet = result.getFacets()[0];
+  EXPECT_EQ("cat", facet.key);
+  ASSERT_EQ(2u, facet.items.size());
+  EXPECT_EQ("book", facet.items[0].value);
+  EXPECT_EQ(3, facet.items[0].count);
+  EXPECT_EQ("pen", facet.items[1].value);
+  EXPECT_EQ(1, facet.items[1].count);
+}
+
+TEST(SearchResultTest, hits) {
+  SearchResult result(RESPONSE);
+  ASSERT_EQ(2u, result.size());
+
+  SearchHit hit = result.getHit(0);
+  ASSERT_EQ(5u, hit.getFieldCount());
+  EXPECT_EQ("id", hit.getFieldName(0));
+  EXPECT_EQ("\"1\"", hit.getRawValue(0));
+  EXPECT_EQ("a \"b\"", hit.getField("title"));
+  EXPECT_EQ("3.5", hit.getField("price"));
+  EXPECT_EQ("[\"x\",{\"y\":1}]", hit.getField("tags"));
+  EXPECT_EQ("tip", hit.getFieldName(4));
+  EXPECT_EQ("true", hit.getField("tip"));
+  EXPECT_FALSE(hit.hasField("missing"));
+  EXPECT_EQ("", hit.getField("missing"));
+
+  hit = result.getHit(1);
+  ASSERT_EQ(3u, hit.getFieldCount());
+  EXPECT_EQ("\xE4\xB8\xAD", hit.getField("title"));
+  EXPECT_EQ("null", hit.getRawValue(2));
+  EXPECT_TRUE(hit.hasField("price"));
+  EXPECT_EQ("", hit.getField("price"));
+  std::string scratch;
+  EXPECT_TRUE(hit.getFieldView("price", &scratch).empty());
+}
+
+TEST(SearchResultTest, views) {
+  SearchResult result(RESPONSE);
+  const std::string& response = result.getResponse();
+  std::string scratch;
+
+  // plain strings point into the response, escaped ones into scratch.
+  StringPiece id = result.getHit(0).getFieldView("id", &scratch);
+  EXPECT_EQ("1", id);
+  EXPECT_TRUE(id.data() > response.data()
+              && id.data() < response.data() + response.size());
+  EXPECT_TRUE(scratch.empty());
+
+  StringPiece title = result.getHit(0).getFieldView("title", &scratch);
+  EXPECT_EQ("a \"b\"", title);
+  EXPECT_EQ(scratch.data(), title.data());
+}
+
+TEST(SearchResultTest, iterator) {
+  SearchResult result(RESPONSE);
+  std::string ids;
+  std::string scratch;
+  for (SearchResult::const_iterator it = result.begin();
+      it != result.end(); ++it) {
+    it->getFieldView("id", &scratch).appendTo(&ids);
+  }
+  EXPECT_EQ("12", ids);
+
+  // offsets stay valid in copies.
+  SearchResult copy = result;
+  result.clear();
+  EXPECT_TRUE(result.empty());
+  EXPECT_TRUE(result.begin() == result.end());
+  EXPECT_EQ("a \"b\"", copy.begin()->getField("title"));
+}
+
+TEST(SearchResultTest, errors) {
+  SearchResult result;
+  result.parse("{\"status\":\"FAIL\",\"request_id\":\"5\",\"result\":[],"
+               "\"errors\":[{\"code\":2112,\"message\":\"bad index\"}]}");
+  EXPECT_FALSE(result.isOk());
+  EXPECT_EQ("FAIL", result.getStatus());
+  EXPECT_EQ(0u, result.size());
+  ASSERT_EQ(1u, result.getErrors().size());
+  EXPECT_EQ("2112", result.getErrors()[0].code);
+  EXPECT_EQ("bad index", result.getErrors()[0].message);
+
+  EXPECT_THROW(result.parse("{\"status\":\"OK\",\"result\":{"), JsonException);
+}
+
+TEST(SearchResultTest, stream) {
+  std::string response = RESPONSE;
+  SearchResult whole(response);
+
+  SearchResult result;
+  SearchResult::StreamParser parser(&result);
+  for (size_t step = 1; step <= response.size(); step += 7) {
+    parser.begin();
+    for (size_t pos = 0; pos < response.size(); pos += step) {
+      parser.feed(response.data() + pos,
+                  std::min(step, response.size() - pos));
+    }
+    parser.finish();
+
+    EXPECT_EQ(response, result.getResponse());
+    EXPECT_EQ("1234", result.getRequestId());
+    EXPECT_EQ(12, result.getTotal());
+    ASSERT_EQ(2u, result.size()) << "step " << step;
+    EXPECT_EQ(1u, result.getFacets().size());
+    for (size_t i = 0; i < whole.size(); i++) {
+      SearchHit expected = whole.getHit(i);
+      SearchHit hit = result.getHit(i);
+      ASSERT_EQ(expected.getFieldCount(), hit.getFieldCount());
+      for (size_t j = 0; j < hit.getFieldCount(); j++) {
+        EXPECT_EQ(expected.getFieldName(j), hit.getFieldName(j));
+        EXPECT_EQ(expected.getRawValue(j), hit.getRawValue(j));
+      }
+    }
+  }
+
+  parser.begin();
+  parser.feed(response.data(), 40);
+  EXPECT_THROW(parser.finish(), JsonException);
+}